@@ -0,0 +1,87 @@
+
+#include "global_define.h"
+#include "eq_broadcast_packet.h"
+#include "eq_stream_intf.h"
+#include "struct_strategy.h"
+
+uint64 EQBroadcastPacket::s_encodes = 0;
+uint64 EQBroadcastPacket::s_encodes_saved = 0;
+
+//stands in for the client stream while an encoder runs, keeping whatever it queues.
+class EQEncodeCaptureStream : public EQStreamInterface {
+public:
+	EQEncodeCaptureStream() : m_set(std::make_shared<EQEncodedPacketSet>()) {}
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true) {
+		if(p != nullptr)
+			m_set->Add(p->Copy(), ack_req);
+	}
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true) {
+		if(p == nullptr || *p == nullptr)
+			return;
+		m_set->Add(*p, ack_req);
+		*p = nullptr;
+	}
+	virtual EQApplicationPacket *PopPacket() { return(nullptr); }
+	virtual void Close() {}
+	virtual void ReleaseFromUse() {}
+	virtual void RemoveData() {}
+	virtual uint32 GetRemoteIP() const { return 0; }
+	virtual uint16 GetRemotePort() const { return 0; }
+	virtual bool CheckState(EQStreamState state) { return state == ESTABLISHED; }
+	virtual std::string Describe() const { return("Encode Capture"); }
+	virtual EQStreamState GetState() { return ESTABLISHED; }
+	virtual void SetOpcodeManager(OpcodeManager **opm) {}
+	virtual OpcodeManager *GetOpcodeManager() const { return(nullptr); }
+	virtual bool IsInUse() { return true; }
+
+	std::shared_ptr<EQEncodedPacketSet> GetSet() const { return m_set; }
+
+private:
+	std::shared_ptr<EQEncodedPacketSet> m_set;
+};
+
+EQBroadcastPacket::EQBroadcastPacket(const EQApplicationPacket *app)
+:	m_app(app)
+{
+}
+
+const EQSharedPacket &EQBroadcastPacket::GetSharedPacket() {
+	if(!m_shared && m_app != nullptr)
+		m_shared = EQSharedPacket(m_app->Copy());
+	return m_shared;
+}
+
+void EQBroadcastPacket::QueueTo(EQStreamInterface *dest, bool ack_req) {
+	if(dest == nullptr || m_app == nullptr)
+		return;
+
+	const StructStrategy *structs = dest->GetStructStrategy();
+	if(structs == nullptr) {
+		//nothing to encode for this stream, it sends the emu packet as is.
+		dest->QueueSharedPacket(GetSharedPacket(), ack_req);
+		return;
+	}
+
+	std::shared_ptr<const EQEncodedPacketSet> packets;
+	for(auto &e : m_encoded) {
+		if(e.structs == structs && e.ack_req == ack_req) {
+			packets = e.packets;
+			break;
+		}
+	}
+
+	if(packets) {
+		s_encodes_saved++;
+	} else {
+		auto capture = std::make_shared<EQEncodeCaptureStream>();
+		EQApplicationPacket *newp = m_app->Copy();
+		structs->Encode(&newp, capture, ack_req);
+		packets = capture->GetSet();
+		m_encoded.push_back({ structs, ack_req, packets });
+		s_encodes++;
+	}
+
+	for(auto &e : packets->GetPackets())
+		dest->QueueSharedPacket(e.app, e.ack_req);
+}
@@ -0,0 +1,69 @@
+#ifndef EQBROADCASTPACKET_H_
+#define EQBROADCASTPACKET_H_
+
+#include "types.h"
+#include "eq_packet.h"
+#include <memory>
+#include <vector>
+
+class EQStreamInterface;
+class StructStrategy;
+
+//the packets one StructStrategy produced from a single emu packet.
+//immutable once built, so any number of streams on that patch can share it.
+class EQEncodedPacketSet {
+public:
+	struct Entry {
+		EQSharedPacket app;
+		bool ack_req;
+	};
+
+	EQEncodedPacketSet() {}
+
+	//takes ownership of app.
+	void Add(EQApplicationPacket *app, bool ack_req) { m_packets.push_back({ EQSharedPacket(app), ack_req }); }
+	const std::vector<Entry> &GetPackets() const { return m_packets; }
+
+private:
+	EQEncodedPacketSet(const EQEncodedPacketSet &) = delete;
+	EQEncodedPacketSet &operator=(const EQEncodedPacketSet &) = delete;
+
+	std::vector<Entry> m_packets;
+};
+
+//wraps an emu packet that is about to be sent to many clients.
+//the struct strategy encode runs once per client patch the first time a
+//stream on that patch is queued, every later stream reuses the result.
+class EQBroadcastPacket {
+public:
+	//does NOT take ownership of app, which must outlive this object.
+	explicit EQBroadcastPacket(const EQApplicationPacket *app);
+
+	const EQApplicationPacket *GetPacket() const { return m_app; }
+	//a shared copy of the emu packet, made the first time it is asked for.
+	const EQSharedPacket &GetSharedPacket();
+
+	void QueueTo(EQStreamInterface *dest, bool ack_req = true);
+
+	//process wide totals, for #netstats.
+	static uint64 GetEncodeCount() { return s_encodes; }
+	static uint64 GetEncodesSaved() { return s_encodes_saved; }
+	static void ResetStats() { s_encodes = 0; s_encodes_saved = 0; }
+
+private:
+	struct Encoded {
+		const StructStrategy *structs;
+		bool ack_req;
+		std::shared_ptr<const EQEncodedPacketSet> packets;
+	};
+
+	const EQApplicationPacket *const m_app;	//we do not own this object.
+	EQSharedPacket m_shared;
+	//one entry per patch seen so far, there are only ever a handful of them.
+	std::vector<Encoded> m_encoded;
+
+	static uint64 s_encodes;
+	static uint64 s_encodes_saved;
+};
+
+#endif /*EQBROADCASTPACKET_H_*/
@@ -537,10 +537,10 @@ EQOldPacket::EQOldPacket()
 }
 
 // Destructor
-// deletes pExtra
+// deletes pExtra unless it is borrowed from payload_ref
 EQOldPacket::~EQOldPacket()
 {
-	if (pExtra)
+	if (pExtra && !payload_ref)
 		delete[] pExtra;//delete pExtra;
 	if (ack_fields)
 		delete[] ack_fields;
@@ -21,6 +21,7 @@
 #include "base_packet.h"
 #include "platform.h"
 #include <iostream>
+#include <memory>
 
 #ifdef STATIC_OPCODE
 	typedef unsigned short EmuOpcode;
@@ -30,6 +31,11 @@
 #endif
 
 class EQOldStream;
+class EQApplicationPacket;
+
+//an application packet nobody modifies any more, shared by every queue it was sent to.
+//holders read pBuffer in place instead of taking their own copy.
+typedef std::shared_ptr<const EQApplicationPacket> EQSharedPacket;
 
 /************ PACKETS ************/
 struct EQPACKET_HDR_INFO
@@ -176,6 +182,7 @@ public:
 	FRAGMENT_INFO		fraginfo;			//Fragment info
 	uint16				dwExtraSize;		//Size of additional info.
 	uchar				*pExtra;			//Additional information
+	EQSharedPacket		payload_ref;		//set when pExtra points into a shared packet rather than owning its buffer
 	uint16				resend_count;		// Quagmire: Moving resend count to a packet by packet basis
 	uint16				dwLoopedOnce;		//Checks counter of times packet has looped. Basically a bool but kept multiples for debugging purposes
 	uint32				LastSent; //Last time this packet was sent.
@@ -2158,29 +2158,24 @@ void EQOldStream::MakeClosePacket()
 /************************************************************************/
 /************ Make an EQ packet and put it to the send queue ************/
 /* 
-	APP->size == 0 && app->pBuffer == nullptr if no data.
+	payload == nullptr if no data. Fragments point into payload's buffer and hold
+	a reference to it until they are acked, so the data is never copied here.
 
 	Agz: set ack_req = false if you dont want this packet to require an ack
 	response from the client, this menas this packet may get lost and not
 	resent. This is used by the EQ servers for HP and position updates among 
 	other things. WARNING: I havent tested this yet.
 */
-void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboundAlreadyLocked)
+void EQOldStream::MakeEQPacket(uint16 opcode, const EQSharedPacket &payload, bool ack_req, bool outboundAlreadyLocked)
 {
-	int16 restore_op = 0x0000;
-
 	/************ PM STATE = NOT ACTIVE ************/
-	if(CheckState(CLOSED) || CheckState(CLOSING) || CheckState(DISCONNECTING) || !app || app && app->GetRawOpcode() == 0)
+	if(CheckState(CLOSED) || CheckState(CLOSING) || CheckState(DISCONNECTING) || opcode == 0)
 	{
 		return;
 	}
 
-	// Agz:Moved this to after finish check
-	if(app == nullptr)
-	{
-		//cout << "EQPacketManager::MakeEQPacket app == nullptr" << endl;
-		return;
-	}
+	const uchar *buffer = payload ? payload->pBuffer : nullptr;
+	uint32 size = buffer ? payload->size : 0;
 	bool bFragment= false; //This is set later on if fragseq should be increased at the end.
 	std::unique_lock<std::mutex> lock;
 	if (!outboundAlreadyLocked) {
@@ -2188,7 +2183,7 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 	}
 
 	/************ IF opcode is == 0xFFFF it is a request for pure ack creation ************/
-	if(app->GetRawOpcode() == 0xFFFF)
+	if(opcode == 0xFFFF)
 	{
 		EQOldPacket *pack = new EQOldPacket();
 		if (ack_req) {
@@ -2202,8 +2197,8 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 		SendQueue.push_back(pack);
 		return;
 	}
-	if (app->size == 19) {
-		if (app->opcode == 0x9f40) {
+	if (size == 19) {
+		if (opcode == 0x9f40) {
 			// we have a mob update opcode - see if the back of the sendqueue has one to add this to
 			if (!SendQueue.empty()) {
 				EQOldPacket *oldpack;
@@ -2219,13 +2214,14 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 						memcpy((void*)newdata, (void*)olddata, oldpack->dwExtraSize);
 						memcpy((void*)newdata, &count, sizeof(uint32));
 						newdata += oldpack->dwExtraSize;
-						app->pBuffer += 4;
-						memcpy((void*)newdata, (void*)app->pBuffer, 15);
+						memcpy((void*)newdata, (void*)(buffer + 4), 15);
 						newdata -= oldpack->dwExtraSize;
-						app->pBuffer -= 4;
 						oldpack->dwExtraSize = (uint16)(4 + count * 15);
 						oldpack->pExtra = newdata;
-						delete[] olddata;
+						if (oldpack->payload_ref)
+							oldpack->payload_ref.reset(); // was borrowed, the merged copy is ours
+						else
+							delete[] olddata;
 						return;
 					}
 				}
@@ -2235,7 +2231,7 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 	}
 
 	/************ CHECK PACKET MANAGER STATE ************/
-	int fragsleft = (app->size >> 9);
+	int fragsleft = (size >> 9);
 	
 	if(fragsleft)
 	{
@@ -2254,9 +2250,9 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 
 			/************ Caculate the next ACKSEQ/acknumber ************/
 			/************ Check if its a static ackseq ************/
-			if( HI_BYTE(app->GetRawOpcode()) == 0x2000)
+			if( HI_BYTE(opcode) == 0x2000)
 			{
-				if(app->size == 15)
+				if(size == 15)
 					pack->dbASQ_low = 0xb2;
 				else
 					pack->dbASQ_low = 0xa1;
@@ -2285,8 +2281,8 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 			}
 
 			/************ Check if this packet should contain op ************/
-			if (app->GetRawOpcode() && i == 0) {
-				pack->dwOpCode = app->GetRawOpcode();
+			if (opcode && i == 0) {
+				pack->dwOpCode = opcode;
 			}
 			/************ End opcode check ************/
 
@@ -2298,23 +2294,24 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 
 			if (i == 0) {
 				if (LogSys.log_settings[Logs::PacketServerClient].is_category_enabled == 1) {
-					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(app->opcode);
+					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(opcode);
 					if (app_opcode != OP_SpecialMesg &&
 						(!RuleB(EventLog, SkipCommonPacketLogging) ||
 							(RuleB(EventLog, SkipCommonPacketLogging) && app_opcode != OP_MobHealth && app_opcode != OP_MobUpdate && app_opcode != OP_ClientUpdate))) {
-						LogPacketServerClient("[{}] - [{:#06x}] Size: [{}] {}", OpcodeManager::EmuToName(app_opcode), app->opcode, app->size, DumpProtocolPacketToString(app).c_str());
+						EQProtocolPacket dump(opcode, buffer, size);
+						LogPacketServerClient("[{}] - [{:#06x}] Size: [{}] {}", OpcodeManager::EmuToName(app_opcode), opcode, size, DumpProtocolPacketToString(&dump).c_str());
 					}
 				}
 			}
 
-			if(app->size && app->pBuffer)
+			if(size && buffer)
 			{
 				if(pack->HDR.a3_Fragment)
 				{
 					// If this is the last packet in the fragment group
 					if(i == fragsleft) {
 						// Calculate remaining bytes for this fragment
-						pack->dwExtraSize = app->size-510-512*((app->size/512)-1);
+						pack->dwExtraSize = size-510-512*((size/512)-1);
 					}
 					else if(i == 0) {
 						pack->dwExtraSize = 510; // The first packet in a fragment group has 510 bytes for data
@@ -2328,12 +2325,12 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 				}
 				else
 				{
-					pack->dwExtraSize = (uint16)app->size;
+					pack->dwExtraSize = (uint16)size;
 				}
 
-				pack->pExtra = new uchar[pack->dwExtraSize];
-				memcpy((void*)pack->pExtra, (void*)app->pBuffer, pack->dwExtraSize);
-				app->pBuffer += pack->dwExtraSize; //Increase counter
+				pack->pExtra = const_cast<uchar *>(buffer);
+				pack->payload_ref = payload;
+				buffer += pack->dwExtraSize; //Increase counter
 			}
 			/************ End update timers ************/
 
@@ -2344,8 +2341,6 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req, bool outboun
 		{
 			dwFragSeq++;
 		}
-		app->pBuffer -= app->size; //Restore ptr.
-		app->opcode = restore_op;
 	} //end if
 }
 
@@ -2369,15 +2364,8 @@ void EQOldStream::QueuePacket(const EQApplicationPacket *p, bool ack_req)
 	if(p == nullptr)
 		return;
 
-	if(OpMgr == nullptr || *OpMgr == nullptr) {
-		LogNetcode("[EQOldStream] Packet enqueued into a stream with no opcode manager, dropping.");
-		delete p;
-		return;
-	}
-	uint16 opcode = (*OpMgr)->EmuToEQ(p->emu_opcode);
-	EQProtocolPacket* pack2 = new EQProtocolPacket(opcode, p->pBuffer, p->size);
-	MakeEQPacket( pack2, ack_req);
-	delete pack2;
+	// the caller keeps p, so this is the one copy the data gets on its way out
+	QueueSharedPacket(EQSharedPacket(p->Copy()), ack_req);
 }
 
 void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
@@ -2388,26 +2376,25 @@ void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
 	if(pack == nullptr)
 		return;
 
-	if(OpMgr == nullptr || *OpMgr == nullptr) {
-		LogNetcodeDetail("[EQOldStream] Packet enqueued into a stream with no opcode manager, dropping.");
-		delete pack;
-		return;
-	}
-
-	uint16 opcode = (*OpMgr)->EmuToEQ(pack->emu_opcode);
-
 //	ack_req = true;	// It's broke right now, dont delete this line till fix it. =P
 
-	if(p == nullptr)
+	//if(pack->emu_opcode != OP_MobUpdate && pack->emu_opcode != OP_MobHealth && pack->emu_opcode != OP_HPUpdate)
+	//	LogNetcodeDetail( _L "Sending old opcode 0x%04x" __L, opcode);
+	QueueSharedPacket(EQSharedPacket(pack), ack_req);
+}
+
+void EQOldStream::QueueSharedPacket(const EQSharedPacket &p, bool ack_req)
+{
+	if(!p)
 		return;
 
-	EQProtocolPacket* pack2 = new EQProtocolPacket(opcode, pack->pBuffer, pack->size);
+	if(OpMgr == nullptr || *OpMgr == nullptr) {
+		LogNetcodeDetail("[EQOldStream] Packet enqueued into a stream with no opcode manager, dropping.");
+		return;
+	}
 
-	//if(pack->emu_opcode != OP_MobUpdate && pack->emu_opcode != OP_MobHealth && pack->emu_opcode != OP_HPUpdate)
-	//	LogNetcodeDetail( _L "Sending old opcode 0x%04x" __L, opcode);
-	MakeEQPacket(pack2, ack_req);
-	delete pack;
-	delete pack2;
+	uint16 opcode = (*OpMgr)->EmuToEQ(p->GetOpcode());
+	MakeEQPacket(opcode, p, ack_req);
 }
 
 EQApplicationPacket *EQOldStream::PopPacket()
@@ -2501,8 +2488,7 @@ void EQOldStream::SendPacketQueue(bool Block)
 	if (GetState() == ESTABLISHED) {
 		if ((no_ack_sent_timer->Check(0) || keep_alive_timer->Check()))
 		{
-			EQProtocolPacket app(0xFFFF, nullptr, 0);
-			MakeEQPacket(&app, true, true); // outbound is already locked
+			MakeEQPacket(0xFFFF, nullptr, true, true); // outbound is already locked
 			no_ack_sent_timer->Disable();
 		}
 	} else if (GetState() == CLOSING) {
@@ -448,7 +448,7 @@ class EQOldStream : public EQStreamInterface {
 				
 		// parce/make packets
 		void ParceEQPacket(uint16 dwSize, uchar* pPacket);
-		void MakeEQPacket(EQProtocolPacket* app, bool ack_req=true, bool outboundAlreadyLocked=false); //Make a fragment eq packet and put them on the SQUEUE/RSQUEUE
+		void MakeEQPacket(uint16 opcode, const EQSharedPacket &payload, bool ack_req=true, bool outboundAlreadyLocked=false); //Make a fragment eq packet and put them on the SQUEUE/RSQUEUE
 		void MakeClosePacket();
 		// Add ack to packet if requested
 		void AddAck(EQOldPacket *pack)
@@ -529,6 +529,7 @@ class EQOldStream : public EQStreamInterface {
 		//interface used by application (EQStreamInterface)
 		virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true);
 		virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true);
+		virtual void QueueSharedPacket(const EQSharedPacket &p, bool ack_req=true);
 		virtual EQApplicationPacket *PopPacket();
 		virtual uint32 GetRemoteIP() const { return remote_ip; }
 		virtual uint16 GetRemotePort() const { return remote_port; }
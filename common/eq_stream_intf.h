@@ -18,6 +18,7 @@ typedef enum {
 
 class EQApplicationPacket;
 class OpcodeManager;
+class StructStrategy;
 
 struct EQStreamManagerInterfaceOptions
 {
@@ -107,6 +108,12 @@ public:
 	virtual const uint32 GetBytesRecvPerSecond() const { return 0; }
 	virtual const EQ::versions::ClientVersion ClientVersion() const { return EQ::versions::ClientVersion::Unknown; }
 	virtual bool IsInUse() = 0;
+
+	//the strategy outbound packets are encoded with, nullptr if they go out as is.
+	virtual const StructStrategy *GetStructStrategy() const { return nullptr; }
+	//queues a packet that is already in wire format (through GetStructStrategy()'s encoder if there is one).
+	//streams that can hold on to p instead of copying it override this.
+	virtual void QueueSharedPacket(const EQSharedPacket &p, bool ack_req=true) { QueuePacket(p.get(), ack_req); }
 };
 
 #endif /*EQSTREAMINTF_H_*/
@@ -50,6 +50,13 @@ void EQStreamProxy::FastQueuePacket(EQApplicationPacket **p, bool ack_req) {
 	m_structs->Encode(p, m_stream, ack_req);
 }
 
+//the packet was encoded by m_structs already (see EQBroadcastPacket), hand it straight to the stream.
+void EQStreamProxy::QueueSharedPacket(const EQSharedPacket &p, bool ack_req) {
+	if(!p)
+		return;
+	m_stream->QueueSharedPacket(p, ack_req);
+}
+
 EQApplicationPacket *EQStreamProxy::PopPacket() {
 	EQApplicationPacket *pack = m_stream->PopPacket();
 	if(pack == nullptr)
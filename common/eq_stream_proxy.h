@@ -36,6 +36,8 @@ public:
 	virtual bool IsInUse();
 
 	virtual OpcodeManager *GetOpcodeManager() const;
+	virtual const StructStrategy *GetStructStrategy() const { return m_structs; }
+	virtual void QueueSharedPacket(const EQSharedPacket &p, bool ack_req=true);
 
 	virtual const uint32 GetBytesSent() const;
 	virtual const uint32 GetBytesRecieved() const;
@@ -115,9 +115,13 @@ namespace EQ {
 			EQ_EXCEPT("Shared Memory", "Could not open the file to find the existing file size.");
 		}
 		fseek(f, 0U, SEEK_END);
-		uint32 size = static_cast<uint32>(ftell(f)) - sizeof(shared_memory_struct);
-		size_ = size;
+		long file_size = ftell(f);
 		fclose(f);
+		if(file_size < static_cast<long>(sizeof(shared_memory_struct))) {
+			EQ_EXCEPT("Shared Memory", "The existing file is too small to be a shared memory file.");
+		}
+		uint32 size = static_cast<uint32>(file_size) - sizeof(shared_memory_struct);
+		size_ = size;
 
 #ifdef _WINDOWS
 		DWORD total_size = size + sizeof(shared_memory_struct);
@@ -174,6 +178,92 @@ namespace EQ {
 #endif
 	}
 
+	MemoryMappedFile::MemoryMappedFile(std::string filename, ReadOnly)
+		: filename_(filename), memory_(nullptr) {
+		imp_ = new Implementation;
+
+		std::error_code ec;
+		uintmax_t file_size = fs::file_size(filename, ec);
+		if(ec) {
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not open the file to find the existing file size.");
+		}
+		if(file_size < sizeof(shared_memory_struct) || file_size > 0xFFFFFFFFu) {
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "The existing file is not a valid size for a shared memory file.");
+		}
+		size_ = static_cast<uint32>(file_size - sizeof(shared_memory_struct));
+		size_t total_size = size_ + sizeof(shared_memory_struct);
+
+#ifdef _WINDOWS
+		HANDLE file = CreateFile(filename.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_WRITE,
+			nullptr,
+			OPEN_EXISTING,
+			0,
+			nullptr);
+
+		if(file == INVALID_HANDLE_VALUE) {
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not open a file for this shared memory segment.");
+		}
+
+		imp_->mapped_object_ = CreateFileMapping(file,
+			nullptr,
+			PAGE_READONLY,
+			0,
+			0,
+			nullptr);
+		CloseHandle(file);
+
+		if(!imp_->mapped_object_) {
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not create a file mapping for this shared memory file.");
+		}
+
+		memory_ = reinterpret_cast<shared_memory_struct*>(MapViewOfFile(imp_->mapped_object_,
+			FILE_MAP_READ,
+			0,
+			0,
+			total_size));
+
+		if(!memory_) {
+			CloseHandle(imp_->mapped_object_);
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not map a view of the shared memory file.");
+		}
+
+#else
+		imp_->fd_ = open(filename.c_str(), O_RDONLY);
+		if(imp_->fd_ == -1) {
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not open a file for this shared memory segment.");
+		}
+
+		void *memory = mmap(nullptr, total_size, PROT_READ, MAP_FILE | MAP_SHARED, imp_->fd_, 0);
+		if(memory == MAP_FAILED) {
+			close(imp_->fd_);
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "Could not create a file mapping for this shared memory file.");
+		}
+		memory_ = reinterpret_cast<shared_memory_struct*>(memory);
+#endif
+
+		// the stored size is only trusted when it fits inside the file
+		if(memory_->size > size_) {
+#ifdef _WINDOWS
+			UnmapViewOfFile(memory_);
+			CloseHandle(imp_->mapped_object_);
+#else
+			munmap(reinterpret_cast<void*>(memory_), total_size);
+			close(imp_->fd_);
+#endif
+			delete imp_;
+			EQ_EXCEPT("Shared Memory", "The shared memory file is shorter than its stored size.");
+		}
+	}
+
 	MemoryMappedFile::~MemoryMappedFile() {
 #ifdef _WINDOWS
 		if(imp_->mapped_object_) {
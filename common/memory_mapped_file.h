@@ -54,6 +54,17 @@ namespace EQ {
 		*/
 		MemoryMappedFile(std::string filename);
 
+		//! Read Only Tag
+		struct ReadOnly { };
+
+		//! Constructor
+		/*!
+			Maps an existing mmf read only and gets the size based on the existing size. The file is never
+			created or resized and a write through the mapping faults instead of changing the file.
+		\param filename Actual filename of the mmf.
+		*/
+		MemoryMappedFile(std::string filename, ReadOnly);
+
 		//! Destructor
 		~MemoryMappedFile();
 
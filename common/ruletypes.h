@@ -70,6 +70,7 @@ RULE_INT ( Character, BaseInstrumentSoftCap, 36, "Softcap for instrument mods, 3
 RULE_REAL (Character, BaseRunSpeed, 0.7, "")
 RULE_REAL(Character, EnvironmentDamageMulipliter, 1, "")
 RULE_BOOL(Character, ForageNeedFoodorDrink, false, "")
+RULE_BOOL(Character, VerifyBonusCache, false, "Debug: recompute cached item and AA bonuses in full on every CalcBonuses and log any difference")
 RULE_BOOL (Character, DisableAAs, false, "Disables server side AA support, since the client allows some AA activity through even with a pre-Luclin expansion set.")
 RULE_BOOL ( Character, SacrificeCorpseDepop, false, "If true, Sacrificed corpses will depop 3 minutes after they become empty in Pok, Nexus, or Bazaar")
 RULE_INT ( Character, DefaultExpansions, 15, "When a new account is created, this is the default bitmask expansions it is given. 1 Kunark 2 Velious 4 Luclin 8 PoP.")
@@ -362,6 +363,12 @@ RULE_REAL ( Map, FixPathingZMaxDeltaSendTo, 20, "at runtime in SendTo: max chang
 RULE_REAL ( Map, FixPathingZMaxDeltaLoading, 200, "while loading each waypoint: max change in Z to allow the BestZ code to apply.")
 RULE_INT ( Map, FindBestZHeightAdjust, 1, "Adds this to the current Z before seeking the best Z position. If this is too high, mobs bounce when pathing.")
 RULE_REAL ( Map, BestZSizeMax, 20.0, "When calculating bestz using size, this is our size cap. Setting this too high causes dragons and giants to hop.")
+RULE_BOOL ( Map, LoSCacheEnabled, true, "Cache zone map line of sight results between mobs that have not moved.")
+RULE_REAL ( Map, LoSCacheCellSize, 2.0, "LoS cache endpoints are snapped to cells this size. Larger gives more hits but coarser answers.")
+RULE_INT ( Map, LoSCacheTTL, 1000, "Milliseconds a cached line of sight result stays valid.")
+RULE_BOOL ( Map, UseWideBVH, true, "Raycast against the zone map with the 4 wide BVH instead of the original binary tree. Read at map load.")
+RULE_BOOL ( Map, UseSharedMapFiles, true, "Zones map a prebuilt BVH from the shared memory maps folder instead of each building their own. Needs UseWideBVH.")
+RULE_BOOL ( Map, UseHeightField, true, "Build a per cell table of floor and ceiling triangles with the BVH so vertical raycasts, like FindBestZ, mostly skip the tree walk. Needs UseWideBVH. Read at map load.")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Pathing )
@@ -370,7 +377,12 @@ RULE_REAL ( Pathing, CandidateNodeRangeXY, 200, "When searching for path start/e
 RULE_REAL ( Pathing, CandidateNodeRangeZ, 25, "When searching for path start/end nodes, only nodes within this range will be considered.")
 RULE_INT(Pathing, MaxNavmeshNodes, 8184, "Maximum navmesh nodes in a traversable path")
 RULE_REAL(Pathing, NavmeshStepSize, 100.0f, "Step size for the movement manager")
+RULE_INT(Pathing, AsyncWorkers, 2, "Worker threads computing navmesh paths for the movement manager. 0 computes them on the zone thread")
+RULE_INT(Pathing, RouteCacheSize, 1024, "Number of recently found navmesh poly corridors kept for reuse. 0 disables the cache")
 RULE_REAL(Pathing, ShortMovementUpdateRange, 130.0f, "Range for short movement updates")
+RULE_REAL(Pathing, MediumMovementUpdateRange, 500.0f, "Range for medium movement updates. Past this clients get long range updates out to the zone update range, and none beyond it")
+RULE_REAL(Pathing, MediumMovementUpdateInterval, 4.0f, "Minimum seconds between periodic movement resyncs sent to clients in medium range")
+RULE_REAL(Pathing, LongMovementUpdateInterval, 8.0f, "Minimum seconds between periodic movement resyncs sent to clients in long range")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Watermap )
@@ -486,6 +498,7 @@ RULE_INT ( Aggro, SpellAggroMod, 100, "")
 RULE_REAL ( Aggro, TunnelVisionAggroMod, 0.75, "people not currently the top hate generate this much hate on a Tunnel Vision mob")
 RULE_INT(Aggro, ClientAggroCheckMovingInterval, 1000, "Interval in which clients actually check for aggro while moving - in milliseconds - this should be lower than ClientAggroCheckIdleInterval")
 RULE_INT(Aggro, ClientAggroCheckIdleInterval, 3000, "Interval in which clients actually check for aggro while idle - in milliseconds - this should be higher than ClientAggroCheckMovingInterval")
+RULE_INT(Aggro, DecideWorkers, 2, "Worker threads that trace line of sight for the aggro scans due this tick before MobProcess runs them. 0 leaves every trace to the zone thread")
 RULE_CATEGORY_END()
 
 RULE_CATEGORY ( Chat )
@@ -582,6 +595,13 @@ RULE_INT ( Groundspawns, FullInvDecayTime, 21600000, "Decay time of items droppe
 RULE_BOOL ( Groundspawns, RandomSpawn, true, "Determines if groundspawns with random spawn locs will periodically despawn and respawn elsewhere.")
 RULE_CATEGORY_END()
 
+RULE_CATEGORY( Lua )
+RULE_INT ( Lua, GCMode, 1, "0 = full collect after every quest event, 1 = incremental steps from the zone loop within GCStepBudgetUS per tick")
+RULE_INT ( Lua, GCStepBudgetUS, 500, "Microseconds of incremental collection allowed per zone tick in GCMode 1")
+RULE_INT ( Lua, GCFullCollectKB, 65536, "In GCMode 1, a heap at or above this many KB gets a full collect instead of steps. 0 disables")
+RULE_BOOL ( Lua, BytecodeCache, true, "Load quest scripts from compiled bytecode under cache/lua when it matches the source, compiling and storing it when it doesn't")
+RULE_CATEGORY_END()
+
 RULE_CATEGORY( Range )
 RULE_INT ( Range, EventSay, 5000, "")
 RULE_INT ( Range, EventAggroSay, 5000, "")
@@ -1274,7 +1274,7 @@ int SharedDatabase::GetMaxSpellID()
 	return atoi(row[0]);
 }
 
-bool SharedDatabase::LoadSpells(const std::string &prefix, int32 *records, const SPDat_Spell_Struct **sp) 
+bool SharedDatabase::LoadSpells(const std::string &prefix, int32 *records, const SPDat_Spell_Struct **sp, const SPDat_Spell_Class **classes)
 {
 	spells_mmf.reset(nullptr);
 
@@ -1288,6 +1288,16 @@ bool SharedDatabase::LoadSpells(const std::string &prefix, int32 *records, const
 		LogInfo("Loading [{}]", file_name);
 		*records = *reinterpret_cast<uint32*>(spells_mmf->Get());
 		*sp = reinterpret_cast<const SPDat_Spell_Struct*>((char*)spells_mmf->Get() + 4);
+
+		// the classification tables follow the records, older files don't have them
+		uint64 full_size = sizeof(uint32) + static_cast<uint64>(*records) * (sizeof(SPDat_Spell_Struct) + sizeof(SPDat_Spell_Class));
+		if (spells_mmf->Size() >= full_size) {
+			*classes = reinterpret_cast<const SPDat_Spell_Class*>(*sp + *records);
+		}
+		else {
+			*classes = nullptr;
+			LogInfo("Spells shared memory has no classification tables, run shared_memory to rebuild it");
+		}
 		mutex.Unlock();
 
 		LogInfo("Loaded [{}] spells via shared memory", Strings::Commify(m_shared_spells_count));
@@ -1505,6 +1515,10 @@ void SharedDatabase::LoadSpells(void *data, int max_spells)
     }
 
     LoadDamageShieldTypes(sp, max_spells);
+
+	SPDat_Spell_Class *classes = reinterpret_cast<SPDat_Spell_Class*>(sp + max_spells);
+	for (int i = 0; i < max_spells; ++i)
+		BuildSpellClass(sp[i], classes[i]);
 }
 
 bool SharedDatabase::VerifyToken(std::string token, int& status)
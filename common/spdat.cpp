@@ -331,40 +331,10 @@ bool IsBeneficialSpell(uint16 spell_id)
 	if (!IsValidSpell(spell_id))
 		return false;
 
-	// You'd think just checking goodEffect flag would be enough?
-	if (spells[spell_id].goodEffect == 1) {
-		// If the target type is not ST_Self or ST_Pet or ST_GroupTeleport and is a SE_CancelMagic spell
-		// it is not Beneficial
-		SpellTargetType tt = spells[spell_id].targettype;
-		if (tt != ST_Self && tt != ST_Pet && tt != ST_GroupTeleport &&
-				IsEffectInSpell(spell_id, SE_CancelMagic))
-			return false;
-
-		// When our targettype is ST_Target, ST_AETarget, ST_Aniaml, ST_Undead, or ST_Pet
-		// We need to check more things!
-		if (tt == ST_Target || tt == ST_AETarget || tt == ST_Animal ||
-				tt == ST_Undead || tt == ST_Pet) {
-			// TODO: SpellAffectIndex is data for the older particle cloud system in the client, and not for spell logic.
-			// all of this beneficial/detrimental stuff is not right, it's just full of hacks like this for specific spells
-			// which masks some of the problems
-			uint16 sai = spells[spell_id].SpellAffectIndex;
-
-			// If the resisttype is magic and SpellAffectIndex is Calm/dispell sight
-			// it's not beneficial.
-			if (spells[spell_id].resisttype == RESIST_MAGIC) {
-				if (sai == SAI_Calm || sai == SAI_Dispell_Sight || sai == SAI_Calm_Song)
-					return false;
-			} else {
-				// If the resisttype is not magic and spell is Harmony
-				// It's not beneficial
-				if (sai == SAI_Calm && IsEffectInSpell(spell_id, SE_Harmony))
-					return false;
-			}
-		}
-	}
+	if (spell_classes)
+		return (spell_classes[spell_id].flags & SPELL_CLASS_BENEFICIAL) != 0;
 
-	// And finally, if goodEffect is not 0 or if it's a group spell it's beneficial
-	return spells[spell_id].goodEffect != 0 || IsGroupSpell(spell_id);
+	return ClassifyBeneficialSpell(spells[spell_id]);
 }
 
 bool IsDetrimentalSpell(uint16 spell_id)
@@ -622,13 +592,13 @@ bool IsResistableSpell(uint16 spell_id)
 // checks if this spell affects your group
 bool IsGroupSpell(uint16 spell_id)
 {
-	if (IsValidSpell(spell_id) &&
-			(spells[spell_id].targettype == ST_AEBard ||
-			 spells[spell_id].targettype == ST_Group ||
-			 spells[spell_id].targettype == ST_GroupTeleport))
-		return true;
+	if (!IsValidSpell(spell_id))
+		return false;
 
-	return false;
+	if (spell_classes)
+		return (spell_classes[spell_id].flags & SPELL_CLASS_GROUP) != 0;
+
+	return ClassifyGroupSpell(spells[spell_id]);
 }
 
 // checks if this spell can be targeted
@@ -652,16 +622,13 @@ bool IsBardSong(uint16 spell_id)
 
 bool IsEffectInSpell(uint16 spellid, int effect)
 {
-	int j;
-
 	if (!IsValidSpell(spellid))
 		return false;
 
-	for (j = 0; j < EFFECT_COUNT; j++)
-		if (spells[spellid].effectid[j] == effect)
-			return true;
+	if (spell_classes && effect >= 0 && effect < SPELL_EFFECT_MASK_BITS)
+		return (spell_classes[spellid].effect_mask[effect >> 5] & (1u << (effect & 31))) != 0;
 
-	return false;
+	return ClassifyEffectInSpell(spells[spellid], effect);
 }
 
 // arguments are spell id and the index of the effect to check.
@@ -661,7 +661,30 @@ struct SpellModifier_Struct {
 	int     tic_add;         // Tic count added
 };
 
+// Compact per spell answers to the questions asked most often. Built by
+// shared_memory with BuildSpellClass() and stored right after the spell
+// records in the spells mmf, one entry per record.
+#define SPELL_CLASS_BENEFICIAL		0x00000001
+#define SPELL_CLASS_GROUP			0x00000002
+
+#define SPELL_EFFECT_MASK_BITS		512
+
+struct SPDat_Spell_Class
+{
+	uint32 flags;
+	// bit n is set if the spell has effect id n in any slot
+	uint32 effect_mask[SPELL_EFFECT_MASK_BITS / 32];
+};
+
+// these work from the spell record alone, they are what the tables are built from
+bool ClassifyBeneficialSpell(const SPDat_Spell_Struct &sp);
+bool ClassifyGroupSpell(const SPDat_Spell_Struct &sp);
+bool ClassifyEffectInSpell(const SPDat_Spell_Struct &sp, int effect);
+void BuildSpellClass(const SPDat_Spell_Struct &sp, SPDat_Spell_Class &out);
+
 extern const SPDat_Spell_Struct* spells;
+// null when the spells mmf predates the tables, callers fall back to the records
+extern const SPDat_Spell_Class* spell_classes;
 extern std::map<std::tuple<int,int,int>, SpellModifier_Struct> spellModifiers;
 extern int32 SPDAT_RECORDS;
 
@@ -0,0 +1,93 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+// Spell classification from a single spell record. Nothing in here may touch
+// the spells/SPDAT_RECORDS globals, shared_memory builds the tables with it
+// and only the zone defines those.
+
+#include <string.h>
+
+#include "spdat.h"
+
+bool ClassifyEffectInSpell(const SPDat_Spell_Struct &sp, int effect)
+{
+	for (int j = 0; j < EFFECT_COUNT; j++)
+		if (sp.effectid[j] == effect)
+			return true;
+
+	return false;
+}
+
+bool ClassifyGroupSpell(const SPDat_Spell_Struct &sp)
+{
+	return sp.targettype == ST_AEBard || sp.targettype == ST_Group || sp.targettype == ST_GroupTeleport;
+}
+
+bool ClassifyBeneficialSpell(const SPDat_Spell_Struct &sp)
+{
+	// You'd think just checking goodEffect flag would be enough?
+	if (sp.goodEffect == 1) {
+		// If the target type is not ST_Self or ST_Pet or ST_GroupTeleport and is a SE_CancelMagic spell
+		// it is not Beneficial
+		SpellTargetType tt = sp.targettype;
+		if (tt != ST_Self && tt != ST_Pet && tt != ST_GroupTeleport &&
+				ClassifyEffectInSpell(sp, SE_CancelMagic))
+			return false;
+
+		// When our targettype is ST_Target, ST_AETarget, ST_Aniaml, ST_Undead, or ST_Pet
+		// We need to check more things!
+		if (tt == ST_Target || tt == ST_AETarget || tt == ST_Animal ||
+				tt == ST_Undead || tt == ST_Pet) {
+			// TODO: SpellAffectIndex is data for the older particle cloud system in the client, and not for spell logic.
+			// all of this beneficial/detrimental stuff is not right, it's just full of hacks like this for specific spells
+			// which masks some of the problems
+			uint16 sai = sp.SpellAffectIndex;
+
+			// If the resisttype is magic and SpellAffectIndex is Calm/dispell sight
+			// it's not beneficial.
+			if (sp.resisttype == RESIST_MAGIC) {
+				if (sai == SAI_Calm || sai == SAI_Dispell_Sight || sai == SAI_Calm_Song)
+					return false;
+			} else {
+				// If the resisttype is not magic and spell is Harmony
+				// It's not beneficial
+				if (sai == SAI_Calm && ClassifyEffectInSpell(sp, SE_Harmony))
+					return false;
+			}
+		}
+	}
+
+	// And finally, if goodEffect is not 0 or if it's a group spell it's beneficial
+	return sp.goodEffect != 0 || ClassifyGroupSpell(sp);
+}
+
+void BuildSpellClass(const SPDat_Spell_Struct &sp, SPDat_Spell_Class &out)
+{
+	memset(&out, 0, sizeof(out));
+
+	if (ClassifyBeneficialSpell(sp))
+		out.flags |= SPELL_CLASS_BENEFICIAL;
+	if (ClassifyGroupSpell(sp))
+		out.flags |= SPELL_CLASS_GROUP;
+
+	for (int j = 0; j < EFFECT_COUNT; j++) {
+		int effect = sp.effectid[j];
+		if (effect >= 0 && effect < SPELL_EFFECT_MASK_BITS)
+			out.effect_mask[effect >> 5] |= 1u << (effect & 31);
+	}
+}
@@ -0,0 +1,432 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "timer_wheel.h"
+#include "timer.h"
+
+#include <algorithm>
+
+static uint32 TimerClock()
+{
+	return Timer::GetCurrentTime();
+}
+
+TimerWheel::TimerWheel(Clock clock)
+	: m_clock(clock ? clock : TimerClock)
+{
+	m_nodes.resize(ListCount);
+	for (uint32 i = 0; i < ListCount; ++i) {
+		m_nodes[i].prev = i;
+		m_nodes[i].next = i;
+		m_nodes[i].generation = 0;
+		m_nodes[i].active = false;
+		m_nodes[i].deadline = 0;
+	}
+
+	m_free = NoNode;
+	m_count = 0;
+	m_fired = 0;
+	m_time = 0;
+	m_synced = 0;
+	m_last = m_clock();
+}
+
+TimerWheel::TimerID TimerWheel::Schedule(uint32 delay, Callback cb)
+{
+	uint32 index;
+	if (m_free != NoNode) {
+		index = m_free;
+		m_free = m_nodes[index].next;
+	}
+	else {
+		index = static_cast<uint32>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_nodes[index].generation = 1;
+	}
+
+	// the slot for the current wheel time has already run
+	uint64 deadline = Now() + delay;
+	if (deadline <= m_time)
+		deadline = m_time + 1;
+
+	Node &n = m_nodes[index];
+	n.active = true;
+	n.deadline = deadline;
+	n.cb = std::move(cb);
+	Insert(index);
+	m_count++;
+
+	return (static_cast<uint64>(n.generation) << 32) | index;
+}
+
+bool TimerWheel::Cancel(TimerID id)
+{
+	Node *n = Find(id);
+	if (!n)
+		return false;
+
+	uint32 index = static_cast<uint32>(id & 0xFFFFFFFF);
+	Unlink(index);
+	Release(index);
+	return true;
+}
+
+bool TimerWheel::IsScheduled(TimerID id) const
+{
+	return Find(id) != nullptr;
+}
+
+uint32 TimerWheel::GetRemainingTime(TimerID id) const
+{
+	const Node *n = Find(id);
+	if (!n)
+		return 0xFFFFFFFF;
+
+	uint64 now = Now();
+	if (n->deadline <= now)
+		return 0;
+
+	uint64 remaining = n->deadline - now;
+	return remaining > 0xFFFFFFFE ? 0xFFFFFFFE : static_cast<uint32>(remaining);
+}
+
+void TimerWheel::Advance()
+{
+	m_synced = Now();
+	m_last = m_clock();
+
+	while (m_time < m_synced) {
+		// slots are picked from absolute time, an empty wheel can skip ahead
+		if (m_count == 0) {
+			m_time = m_synced;
+			break;
+		}
+
+		++m_time;
+		if ((m_time & (RootSlots - 1)) == 0) {
+			for (uint32 level = 1; level < Levels; ++level) {
+				Cascade(level);
+				if (((m_time >> LevelShift(level)) & (LevelSlots - 1)) != 0)
+					break;
+			}
+		}
+
+		Splice(static_cast<uint32>(m_time & (RootSlots - 1)), Running);
+		RunDue();
+	}
+}
+
+uint64 TimerWheel::Now() const
+{
+	// unsigned difference keeps counting through the 32 bit ms wrap
+	return m_synced + static_cast<uint32>(m_clock() - m_last);
+}
+
+uint32 TimerWheel::ListFor(uint64 deadline) const
+{
+	uint64 delta = deadline > m_time ? deadline - m_time : 0;
+	if (delta < RootSlots)
+		return static_cast<uint32>(deadline & (RootSlots - 1));
+
+	if (delta >= MaxSpan)
+		deadline = m_time + MaxSpan - 1;
+
+	for (uint32 level = 1; level < Levels; ++level) {
+		uint32 shift = LevelShift(level);
+		if (level == Levels - 1 || delta < (1ull << (shift + LevelBits)))
+			return RootSlots + (level - 1) * LevelSlots + static_cast<uint32>((deadline >> shift) & (LevelSlots - 1));
+	}
+
+	return Running;
+}
+
+void TimerWheel::Insert(uint32 index)
+{
+	Link(ListFor(m_nodes[index].deadline), index);
+}
+
+void TimerWheel::Link(uint32 list, uint32 index)
+{
+	uint32 tail = m_nodes[list].prev;
+	m_nodes[index].prev = tail;
+	m_nodes[index].next = list;
+	m_nodes[tail].next = index;
+	m_nodes[list].prev = index;
+}
+
+void TimerWheel::Unlink(uint32 index)
+{
+	Node &n = m_nodes[index];
+	m_nodes[n.prev].next = n.next;
+	m_nodes[n.next].prev = n.prev;
+	n.prev = index;
+	n.next = index;
+}
+
+void TimerWheel::Splice(uint32 from, uint32 to)
+{
+	if (m_nodes[from].next == from)
+		return;
+
+	uint32 first = m_nodes[from].next;
+	uint32 last = m_nodes[from].prev;
+	uint32 tail = m_nodes[to].prev;
+
+	m_nodes[tail].next = first;
+	m_nodes[first].prev = tail;
+	m_nodes[last].next = to;
+	m_nodes[to].prev = last;
+	m_nodes[from].next = from;
+	m_nodes[from].prev = from;
+}
+
+void TimerWheel::Cascade(uint32 level)
+{
+	uint32 list = RootSlots + (level - 1) * LevelSlots + static_cast<uint32>((m_time >> LevelShift(level)) & (LevelSlots - 1));
+
+	// everything in the slot is due within the span of the level below now
+	Splice(list, Running);
+	while (m_nodes[Running].next != Running) {
+		uint32 index = m_nodes[Running].next;
+		Unlink(index);
+		Insert(index);
+	}
+}
+
+void TimerWheel::RunDue()
+{
+	while (m_nodes[Running].next != Running) {
+		uint32 index = m_nodes[Running].next;
+		Unlink(index);
+
+		// the node may be reused by the callback, don't touch it afterwards
+		Callback cb = std::move(m_nodes[index].cb);
+		Release(index);
+		m_fired++;
+
+		if (cb)
+			cb();
+	}
+}
+
+void TimerWheel::Release(uint32 index)
+{
+	Node &n = m_nodes[index];
+	n.active = false;
+	n.cb = nullptr;
+	if (++n.generation == 0)
+		n.generation = 1;
+
+	n.next = m_free;
+	m_free = index;
+	m_count--;
+}
+
+TimerWheel::Node *TimerWheel::Find(TimerID id)
+{
+	return const_cast<Node *>(static_cast<const TimerWheel *>(this)->Find(id));
+}
+
+const TimerWheel::Node *TimerWheel::Find(TimerID id) const
+{
+	uint32 index = static_cast<uint32>(id & 0xFFFFFFFF);
+	uint32 generation = static_cast<uint32>(id >> 32);
+	if (index < ListCount || index >= m_nodes.size())
+		return nullptr;
+
+	const Node &n = m_nodes[index];
+	if (!n.active || n.generation != generation)
+		return nullptr;
+
+	return &n;
+}
+
+WheelTimer::WheelTimer(TimerWheel &wheel, uint32 duration, TimerWheel::Callback on_expire, bool repeat)
+	: m_wheel(wheel), m_on_expire(std::move(on_expire)), m_id(0), m_duration(duration),
+	m_deadline(m_wheel.GetCurrentTime()), m_pause_time(0), m_enabled(false), m_expired(false), m_repeat(repeat)
+{
+	if (!m_on_expire && duration != 0)
+		Arm(duration);
+}
+
+bool WheelTimer::Check(bool iReset)
+{
+	if (!m_enabled || !m_expired)
+		return false;
+
+	if (iReset)
+		Arm(m_duration);
+
+	return true;
+}
+
+// same catch up as Timer::CheckKeepSynchronized, m_deadline is still the time the period ended
+bool WheelTimer::CheckKeepSynchronized(int tolerance)
+{
+	if (!m_enabled || !m_expired)
+		return false;
+
+	uint32 overTime = m_wheel.GetCurrentTime() - m_deadline;
+	if (overTime > static_cast<uint32>(tolerance))
+		overTime = 0;
+
+	Arm(m_duration - std::min(overTime, m_duration));
+	return true;
+}
+
+void WheelTimer::Start(uint32 duration, bool ChangeResetTimer)
+{
+	if (duration != 0) {
+		if (ChangeResetTimer)
+			m_duration = duration;
+	}
+	else {
+		duration = m_duration;
+	}
+
+	Arm(duration);
+}
+
+void WheelTimer::Enable()
+{
+	if (!m_enabled)
+		ArmAt(m_deadline);
+}
+
+void WheelTimer::Disable()
+{
+	Cancel();
+	m_enabled = false;
+}
+
+void WheelTimer::Trigger()
+{
+	m_pause_time = 0;
+	Arm(0);
+}
+
+void WheelTimer::Reset()
+{
+	m_pause_time = 0;
+	if (m_enabled)
+		Arm(m_duration);
+	else
+		m_deadline = m_wheel.GetCurrentTime() + m_duration;
+}
+
+void WheelTimer::Stop()
+{
+	m_pause_time = 0;
+	Disable();
+}
+
+void WheelTimer::Pause()
+{
+	if (!m_enabled)
+		return;
+
+	m_pause_time = GetRemainingTime();
+	Disable();
+}
+
+void WheelTimer::Resume()
+{
+	if (m_enabled)
+		return;
+
+	if (m_pause_time > 0 && m_pause_time != 0xFFFFFFFF) {
+		Arm(m_pause_time);
+		m_pause_time = 0;
+	}
+}
+
+bool WheelTimer::Paused() const
+{
+	return !m_enabled && m_pause_time > 0 && m_pause_time != 0xFFFFFFFF;
+}
+
+void WheelTimer::SetDuration(uint32 duration, bool update_current_interval)
+{
+	uint32 deadline = m_deadline;
+	if (update_current_interval)
+		deadline = deadline - m_duration + duration;
+
+	m_duration = duration;
+	if (update_current_interval || !m_enabled)
+		ArmAt(deadline);
+}
+
+uint32 WheelTimer::GetRemainingTime() const
+{
+	if (!m_enabled)
+		return 0xFFFFFFFF;
+	if (m_expired)
+		return 0;
+
+	int32 remaining = static_cast<int32>(m_deadline - m_wheel.GetCurrentTime());
+	return remaining > 0 ? static_cast<uint32>(remaining) : 0;
+}
+
+void WheelTimer::Arm(uint32 delay)
+{
+	Cancel();
+	m_enabled = true;
+	m_expired = false;
+	m_deadline = m_wheel.GetCurrentTime() + delay;
+
+	// a polled timer that is already due reads that way straight away, like Timer
+	if (delay == 0 && !m_on_expire) {
+		m_expired = true;
+		return;
+	}
+
+	m_id = m_wheel.Schedule(delay, [this]() { Expire(); });
+}
+
+void WheelTimer::ArmAt(uint32 deadline)
+{
+	// signed so a deadline already behind the clock comes out as due
+	int32 delay = static_cast<int32>(deadline - m_wheel.GetCurrentTime());
+	Arm(delay > 0 ? static_cast<uint32>(delay) : 0);
+	m_deadline = deadline;
+}
+
+void WheelTimer::Cancel()
+{
+	if (m_id) {
+		m_wheel.Cancel(m_id);
+		m_id = 0;
+	}
+}
+
+void WheelTimer::Expire()
+{
+	m_id = 0;
+	if (!m_on_expire) {
+		m_expired = true;
+		return;
+	}
+
+	if (m_repeat)
+		Arm(m_duration);
+	else
+		m_enabled = false;
+
+	// nothing of the timer is touched after this, the callback may re-arm it
+	m_on_expire();
+}
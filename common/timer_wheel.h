@@ -0,0 +1,167 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "types.h"
+#include <functional>
+#include <vector>
+
+/*
+ * Hierarchical timer wheel running on the Timer clock (Timer::GetCurrentTime).
+ * Deadlines are registered once and their callback runs from Advance() when
+ * they come due, so nothing is paid per tick for timers that are not firing.
+ *
+ * Level 0 has 256 one millisecond slots, each level above it has 64 slots
+ * covering the whole span of the level below. Timers further out than about
+ * 18 hours park in the last level and are re-placed as it turns over.
+ *
+ * Callbacks may schedule and cancel timers, including themselves. A timer
+ * scheduled from a callback always lands on a later slot than the one being
+ * run, so a callback re-arming itself with no delay can't stall Advance().
+ */
+class TimerWheel
+{
+public:
+	typedef uint64 TimerID;
+	typedef std::function<void()> Callback;
+	typedef uint32 (*Clock)();
+
+	// clock defaults to Timer::GetCurrentTime, tests pass their own
+	explicit TimerWheel(Clock clock = nullptr);
+
+	// runs cb once delay ms from now, a 0 delay runs on the next Advance()
+	TimerID Schedule(uint32 delay, Callback cb);
+	// returns false if the timer already ran or was cancelled
+	bool Cancel(TimerID id);
+	bool IsScheduled(TimerID id) const;
+	// ms until the timer runs, 0xFFFFFFFF if it isn't scheduled (same as a disabled Timer)
+	uint32 GetRemainingTime(TimerID id) const;
+
+	// catches the wheel up to the current Timer time and runs everything due
+	void Advance();
+
+	inline uint32 GetCurrentTime() const { return m_clock(); }
+	inline size_t Size() const { return m_count; }
+	inline uint64 GetFiredCount() const { return m_fired; }
+
+private:
+	static constexpr uint32 RootBits = 8;
+	static constexpr uint32 LevelBits = 6;
+	static constexpr uint32 Levels = 4;
+	static constexpr uint32 RootSlots = 1 << RootBits;
+	static constexpr uint32 LevelSlots = 1 << LevelBits;
+	static constexpr uint64 MaxSpan = 1ull << (RootBits + LevelBits * (Levels - 1));
+	// one sentinel per slot plus the list being run
+	static constexpr uint32 Running = RootSlots + LevelSlots * (Levels - 1);
+	static constexpr uint32 ListCount = Running + 1;
+	static constexpr uint32 NoNode = 0xFFFFFFFF;
+
+	struct Node {
+		uint32 prev;
+		uint32 next;
+		uint32 generation;
+		bool active;
+		uint64 deadline;
+		Callback cb;
+	};
+
+	static constexpr uint32 LevelShift(uint32 level) { return RootBits + LevelBits * (level - 1); }
+
+	uint64 Now() const;
+	uint32 ListFor(uint64 deadline) const;
+	void Insert(uint32 index);
+	void Link(uint32 list, uint32 index);
+	void Unlink(uint32 index);
+	void Splice(uint32 from, uint32 to);
+	void Cascade(uint32 level);
+	void RunDue();
+	void Release(uint32 index);
+	Node *Find(TimerID id);
+	const Node *Find(TimerID id) const;
+
+	Clock m_clock;
+	std::vector<Node> m_nodes;
+	uint32 m_free;
+	size_t m_count;
+	uint64 m_fired;
+	// m_time is the last slot run, m_synced the clock as of the last Advance()
+	// and m_last the Timer time it was taken from
+	uint64 m_time;
+	uint64 m_synced;
+	uint32 m_last;
+};
+
+/*
+ * Timer on a TimerWheel with the Timer interface, so owners keep the calls
+ * they already make. The wheel records expiry, Check() and the rest only
+ * read and re-arm it.
+ *
+ * With on_expire the timer is driven by the wheel instead of polled: the
+ * callback runs from TimerWheel::Advance() and a repeating timer has been
+ * re-armed for its next period by then, otherwise it reads as disabled.
+ * Such a timer starts on its owner's first Start(). Without a callback it
+ * behaves like Timer, including running from construction when given a
+ * duration, and anything that puts its trigger time at or before now (a
+ * Trigger() for one) expires it on the spot instead of on the next Advance().
+ */
+class WheelTimer
+{
+public:
+	WheelTimer(TimerWheel &wheel, uint32 duration = 0, TimerWheel::Callback on_expire = nullptr, bool repeat = false);
+	~WheelTimer() { Cancel(); }
+
+	bool Check(bool iReset = true);
+	bool CheckKeepSynchronized(int tolerance = 200);
+	void Start(uint32 duration = 0, bool ChangeResetTimer = true);
+	void Enable();
+	void Disable();
+	void Trigger();
+	void Reset();
+	void Stop();
+	void Pause();
+	void Resume();
+	bool Paused() const;
+	void SetDuration(uint32 duration, bool update_current_interval = false);
+
+	inline bool Enabled() const { return m_enabled; }
+	inline uint32 GetDuration() const { return m_duration; }
+	uint32 GetRemainingTime() const;
+
+private:
+	WheelTimer(const WheelTimer &) = delete;
+	WheelTimer &operator=(const WheelTimer &) = delete;
+
+	void Arm(uint32 delay);
+	void ArmAt(uint32 deadline);
+	void Cancel();
+	void Expire();
+
+	TimerWheel &m_wheel;
+	TimerWheel::Callback m_on_expire;
+	TimerWheel::TimerID m_id;
+	uint32 m_duration;
+	// Timer time the current period ends, kept while disabled like Timer's TriggerTime
+	uint32 m_deadline;
+	uint32 m_pause_time;
+	bool m_enabled;
+	bool m_expired;
+	bool m_repeat;
+};
+
+#endif
@@ -32,7 +32,7 @@ void LoadSpells(SharedDatabase *database, const std::string &prefix) {
 		EQ_EXCEPT("Shared Memory", "Unable to get any spells from the database.");
 	}
 
-	uint32 size = records * sizeof(SPDat_Spell_Struct) + sizeof(uint32);
+	uint32 size = records * (sizeof(SPDat_Spell_Struct) + sizeof(SPDat_Spell_Class)) + sizeof(uint32);
 
 	auto Config = EQEmuConfig::get();
 	std::string file_name = Config->SharedMemDir + prefix + std::string("spells");
@@ -31,6 +31,7 @@
 #include "string_util_test.h"
 #include "data_verification_test.h"
 #include "skills_util_test.h"
+#include "timer_wheel_test.h"
 #include "../common/eqemu_config.h"
 #include "../common/eqemu_logsys.h"
 
@@ -59,6 +60,7 @@ int main()
 		tests.add(new StringUtilTest());
 		tests.add(new DataVerificationTest());
 		tests.add(new SkillsUtilsTest());
+		tests.add(new TimerWheelTest());
 		tests.run(*output, true);
 	} catch(...) {
 		return -1;
@@ -0,0 +1,393 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_TIMER_WHEEL_H
+#define __EQEMU_TESTS_TIMER_WHEEL_H
+
+#include "cppunit/cpptest.h"
+#include "../common/timer_wheel.h"
+
+#include <vector>
+
+class TimerWheelTest : public Test::Suite {
+	typedef void(TimerWheelTest::*TestFunction)(void);
+public:
+	TimerWheelTest() {
+		TEST_ADD(TimerWheelTest::FiresOnDeadlineTest);
+		TEST_ADD(TimerWheelTest::CancelTest);
+		TEST_ADD(TimerWheelTest::RearmInCallbackTest);
+		TEST_ADD(TimerWheelTest::CancelInCallbackTest);
+		TEST_ADD(TimerWheelTest::CascadeTest);
+		TEST_ADD(TimerWheelTest::FarFutureTest);
+		TEST_ADD(TimerWheelTest::ClockWrapTest);
+		TEST_ADD(TimerWheelTest::PolledTimerTest);
+		TEST_ADD(TimerWheelTest::KeepSynchronizedTest);
+		TEST_ADD(TimerWheelTest::PauseTest);
+		TEST_ADD(TimerWheelTest::RepeatingTimerTest);
+		TEST_ADD(TimerWheelTest::OneShotTimerTest);
+	}
+
+	~TimerWheelTest() {
+	}
+
+	private:
+	// the wheels under test run on this instead of Timer::GetCurrentTime
+	static inline uint32 now = 0;
+	static uint32 Clock() { return now; }
+
+	// moves the clock a millisecond at a time so every slot gets its own Advance()
+	void Step(TimerWheel &wheel, uint32 ms) {
+		for (uint32 i = 0; i < ms; ++i) {
+			++now;
+			wheel.Advance();
+		}
+	}
+
+	void Jump(TimerWheel &wheel, uint32 ms) {
+		now += ms;
+		wheel.Advance();
+	}
+
+	void FiresOnDeadlineTest() {
+		now = 1000;
+		TimerWheel wheel(Clock);
+		std::vector<uint32> fired;
+
+		wheel.Schedule(10, [&]() { fired.push_back(now); });
+		wheel.Schedule(0, [&]() { fired.push_back(now); });
+		TEST_ASSERT_EQUALS(wheel.Size(), 2);
+
+		Step(wheel, 1);
+		TEST_ASSERT_EQUALS(fired.size(), 1);
+		TEST_ASSERT_EQUALS(fired[0], 1001);
+
+		Step(wheel, 8);
+		TEST_ASSERT_EQUALS(fired.size(), 1);
+		Step(wheel, 1);
+		TEST_ASSERT_EQUALS(fired.size(), 2);
+		TEST_ASSERT_EQUALS(fired[1], 1010);
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+		TEST_ASSERT_EQUALS(wheel.GetFiredCount(), 2);
+	}
+
+	void CancelTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		int fired = 0;
+
+		auto id = wheel.Schedule(50, [&]() { fired++; });
+		TEST_ASSERT(wheel.IsScheduled(id));
+		TEST_ASSERT_EQUALS(wheel.GetRemainingTime(id), 50);
+
+		Jump(wheel, 20);
+		TEST_ASSERT_EQUALS(wheel.GetRemainingTime(id), 30);
+		TEST_ASSERT(wheel.Cancel(id));
+		TEST_ASSERT(!wheel.Cancel(id));
+		TEST_ASSERT(!wheel.IsScheduled(id));
+		TEST_ASSERT_EQUALS(wheel.GetRemainingTime(id), 0xFFFFFFFF);
+
+		// the freed node is reused, the old id must not reach the new timer
+		auto id2 = wheel.Schedule(10, [&]() { fired++; });
+		TEST_ASSERT(id2 != id);
+		TEST_ASSERT(!wheel.Cancel(id));
+		TEST_ASSERT(wheel.IsScheduled(id2));
+
+		Jump(wheel, 100);
+		TEST_ASSERT_EQUALS(fired, 1);
+	}
+
+	void RearmInCallbackTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		std::vector<uint32> fired;
+
+		// a callback re-arming itself with no delay runs again on the next slot, not in a loop
+		std::function<void()> again = [&]() {
+			fired.push_back(now);
+			if (fired.size() < 3)
+				wheel.Schedule(0, again);
+		};
+		wheel.Schedule(5, again);
+
+		Jump(wheel, 5);
+		TEST_ASSERT_EQUALS(fired.size(), 1);
+		Jump(wheel, 1);
+		TEST_ASSERT_EQUALS(fired.size(), 2);
+		Jump(wheel, 1);
+		TEST_ASSERT_EQUALS(fired.size(), 3);
+		TEST_ASSERT_EQUALS(fired[2], 7);
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+
+		// re-armed while a late Advance() catches up, the next period counts from
+		// the current time the way Timer::Check() resets
+		fired.clear();
+		std::function<void()> periodic = [&]() {
+			fired.push_back(now);
+			if (fired.size() < 4)
+				wheel.Schedule(100, periodic);
+		};
+		wheel.Schedule(100, periodic);
+		Jump(wheel, 1000);
+		TEST_ASSERT_EQUALS(fired.size(), 1);
+		Jump(wheel, 99);
+		TEST_ASSERT_EQUALS(fired.size(), 1);
+		Jump(wheel, 1);
+		TEST_ASSERT_EQUALS(fired.size(), 2);
+		TEST_ASSERT_EQUALS(fired[1], 1107);
+	}
+
+	void CancelInCallbackTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		int a = 0, b = 0, c = 0;
+		TimerWheel::TimerID id_a = 0, id_b = 0;
+
+		// a and b share a slot, whichever runs first cancels the other
+		id_a = wheel.Schedule(10, [&]() { a++; wheel.Cancel(id_b); TEST_ASSERT(!wheel.Cancel(id_a)); });
+		id_b = wheel.Schedule(10, [&]() { b++; wheel.Cancel(id_a); });
+		// and a timer further out is cancelled from a callback before it runs
+		auto id_c = wheel.Schedule(1000, [&]() { c++; });
+		wheel.Schedule(20, [&]() { TEST_ASSERT(wheel.Cancel(id_c)); });
+
+		Step(wheel, 2000);
+		TEST_ASSERT_EQUALS(a + b, 1);
+		TEST_ASSERT_EQUALS(c, 0);
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+	}
+
+	void CascadeTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		// one deadline landing in each level, plus ones sat on level boundaries
+		std::vector<uint32> delays = { 255, 256, 257, 300, 16383, 16384, 16385, 100000, 1048575, 1048576, 1048577, 5000000 };
+		std::vector<uint32> fired_at(delays.size(), 0);
+
+		for (size_t i = 0; i < delays.size(); ++i)
+			wheel.Schedule(delays[i], [&, i]() { fired_at[i] = now; });
+
+		// big uneven jumps, each timer must still run at its own time or the first Advance() after
+		uint32 jumps[] = { 100, 156, 1, 1, 16000, 4000, 500000, 1000000, 3500000 };
+		for (uint32 j : jumps) {
+			Jump(wheel, j);
+			for (size_t i = 0; i < delays.size(); ++i) {
+				bool due = delays[i] <= now;
+				TEST_ASSERT(due ? fired_at[i] >= delays[i] : fired_at[i] == 0);
+			}
+		}
+
+		// walked slot by slot, every timer runs exactly on its deadline
+		now = 0;
+		TimerWheel walked(Clock);
+		std::vector<uint32> walked_at(delays.size(), 0);
+		for (size_t i = 0; i < delays.size(); ++i)
+			walked.Schedule(delays[i], [&, i]() { walked_at[i] = now; });
+
+		Step(walked, 5000000);
+		for (size_t i = 0; i < delays.size(); ++i)
+			TEST_ASSERT_EQUALS(walked_at[i], delays[i]);
+	}
+
+	void FarFutureTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		// past the span of the top level, about 18.6 hours
+		uint32 far = (1u << 26) + 12345;
+		uint32 fired = 0;
+
+		auto id = wheel.Schedule(far, [&]() { fired = now; });
+		TEST_ASSERT_EQUALS(wheel.GetRemainingTime(id), far);
+
+		Jump(wheel, (1u << 26) - 1);
+		TEST_ASSERT_EQUALS(fired, 0);
+		TEST_ASSERT_EQUALS(wheel.GetRemainingTime(id), 12346);
+
+		Jump(wheel, 12345);
+		TEST_ASSERT_EQUALS(fired, 0);
+		Jump(wheel, 1);
+		TEST_ASSERT_EQUALS(fired, far);
+
+		// a delay close to the 32 bit limit is parked and still counts down right
+		now = 0;
+		TimerWheel parked(Clock);
+		bool ran = false;
+		auto id2 = parked.Schedule(0xF0000000, [&]() { ran = true; });
+		Jump(parked, 1u << 27);
+		TEST_ASSERT(!ran);
+		TEST_ASSERT_EQUALS(parked.GetRemainingTime(id2), 0xF0000000 - (1u << 27));
+		TEST_ASSERT(parked.Cancel(id2));
+	}
+
+	void ClockWrapTest() {
+		now = 0xFFFFFFFF - 100;
+		TimerWheel wheel(Clock);
+		uint32 fired = 0;
+
+		wheel.Schedule(200, [&]() { fired = now; });
+		Jump(wheel, 150);
+		TEST_ASSERT_EQUALS(fired, 0);
+		Jump(wheel, 50);
+		TEST_ASSERT_EQUALS(fired, 99);
+	}
+
+	void PolledTimerTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+
+		// like Timer(duration) it runs from construction
+		WheelTimer t(wheel, 100);
+		TEST_ASSERT(t.Enabled());
+		TEST_ASSERT(!t.Check());
+		Jump(wheel, 99);
+		TEST_ASSERT(!t.Check(false));
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 1);
+		Jump(wheel, 1);
+		TEST_ASSERT(t.Check(false));
+		TEST_ASSERT(t.Check(false));
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 0);
+		TEST_ASSERT(t.Check());
+		TEST_ASSERT(!t.Check());
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 100);
+
+		// Trigger() is due straight away, without waiting for Advance()
+		t.Trigger();
+		TEST_ASSERT(t.Check());
+
+		t.Disable();
+		TEST_ASSERT(!t.Enabled());
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 0xFFFFFFFF);
+		Jump(wheel, 1000);
+		TEST_ASSERT(!t.Check());
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+
+		// moving the interval keeps its start, the attack timers rely on it
+		t.Start(1000);
+		Jump(wheel, 400);
+		t.SetDuration(500, true);
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 100);
+		t.SetDuration(300, true);
+		TEST_ASSERT(t.Check(false));
+
+		WheelTimer off(wheel);
+		TEST_ASSERT(!off.Enabled());
+		TEST_ASSERT(!off.Check());
+	}
+
+	void KeepSynchronizedTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		WheelTimer t(wheel, 1000);
+
+		// checked 50ms late, the next period is shortened to make up for it
+		Jump(wheel, 1050);
+		TEST_ASSERT(t.CheckKeepSynchronized());
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 950);
+
+		// past the tolerance it just starts over
+		Jump(wheel, 950 + 500);
+		TEST_ASSERT(t.CheckKeepSynchronized());
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 1000);
+	}
+
+	void PauseTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		WheelTimer t(wheel, 1000);
+
+		Jump(wheel, 300);
+		t.Pause();
+		TEST_ASSERT(t.Paused());
+		TEST_ASSERT(!t.Enabled());
+		Jump(wheel, 5000);
+		TEST_ASSERT(!t.Check());
+
+		t.Resume();
+		TEST_ASSERT(!t.Paused());
+		TEST_ASSERT_EQUALS(t.GetRemainingTime(), 700);
+		Jump(wheel, 700);
+		TEST_ASSERT(t.Check());
+	}
+
+	void RepeatingTimerTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		std::vector<uint32> fired;
+		WheelTimer *self = nullptr;
+
+		WheelTimer t(wheel, 250, [&]() {
+			fired.push_back(now);
+			// already armed for the next period by the time it gets here
+			TEST_ASSERT(self->Enabled());
+			if (fired.size() == 3)
+				self->Disable();
+		}, true);
+		self = &t;
+
+		// a timer with a callback waits for its owner's Start()
+		Jump(wheel, 1000);
+		TEST_ASSERT(fired.empty());
+
+		t.Start();
+		Step(wheel, 2000);
+		TEST_ASSERT_EQUALS(fired.size(), 3);
+		TEST_ASSERT_EQUALS(fired[0], 1250);
+		TEST_ASSERT_EQUALS(fired[1], 1500);
+		TEST_ASSERT_EQUALS(fired[2], 1750);
+		TEST_ASSERT(!t.Enabled());
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+
+		// going out of scope takes its wheel entry with it
+		{
+			WheelTimer gone(wheel, 10, [&]() { fired.push_back(now); }, true);
+			gone.Start();
+			TEST_ASSERT_EQUALS(wheel.Size(), 1);
+		}
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+	}
+
+	void OneShotTimerTest() {
+		now = 0;
+		TimerWheel wheel(Clock);
+		int fired = 0;
+		WheelTimer *self = nullptr;
+
+		WheelTimer t(wheel, 100, [&]() {
+			fired++;
+			TEST_ASSERT(!self->Enabled());
+			// re-armed from its own callback it runs again, once
+			if (fired == 1)
+				self->Start(50);
+		});
+		self = &t;
+
+		t.Start();
+		Jump(wheel, 100);
+		TEST_ASSERT_EQUALS(fired, 1);
+		TEST_ASSERT(t.Enabled());
+		Jump(wheel, 50);
+		TEST_ASSERT_EQUALS(fired, 2);
+		TEST_ASSERT(!t.Enabled());
+
+		// a callback timer's Trigger() waits for the next Advance()
+		t.Trigger();
+		TEST_ASSERT_EQUALS(fired, 2);
+		Jump(wheel, 1);
+		TEST_ASSERT_EQUALS(fired, 3);
+	}
+};
+
+#endif
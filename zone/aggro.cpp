@@ -22,6 +22,7 @@
 #include "../common/rulesys.h"
 #include "../common/spdat.h"
 #include "../common/content/world_content_service.h"
+#include "../common/event/task_scheduler.h"
 
 #include "client.h"
 #include "corpse.h"
@@ -34,6 +35,73 @@
 extern Zone* zone;
 //#define LOSDEBUG 6
 
+namespace {
+	// an aggro scan MobProcess is going to run this tick
+	struct DecideScan {
+		Mob *scanner;
+		bool client;
+	};
+
+	struct DecideSight {
+		glm::vec3 from;
+		glm::vec3 to;
+		bool result;
+	};
+
+	std::unique_ptr<EQ::Event::TaskScheduler> decide_pool;
+	int decide_pool_size = 0;
+
+	// the range part of CheckWillAggro
+	inline bool InAggroRange(Mob *aggressor, Mob *other)
+	{
+		float range = aggressor->GetAggroRange();
+		if (std::abs(other->GetX() - aggressor->GetX()) > range ||
+			std::abs(other->GetY() - aggressor->GetY()) > range ||
+			std::abs(other->GetZ() - aggressor->GetZ()) > range)
+			return false;
+
+		return DistanceSquared(other->GetPosition(), aggressor->GetPosition()) <= range * range;
+	}
+
+	// Runs on the decide workers. Only reads entities, the grids, the los cache
+	// and the zone map, the zone thread is waiting on them the whole time.
+	// Pets are dropped by their grid flag without touching them; a flag a tick
+	// out of date only costs a trace the scan then does itself.
+	void DecideSights(const EntityList &list, const std::vector<DecideScan> &scans, size_t first, size_t last, float max_range, std::vector<DecideSight> &out)
+	{
+		for (size_t i = first; i < last; ++i) {
+			if (scans[i].client) {
+				Client *around = scans[i].scanner->CastToClient();
+				glm::vec3 to(around->GetX(), around->GetY(), around->GetZ());
+
+				// same pairs CheckClientAggro hands to CheckWillAggro
+				list.ForEachNonPetNPCInRange(around->GetPosition(), max_range, [&](NPC *npc) {
+					if (npc->IsPet() || npc->IsMezzed() || !InAggroRange(npc, around) || npc->CheckAggro(around))
+						return;
+
+					glm::vec3 from(npc->GetX(), npc->GetY(), npc->GetZ());
+					if (!zone->los_cache.Contains(from, to))
+						out.push_back({ from, to, zone->zonemap->CheckLoS(from, to) });
+				});
+			}
+			else {
+				NPC *aggressor = scans[i].scanner->CastToNPC();
+				glm::vec3 from(aggressor->GetX(), aggressor->GetY(), aggressor->GetZ());
+
+				// same pairs AICheckNPCAggro hands to CheckWillAggro
+				list.ForEachNonPetNPCInRange(aggressor->GetPosition(), aggressor->GetAggroRange(), [&](NPC *npc) {
+					if (npc == aggressor || npc->IsPet() || !aggressor->CanFactionAggroNPC(npc) || !InAggroRange(aggressor, npc) || aggressor->CheckAggro(npc))
+						return;
+
+					glm::vec3 to(npc->GetX(), npc->GetY(), npc->GetZ());
+					if (!zone->los_cache.Contains(from, to))
+						out.push_back({ from, to, zone->zonemap->CheckLoS(from, to) });
+				});
+			}
+		}
+	}
+}
+
 // Iterate NPCs to look for something to attack the client
 // If a should-be-aggro NPC is found, we have it check for all targets in range
 // so they all get on the hate list simultaneously.  Sony seems to have NPCs look for clients.
@@ -57,6 +125,82 @@ void EntityList::CheckClientAggro(Client *around)
 	}
 }
 
+// proximity aggro NPCs keep looking for NPCs to attack while engaged
+static bool HasNPCProximityAggro(NPC *aggressor)
+{
+	bool proxAggro = aggressor->GetSpecialAbility(SpecialAbility::ProximityAggro);
+	bool proxAggro2 = aggressor->GetSpecialAbility(SpecialAbility::ProximityAggro2);
+	if (!RuleB(Quarm, EnableNPCProximityAggroSystem) && !aggressor->HasEngageNotice() && proxAggro)
+		proxAggro = false;
+	if(proxAggro2)
+		proxAggro = true;
+	return proxAggro;
+}
+
+// Decide phase for the aggro scans that come due inside MobProcess this tick.
+// Their line of sight traces, the expensive part, run up front on worker threads
+// and go into the los cache. The scans themselves still run in order on the zone
+// thread and find the answers waiting. Nothing here changes a mob or rolls the
+// zone's random, so the scans decide exactly what they would have anyway.
+void EntityList::AIDecideProcess()
+{
+	int workers = RuleI(Aggro, DecideWorkers);
+	if (workers != decide_pool_size) {
+		decide_pool.reset();
+		if (workers > 0)
+			decide_pool = std::make_unique<EQ::Event::TaskScheduler>(workers);
+		decide_pool_size = workers;
+	}
+
+	if (!decide_pool || !zone || !zone->zonemap || zone->SkipLoS() || !RuleB(Map, LoSCacheEnabled) || !zone->zonemap->SupportsConcurrentLoS())
+		return;
+
+	std::vector<DecideScan> scans;
+	float max_range = 0.0f;
+	bool npc_scans = !zone->IsIdling();
+
+	for (auto &e : npc_list) {
+		NPC *npc = e.second;
+		max_range = std::max(max_range, npc->GetAggroRange());
+		// same early outs as AICheckNPCAggro, an engaged NPC with a target only scans with proximity aggro
+		if (npc_scans && npc->IsAIScanAreaDue() && npc->GetNPCAggro() && npc->CanFactionAggroAnyNPC() &&
+			(!npc->IsEngaged() || !npc->GetTarget() || HasNPCProximityAggro(npc)))
+			scans.push_back({ npc, false });
+	}
+
+	for (auto &e : client_list) {
+		Client *c = e.second;
+		if (c->ClientDataLoaded() && c->IsAggroScanDue() && c->ClientFinishedLoading() && c->Connected() && !c->IsBecomeNPC() && !c->GetGM())
+			scans.push_back({ c, true });
+	}
+
+	if (scans.empty())
+		return;
+
+	// more chunks than workers keeps them all busy when some scans cost more
+	size_t chunks = std::min(scans.size(), static_cast<size_t>(workers) * 4);
+	std::vector<std::vector<DecideSight>> sights(chunks);
+	std::vector<std::future<void>> done;
+	done.reserve(chunks);
+
+	for (size_t i = 0; i < chunks; ++i) {
+		size_t first = scans.size() * i / chunks;
+		size_t last = scans.size() * (i + 1) / chunks;
+		done.push_back(decide_pool->Enqueue([this, &scans, &sights, first, last, i, max_range]() {
+			DecideSights(*this, scans, first, last, max_range, sights[i]);
+		}));
+	}
+
+	for (auto &f : done)
+		f.get();
+
+	// stored in scan order, the cache comes out the same however the work was split
+	for (auto &chunk : sights) {
+		for (auto &s : chunk)
+			zone->los_cache.Store(s.from, s.to, s.result);
+	}
+}
+
 void EntityList::CheckCorpseDragAggro(Client *around)
 {
 	for (auto it = npc_list.begin(); it != npc_list.end(); ++it)
@@ -619,9 +763,13 @@ bool EntityList::AICheckClientAggro(NPC* aggressor)
 	if (proxAggro && aggressor->GetTarget())
 		tankDist = DistanceSquared(aggressor->GetPosition(), aggressor->GetTarget()->GetPosition());
 
-	for (auto it = client_list.begin(); it != client_list.end(); ++it)
+	// CheckWillAggro() never accepts anything outside of aggro range
+	std::vector<Client *> candidates;
+	ForEachClientInRange(aggressor->GetPosition(), aggressor->GetAggroRange(), [&candidates](Client *c) { candidates.push_back(c); });
+
+	for (auto it = candidates.begin(); it != candidates.end(); ++it)
 	{
-		Client *client = it->second;
+		Client *client = *it;
 
 		if ((client->IsFeigned() && !aggressor->GetSpecialAbility(SpecialAbility::FeignDeathImmunity)) || !client->InZone() || client->IsMule())
 			continue;
@@ -645,29 +793,35 @@ bool EntityList::AICheckNPCAggro(NPC* aggressor)
 	if (!aggressor)
 		return false;
 
-	bool proxAggro = aggressor->GetSpecialAbility(SpecialAbility::ProximityAggro);
-	bool proxAggro2 = aggressor->GetSpecialAbility(SpecialAbility::ProximityAggro2);
-	if (!RuleB(Quarm, EnableNPCProximityAggroSystem) && !aggressor->HasEngageNotice() && proxAggro)
-		proxAggro = false;
-	if(proxAggro2)
-		proxAggro = true;
+	bool proxAggro = HasNPCProximityAggro(aggressor);
 	bool engaged = aggressor->IsEngaged();
 	bool found = false;
 
 	if (!aggressor->GetNPCAggro() || (engaged && aggressor->GetTarget() && !proxAggro))
 		return false;
 
+	// nothing in the zone can be on our side of the faction matrix
+	if (!aggressor->CanFactionAggroAnyNPC())
+		return false;
+
 	float tankDist = 0.0f;
 	if (proxAggro && aggressor->GetTarget())
 		tankDist = DistanceSquared(aggressor->GetPosition(), aggressor->GetTarget()->GetPosition());
 
-	for (auto it = npc_list.begin(); it != npc_list.end(); ++it)
+	std::vector<NPC *> candidates;
+	ForEachNPCInRange(aggressor->GetPosition(), aggressor->GetAggroRange(), [&candidates](NPC *n) { candidates.push_back(n); });
+
+	for (auto it = candidates.begin(); it != candidates.end(); ++it)
 	{
-		NPC *npc = it->second;
+		NPC *npc = *it;
 
 		if (npc->IsPet())
 			continue;
 
+		// impossible faction pairs skip the range, invis and LOS work entirely
+		if (!aggressor->CanFactionAggroNPC(npc))
+			continue;
+
 		if (!aggressor->CheckAggro(npc) && aggressor->CheckWillAggro(npc))
 		{
 			if (!engaged || !aggressor->GetTarget()
@@ -700,9 +854,12 @@ bool EntityList::AICheckPetAggro(NPC* aggressor)
 	if (engaged && !proxAggro)
 		return false;
 
-	for (auto it = npc_list.begin(); it != npc_list.end(); ++it)
+	std::vector<NPC *> candidates;
+	ForEachNPCInRange(aggressor->GetPosition(), aggressor->GetAggroRange(), [&candidates](NPC *n) { candidates.push_back(n); });
+
+	for (auto it = candidates.begin(); it != candidates.end(); ++it)
 	{
-		NPC *npc = it->second;
+		NPC *npc = *it;
 
 		if (!npc->IsCharmedPet())
 			continue;
@@ -1436,12 +1593,8 @@ bool Mob::CheckRegion(Mob* other, bool skipwater) {
 			return true;
 	}
 
-	WaterRegionType ThisRegionType;
-	WaterRegionType OtherRegionType;
-	auto position = glm::vec3(GetX(), GetY(), GetZ());
-	auto other_position = glm::vec3(other->GetX(), other->GetY(), other->GetZ());
-	ThisRegionType = zone->watermap->ReturnRegionType(position);
-	OtherRegionType = zone->watermap->ReturnRegionType(other_position);
+	WaterRegionType ThisRegionType = GetWaterRegionType();
+	WaterRegionType OtherRegionType = other->GetWaterRegionType();
 
 	Log(Logs::Detail, Logs::Maps, "Caster Region: %d Other Region: %d", ThisRegionType, OtherRegionType);
 
@@ -1494,7 +1647,68 @@ bool Mob::CheckLosFN(float posX, float posY, float posZ, float mobSize, Mob* oth
 	}
 
 	Log(Logs::Detail, Logs::Maps, "LOS from (%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f) sizes: (%.2f, %.2f)", myloc.x, myloc.y, myloc.z, oloc.x, oloc.y, oloc.z, GetSize(), mobSize);
-	return zone->zonemap->CheckLoS(myloc, oloc);
+
+	if (!RuleB(Map, LoSCacheEnabled))
+		return zone->zonemap->CheckLoS(myloc, oloc);
+
+	bool result = false;
+	if (zone->los_cache.Lookup(myloc, oloc, result))
+		return result;
+
+	result = zone->zonemap->CheckLoS(myloc, oloc);
+	zone->los_cache.Store(myloc, oloc, result);
+	return result;
+}
+
+void Mob::CheckLosFNBatch(const std::vector<Mob*> &others, std::vector<uint8> &results, bool spell_casting) {
+	results.assign(others.size(), 0);
+	if (others.empty())
+		return;
+
+	glm::vec3 myloc(GetX(), GetY(), GetZ());
+	if (IsClient() && (GetRace() == Race::Dwarf || GetRace() == Race::Gnome || GetRace() == Race::Halfling))
+		myloc.z += 1.0f;
+
+	if (zone->zonemap == nullptr) {
+#ifdef LOS_DEFAULT_CAN_SEE
+		results.assign(others.size(), 1);
+#endif
+		SetLastLosState(results.back() != 0);
+		return;
+	}
+
+	bool use_cache = RuleB(Map, LoSCacheEnabled);
+	std::vector<size_t> pending;
+	std::vector<glm::vec3> olocs;
+	pending.reserve(others.size());
+	olocs.reserve(others.size());
+
+	for (size_t i = 0; i < others.size(); ++i) {
+		if (!others[i])
+			continue;
+
+		glm::vec3 oloc(others[i]->GetX(), others[i]->GetY(), others[i]->GetZ());
+		bool result = false;
+		if (use_cache && zone->los_cache.Lookup(myloc, oloc, result)) {
+			results[i] = result;
+			continue;
+		}
+
+		pending.push_back(i);
+		olocs.push_back(oloc);
+	}
+
+	if (!pending.empty()) {
+		std::unique_ptr<bool[]> traced(new bool[pending.size()]);
+		zone->zonemap->CheckLoSBatch(myloc, olocs.data(), olocs.size(), traced.get());
+		for (size_t j = 0; j < pending.size(); ++j) {
+			results[pending[j]] = traced[j];
+			if (use_cache)
+				zone->los_cache.Store(myloc, olocs[j], traced[j]);
+		}
+	}
+
+	SetLastLosState(results.back() != 0);
 }
 
 //offensive spell aggro
@@ -30,9 +30,12 @@
 #include "object.h"
 #include "zone.h"
 #include "doors.h"
+#include "quest_parser_collection.h"
+#include "tick_profiler.h"
 #include <iostream>
 
 extern Zone *zone;
+extern TickProfiler tick_profiler;
 
 EQ::Net::WebsocketLoginStatus CheckLogin(EQ::Net::WebsocketServerConnection *connection, const std::string &username, const std::string &password) {
 	EQ::Net::WebsocketLoginStatus ret;
@@ -764,6 +767,85 @@ Json::Value ApiGetZoneAttributes(EQ::Net::WebsocketServerConnection *connection,
 	return response;
 }
 
+Json::Value ApiGetLosCacheStats(EQ::Net::WebsocketServerConnection *connection, Json::Value params) {
+	if (zone->GetZoneID() == 0) {
+		throw EQ::Net::WebsocketException("Zone must be loaded to invoke this call");
+	}
+
+	Json::Value response;
+	Json::Value row;
+
+	const auto &s = zone->los_cache.GetStats();
+
+	row["enabled"]       = RuleB(Map, LoSCacheEnabled);
+	row["entries"]       = static_cast<Json::UInt64>(zone->los_cache.Size());
+	row["hits"]          = static_cast<Json::UInt64>(s.hits);
+	row["misses"]        = static_cast<Json::UInt64>(s.misses);
+	row["expired"]       = static_cast<Json::UInt64>(s.expired);
+	row["invalidations"] = static_cast<Json::UInt64>(s.invalidations);
+
+	response.append(row);
+	return response;
+}
+
+Json::Value ApiTickStats(const TickProfiler::Stats &s) {
+	Json::Value row;
+	Json::Value histogram;
+
+	row["count"]            = static_cast<Json::UInt64>(s.count);
+	row["total_us"]         = static_cast<Json::UInt64>(s.total_us);
+	row["avg_us"]           = static_cast<Json::UInt64>(s.count ? s.total_us / s.count : 0);
+	row["max_us"]           = static_cast<Json::UInt64>(s.max_us);
+	row["overrun_us"]       = static_cast<Json::UInt64>(s.overrun_us);
+	row["worst_in_overrun"] = static_cast<Json::UInt64>(s.worst_in_overrun);
+
+	for (int i = 0; i < TickProfiler::Buckets; i++) {
+		histogram.append(static_cast<Json::UInt64>(s.histogram[i]));
+	}
+	row["histogram"] = histogram;
+
+	return row;
+}
+
+// params[0], when true, clears the profile after it is read
+Json::Value ApiGetTickProfile(EQ::Net::WebsocketServerConnection *connection, Json::Value params) {
+	Json::Value response;
+	Json::Value limits;
+	Json::Value phases;
+	uint64      quest_events;
+	uint64      quest_event_alloc_bytes;
+
+	parse->GetEventAllocStats(quest_events, quest_event_alloc_bytes);
+
+	for (int i = 0; i < TickProfiler::Buckets; i++) {
+		limits.append(static_cast<Json::UInt64>(TickProfiler::GetBucketLimit(i)));
+	}
+
+	for (int i = 0; i < static_cast<int>(TickPhase::Count); i++) {
+		auto phase = static_cast<TickPhase>(i);
+		Json::Value row = ApiTickStats(tick_profiler.GetPhaseStats(phase));
+		row["phase"] = TickProfiler::GetPhaseName(phase);
+		phases.append(row);
+	}
+
+	response["budget_ms"]         = tick_profiler.GetBudget();
+	response["elapsed_ms"]        = static_cast<Json::UInt64>(tick_profiler.GetElapsedMs());
+	response["overruns"]          = static_cast<Json::UInt64>(tick_profiler.GetOverruns());
+	response["last_tick_us"]      = static_cast<Json::UInt64>(tick_profiler.GetLastTickUs());
+	response["quest_heap_kb"]     = static_cast<Json::UInt64>(parse->GetHeapKB());
+	response["quest_events"]      = static_cast<Json::UInt64>(quest_events);
+	response["quest_event_bytes"] = static_cast<Json::UInt64>(quest_event_alloc_bytes);
+	response["bucket_upper_us"]   = limits;
+	response["tick"]              = ApiTickStats(tick_profiler.GetTickStats());
+	response["phases"]            = phases;
+
+	if (params.isArray() && params.size() > 0 && params[0].asBool()) {
+		tick_profiler.Reset();
+	}
+
+	return response;
+}
+
 Json::Value ApiGetLogsysCategories(EQ::Net::WebsocketServerConnection* connection, Json::Value params)
 {
 	if (!zone || (zone && zone->GetZoneID() == 0)) {
@@ -845,6 +927,8 @@ void RegisterApiService(std::unique_ptr<EQ::Net::WebsocketServer> &server) {
 	server->SetMethodHandler("get_mob_list_detail", &ApiGetMobListDetail, 50);
 	server->SetMethodHandler("get_client_list_detail", &ApiGetClientListDetail, 50);
 	server->SetMethodHandler("get_zone_attributes", &ApiGetZoneAttributes, 50);
+	server->SetMethodHandler("get_los_cache_stats", &ApiGetLosCacheStats, 50);
+	server->SetMethodHandler("get_tick_profile", &ApiGetTickProfile, 50);
 
 	RegisterApiLogEvent(server);
 }
\ No newline at end of file
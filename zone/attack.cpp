@@ -2570,7 +2570,7 @@ void Mob::AddToHateList(Mob* other, int32 hate, int32 damage, bool bFrenzy, bool
 	}
 
 	if(IsNPC() && CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
-		bool in_liquid = zone->watermap->InLiquid(glm::vec3(other->GetPosition())) || zone->IsWaterZone(other->GetZ());
+		bool in_liquid = other->InLiquidRegion() || zone->IsWaterZone(other->GetZ());
 		if(!in_liquid) {
 			return;
 		}
@@ -4386,7 +4386,7 @@ void Client::SetAttackTimer(bool trigger)
 	//an invalid weapon equipped:
 	attack_timer.SetDuration(4000, true);
 
-	Timer *TimerToUse = nullptr;
+	WheelTimer *TimerToUse = nullptr;
 	const EQ::ItemData *PrimaryWeapon = nullptr;
 
 	for (int i = EQ::invslot::slotRange; i <= EQ::invslot::slotSecondary; i++) {
@@ -4483,7 +4483,7 @@ void NPC::SetAttackTimer(bool trigger)
 	//an invalid weapon equipped:
 	attack_timer.SetDuration(3000, true);
 
-	Timer *TimerToUse = nullptr;
+	WheelTimer *TimerToUse = nullptr;
 
 	for (int i = EQ::invslot::slotRange; i <= EQ::invslot::slotSecondary; i++)
 	{
@@ -62,8 +62,11 @@ void Client::CalcBonuses()
 	if (has_zomm)
 		return;
 
-	memset(&itembonuses, 0, sizeof(StatBonuses));
-	CalcItemBonuses(&itembonuses);
+	UpdateBonusCache();
+
+	// edibles are found by walking the general slots, they aren't part of the cache
+	itembonuses = bonus_cache.items;
+	item_faction_bonuses = bonus_cache.item_factions;
 	CalcEdibleBonuses(&itembonuses);
 
 	CalcSpellBonuses(&spellbonuses);
@@ -79,7 +82,7 @@ void Client::CalcBonuses()
 			itembonuses.ATK = RuleI(Character, ItemATKCap);
 	}
 
-	CalcAABonuses(&aabonuses);
+	aabonuses = bonus_cache.aa;
 
 	RecalcWeight();
 
@@ -109,6 +112,85 @@ void Client::CalcBonuses()
 	rooted = FindType(SE_Root);
 }
 
+namespace {
+	inline void MixKey(uint64 &key, uint64 value)
+	{
+		key ^= value + 0x9E3779B97F4A7C15ull + (key << 6) + (key >> 2);
+	}
+}
+
+uint64 Client::GetAABonusKey()
+{
+	// the item key starts from this one, so the epoch covers both layers
+	uint64 key = GetLevel();
+	MixKey(key, GetClass());
+	MixKey(key, zone ? zone->GetBonusCacheEpoch() : 0);
+
+	for (int i = 0; i < MAX_PP_AA_ARRAY; i++) {
+		if (aa[i] && (aa[i]->AA > 0 || aa[i]->value > 0))
+			MixKey(key, (static_cast<uint64>(i) << 48) | (static_cast<uint64>(aa[i]->AA) << 16) | aa[i]->value);
+	}
+
+	return key;
+}
+
+uint64 Client::GetItemBonusKey(uint64 aa_key)
+{
+	// CalcItemBonuses checks the AAs for 2h bash
+	uint64 key = aa_key;
+	MixKey(key, GetBaseRace());
+	MixKey(key, Admin());
+	MixKey(key, RuleI(Character, ItemATKCap));
+	MixKey(key, RuleI(Character, ItemManaRegenCap));
+
+	for (int i = EQ::invslot::slotEar1; i < EQ::invslot::slotAmmo; i++) {
+		const EQ::ItemInstance *inst = m_inv[i];
+		MixKey(key, reinterpret_cast<uintptr_t>(inst));
+		if (inst)
+			MixKey(key, (static_cast<uint64>(inst->GetID()) << 16) | static_cast<uint16>(inst->GetCharges()));
+	}
+
+	return key;
+}
+
+void Client::UpdateBonusCache()
+{
+	uint64 aa_key = GetAABonusKey();
+	uint64 item_key = GetItemBonusKey(aa_key);
+
+	if (!bonus_cache.items_valid || bonus_cache.item_key != item_key) {
+		memset(&bonus_cache.items, 0, sizeof(StatBonuses));
+		CalcItemBonuses(&bonus_cache.items);
+		bonus_cache.item_factions = item_faction_bonuses;
+		bonus_cache.item_key = item_key;
+		bonus_cache.items_valid = true;
+	}
+	else if (RuleB(Character, VerifyBonusCache)) {
+		StatBonuses full;
+		memset(&full, 0, sizeof(StatBonuses));
+		CalcItemBonuses(&full);
+		if (memcmp(&full, &bonus_cache.items, sizeof(StatBonuses)) != 0 || item_faction_bonuses != bonus_cache.item_factions) {
+			LogError("Cached item bonuses for [{}] differ from a full recompute, using the recompute", GetName());
+			bonus_cache.items = full;
+			bonus_cache.item_factions = item_faction_bonuses;
+		}
+	}
+
+	if (!bonus_cache.aa_valid || bonus_cache.aa_key != aa_key) {
+		CalcAABonuses(&bonus_cache.aa);
+		bonus_cache.aa_key = aa_key;
+		bonus_cache.aa_valid = true;
+	}
+	else if (RuleB(Character, VerifyBonusCache)) {
+		StatBonuses full;
+		CalcAABonuses(&full);
+		if (memcmp(&full, &bonus_cache.aa, sizeof(StatBonuses)) != 0) {
+			LogError("Cached AA bonuses for [{}] differ from a full recompute, using the recompute", GetName());
+			bonus_cache.aa = full;
+		}
+	}
+}
+
 void Mob::CalcSpellBonuses()
 {
 	if (IsClient() && CastToClient()->has_zomm)
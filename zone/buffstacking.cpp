@@ -1351,6 +1351,7 @@ bool Mob::AssignBuffSlot(Mob *caster, uint16 spell_id, int &buffslot, int &caste
 
 	int extraTick = 1;  // all buffs get an extra tick
 	buffs[emptyslot].spellid = spell_id;
+	IndexBuffEffects(spell_id);
 	buffs[emptyslot].casterlevel = caster_level;
 	buffs[emptyslot].realcasterlevel = caster ? caster->GetLevel() : caster_level;
 	if (caster && caster->IsClient())
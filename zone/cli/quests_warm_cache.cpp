@@ -0,0 +1,105 @@
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <vector>
+#include <fmt/format.h>
+
+#include "../../common/path_manager.h"
+#ifdef LUA_EQEMU
+#include "lua.hpp"
+#include "../lua_script_cache.h"
+#endif
+
+void ZoneCLI::QuestsWarmCache(int argc, char** argv, argh::parser& cmd, std::string& description)
+{
+	description = "Compiles Lua quest scripts into the bytecode cache, [--zone=short_name] for one zone";
+
+	if (cmd[{"-h", "--help"}]) {
+		return;
+	}
+
+#ifdef LUA_EQEMU
+	namespace fs = std::filesystem;
+
+	std::string only_zone = cmd("--zone").str();
+
+	// quests/<zone or global>/... grouped by the directory directly under quests
+	std::map<std::string, std::vector<std::string>> scripts;
+	std::error_code ec;
+	for (const auto& dir : fs::directory_iterator(path.GetQuestsPath(), ec)) {
+		std::string name = dir.path().filename().string();
+		if (!dir.is_directory() || (!only_zone.empty() && name != only_zone)) {
+			continue;
+		}
+
+		for (const auto& file : fs::recursive_directory_iterator(dir.path(), ec)) {
+			if (file.is_regular_file() && file.path().extension() == ".lua") {
+				scripts[name].push_back(file.path().string());
+			}
+		}
+	}
+
+	if (scripts.empty()) {
+		std::cout << fmt::format("No Lua scripts found under [{}]", path.GetQuestsPath()) << std::endl;
+		return;
+	}
+
+	// compiling doesn't run anything, a bare state is enough
+	lua_State* L = luaL_newstate();
+
+	uint32 total = 0;
+	uint32 total_failed = 0;
+	auto   total_start = std::chrono::steady_clock::now();
+
+	for (const auto& zone_scripts : scripts) {
+		uint32 cached = 0;
+		uint32 compiled = 0;
+		uint32 failed = 0;
+		auto   start = std::chrono::steady_clock::now();
+
+		for (const auto& filename : zone_scripts.second) {
+			switch (LuaScriptCache::LoadFile(L, filename)) {
+				case LuaScriptCache::Cached:
+					cached++;
+					break;
+				case LuaScriptCache::Compiled:
+					compiled++;
+					break;
+				default:
+					failed++;
+					std::cout << fmt::format("  {}", lua_tostring(L, -1)) << std::endl;
+					break;
+			}
+			lua_pop(L, 1);
+		}
+
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		std::cout << fmt::format(
+			"[{}] {} scripts, {} compiled, {} already cached, {} failed in {} ms",
+			zone_scripts.first,
+			zone_scripts.second.size(),
+			compiled,
+			cached,
+			failed,
+			ms
+		) << std::endl;
+
+		total += zone_scripts.second.size();
+		total_failed += failed;
+	}
+
+	lua_close(L);
+
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - total_start).count();
+	std::cout << fmt::format(
+		"Warmed [{}] scripts across [{}] directories into [{}] in {} ms, [{}] failed",
+		total,
+		scripts.size(),
+		LuaScriptCache::GetCacheDirectory(),
+		ms,
+		total_failed
+	) << std::endl;
+#else
+	std::cout << "Zone was built without Lua support" << std::endl;
+#endif
+}
@@ -67,6 +67,7 @@ extern volatile bool is_zone_loaded;
 extern WorldServer worldserver;
 extern uint32 numclients;
 extern PetitionList petition_list;
+extern TimerWheel timer_wheel;
 bool commandlogged;
 char entirecommand[255];
 
@@ -125,9 +126,9 @@ Client::Client(EQStreamInterface* ieqs) : Mob(
 	0   // chest texture
 	),
 	//these must be listed in the order they appear in client.h
-	position_timer(250),
+	position_timer(timer_wheel, 250, [this]() { OnPositionTimer(); }, true),
 	get_auth_timer(5000),
-	hpupdate_timer(6000),
+	hpupdate_timer(timer_wheel, 6000, [this]() { OnHPUpdateTimer(); }, true),
 	camp_timer(35000),
 	process_timer(100),
 	stamina_timer(46000),
@@ -151,9 +152,11 @@ Client::Client(EQStreamInterface* ieqs) : Mob(
 	helm_toggle_timer(250),
 	trade_timer(3000),
 	door_check_timer(1000),
-	mend_reset_timer(60000),
+	mend_reset_timer(timer_wheel, 60000, [this]() { ResetSkill(EQ::skills::SkillMend); }),
+	disc_ability_timer(timer_wheel, 0, [this]() { OnDiscAbilityTimer(); }),
+	apperance_timer(timer_wheel, 0, []() { }), // only read through Enabled(), so it just lapses
 	underwater_timer(1000),
-	zoning_timer(5000),
+	zoning_timer(timer_wheel, 5000, [this]() { zone_mode = ZoneUnsolicited; }),
 	instance_boot_grace_timer(RuleI(Quarm, ClientInstanceBootGraceMS)),
 	m_Proximity(FLT_MAX, FLT_MAX, FLT_MAX), //arbitrary large number
 	m_ZoneSummonLocation(-2.0f,-2.0f,-2.0f,-2.0f),
@@ -229,6 +232,8 @@ Client::Client(EQStreamInterface* ieqs) : Mob(
 	mend_reset_timer.Disable();
 	zoning_timer.Disable();
 	instance_boot_grace_timer.Disable();
+	tic_timer.Start();
+	mana_timer.Start();
 	instalog = false;
 	m_pp.autosplit = false;
 	// initialise haste variable
@@ -346,6 +351,8 @@ Client::Client(EQStreamInterface* ieqs) : Mob(
 	camping = false;
 	camp_desktop = false;
 	food_hp = 0;
+	bonus_cache.items_valid = false;
+	bonus_cache.aa_valid = false;
 	drink_hp = 0;
 	poison_spell_id = 0;
 	drowning = false;
@@ -991,6 +998,23 @@ bool Client::AddPacket(EQApplicationPacket** pApp, bool bAckreq) {
 	return true;
 }
 
+//shares pApp with whoever else is holding it, no copy is made.
+bool Client::AddPacket(const EQSharedPacket &pApp, bool bAckreq) {
+	if (!pApp)
+		return false;
+	if(!zoneinpacket_timer.Enabled()) {
+		//drop the packet because it will never get sent.
+		return(false);
+	}
+	auto c = new CLIENTPACKET;
+
+	c->ack_req = bAckreq;
+	c->shared = pApp;
+
+	clientpackets.push_back(c);
+	return true;
+}
+
 bool Client::SendAllPackets() {
 	std::deque<CLIENTPACKET*>::iterator iterator;
 	if (clientpackets.size() == 0)
@@ -999,8 +1023,12 @@ bool Client::SendAllPackets() {
 	iterator = clientpackets.begin();
 	while(iterator != clientpackets.end()) {
 		cp = (*iterator);
-		if(eqs)
-			eqs->FastQueuePacket((EQApplicationPacket **)&cp->app, cp->ack_req);
+		if(eqs) {
+			if (cp->app)
+				eqs->FastQueuePacket((EQApplicationPacket **)&cp->app, cp->ack_req);
+			else if (cp->shared)
+				eqs->QueuePacket(cp->shared.get(), cp->ack_req);
+		}
 		iterator = clientpackets.erase(iterator);
 		safe_delete(cp);
 		Log(Logs::Detail, Logs::PacketServerClient, "Transmitting a packet");
@@ -1009,38 +1037,65 @@ bool Client::SendAllPackets() {
 }
 
 void Client::QueuePacket(const EQApplicationPacket* app, bool ack_req, CLIENT_CONN_STATUS required_state, eqFilterType filter) {
+	switch (GetQueueAction(required_state, filter)) {
+	case QueueSave:
+		AddPacket(app, ack_req);
+		break;
+	case QueueSend:
+		if(eqs)
+			eqs->QueuePacket(app, ack_req);
+		break;
+	default:
+		break;
+	}
+}
+
+// Same as above, but the patch encode is shared with every other client the packet goes to,
+// and clients that have to hold on to it share one copy of the emu packet.
+void Client::QueuePacket(EQBroadcastPacket &bp, bool ack_req, CLIENT_CONN_STATUS required_state, eqFilterType filter) {
+	switch (GetQueueAction(required_state, filter)) {
+	case QueueSave:
+		AddPacket(bp.GetSharedPacket(), ack_req);
+		break;
+	case QueueSend:
+		if(eqs)
+			bp.QueueTo(eqs, ack_req);
+		break;
+	default:
+		break;
+	}
+}
+
+Client::QueueAction Client::GetQueueAction(CLIENT_CONN_STATUS required_state, eqFilterType filter) {
 	if(filter!=FilterNone){
 		//this is incomplete... no support for FilterShowGroupOnly or FilterShowSelfOnly
 		if(GetFilter(filter) == FilterHide)
-			return; //Client has this filter on, no need to send packet
+			return QueueDrop; //Client has this filter on, no need to send packet
 	}
 
 	if(client_state == PREDISCONNECTED)
-		return;
+		return QueueDrop;
 
 	if(client_state != CLIENT_CONNECTED && required_state == CLIENT_CONNECTED){
 		// save packets during connection state
-		AddPacket(app, ack_req);
-		return;
+		return QueueSave;
 	}
 
 	//Wait for the queue to catch up - THEN send the first available predisconnected (zonechange) packet!
 	if (client_state == ZONING && required_state != ZONING)
 	{
 		// save packets in case this fails
-		AddPacket(app, ack_req);
-		return;
+		return QueueSave;
 	}
 
 	// if the program doesnt care about the status or if the status isnt what we requested
 	if (required_state != CLIENT_CONNECTINGALL && client_state != required_state)
 	{
 		// todo: save packets for later use
-		AddPacket(app, ack_req);
+		return QueueSave;
 	}
-	else
-		if(eqs)
-			eqs->QueuePacket(app, ack_req);
+
+	return QueueSend;
 }
 
 void Client::FastQueuePacket(EQApplicationPacket** app, bool ack_req, CLIENT_CONN_STATUS required_state) {
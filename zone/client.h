@@ -31,12 +31,14 @@ class ServerPacket;
 struct ItemData;
 
 #include "../common/timer.h"
+#include "../common/timer_wheel.h"
 #include "../common/ptimer.h"
 #include "../common/emu_opcodes.h"
 #include "../common/eq_packet_structs.h"
 #include "../common/emu_constants.h" // inv2 watch
 #include "../common/eq_stream_intf.h"
 #include "../common/eq_packet.h"
+#include "../common/eq_broadcast_packet.h"
 #include "../common/linked_list.h"
 #include "../common/extprofile.h"
 #include "../common/races.h"
@@ -87,6 +89,7 @@ public:
 	CLIENTPACKET();
 	~CLIENTPACKET();
 	EQApplicationPacket *app;
+	EQSharedPacket shared;	// set instead of app when the packet is shared with other clients
 	bool ack_req;
 };
 
@@ -362,6 +365,7 @@ public:
 	virtual bool Process();
 	void LogMerchant(Client* player, Mob* merchant, uint32 quantity, uint32 price, const EQ::ItemData* item, bool buying);
 	void QueuePacket(const EQApplicationPacket* app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
+	void QueuePacket(EQBroadcastPacket &bp, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
 	void FastQueuePacket(EQApplicationPacket** app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL);
 	void ChannelMessageReceived(uint8 chan_num, uint8 language, uint8 lang_skill, const char* orig_message, const char* targetname=nullptr);
 	void ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, uint8 lang_skill, const char* message, ...);
@@ -387,6 +391,7 @@ public:
 	bool SaveAA();
 
 	inline bool ClientDataLoaded() const { return client_data_loaded; }
+	inline bool IsAggroScanDue() const { return m_client_npc_aggro_scan_timer.GetRemainingTime() == 0; }
 	inline bool Connected() const { return (client_state == CLIENT_CONNECTED); }
 	inline bool InZone() const { return (client_state == CLIENT_CONNECTED || client_state == CLIENT_LINKDEAD); }
 	inline void Kick() { client_state = CLIENT_KICKED; }
@@ -812,6 +817,11 @@ public:
 	bool TGB() const { return tgb; }
 
 	void OnDisconnect(bool hard_disconnect);
+	void OnDiscAbilityTimer();
+	virtual void OnTicTimer();
+	virtual void OnManaTimer();
+	void OnHPUpdateTimer();
+	void OnPositionTimer();
 
 	uint16 GetSkillPoints() { return m_pp.points;}
 	void SetSkillPoints(int inp) { m_pp.points = inp;}
@@ -1303,6 +1313,9 @@ protected:
 	void CalcEdibleBonuses(StatBonuses* newbon);
 	void CalcAABonuses(StatBonuses* newbon);
 	void ApplyAABonuses(uint32 aaid, uint32 slots, StatBonuses* newbon);
+	uint64 GetAABonusKey();
+	uint64 GetItemBonusKey(uint64 aa_key);
+	void UpdateBonusCache();
 	void MakeBuffFadePacket(uint16 spell_id, int slot_id, bool send_message = true);
 	bool client_data_loaded;
 
@@ -1433,8 +1446,11 @@ private:
 	PetInfo						m_suspendedminion; // pet data for our suspended minion.
 
 	void SendLogoutPackets();
+	enum QueueAction { QueueDrop, QueueSave, QueueSend };
+	QueueAction GetQueueAction(CLIENT_CONN_STATUS required_state, eqFilterType filter);
 	bool AddPacket(const EQApplicationPacket *, bool);
 	bool AddPacket(EQApplicationPacket**, bool);
+	bool AddPacket(const EQSharedPacket &, bool);
 	bool SendAllPackets();
 	std::deque<CLIENTPACKET *> clientpackets;
 
@@ -1452,12 +1468,12 @@ private:
 	uint8 zonesummon_ignorerestrictions;
 	ZoneMode zone_mode;
 
-	Timer position_timer;
+	WheelTimer position_timer;
 	uint8 position_timer_counter;
 
 	PTimerList p_timers; //persistent timers
 	Timer get_auth_timer;
-	Timer hpupdate_timer;
+	WheelTimer hpupdate_timer;
 	Timer camp_timer;
 	Timer process_timer;
 	Timer stamina_timer;
@@ -1480,15 +1496,15 @@ private:
 	Timer helm_toggle_timer;
 	Timer trade_timer;
 	Timer door_check_timer;
-	Timer mend_reset_timer;
+	WheelTimer mend_reset_timer;
 
-	Timer disc_ability_timer;
+	WheelTimer disc_ability_timer;
 	Timer rest_timer;
 	Timer client_ld_timer;
-	Timer apperance_timer; //This gets set to 500 milliseconds when we receive an invis packet in, and allows us to also fade sneak if another action happens within the timer's window.
+	WheelTimer apperance_timer; //This gets set to 500 milliseconds when we receive an invis packet in, and allows us to also fade sneak if another action happens within the timer's window.
 	Timer underwater_timer;
 
-	Timer zoning_timer;
+	WheelTimer zoning_timer;
 	Timer instance_boot_grace_timer;
 
     glm::vec3 m_Proximity;
@@ -1588,6 +1604,21 @@ private:
 	bool rested; // Has been sitting for at least 60 seconds.
 	int32 food_hp;
 	int32 drink_hp;
+
+	// Worn item and AA bonuses only change with gear, level or AAs, so
+	// CalcBonuses keeps them between calls and rebuilds a layer when the key
+	// made from its inputs changes. Buff churn then only redoes spellbonuses.
+	struct BonusCache {
+		bool items_valid;
+		bool aa_valid;
+		uint64 item_key;
+		uint64 aa_key;
+		StatBonuses items;
+		StatBonuses aa;
+		// item_faction_bonuses as CalcItemBonuses left it, before edibles
+		std::map<uint32, int32> item_factions;
+	};
+	BonusCache bonus_cache;
 	uint8 drowning;
 	uint16 wake_corpse_id; // Wake The Dead AA
 	Timer ranged_attack_leeway_timer;
@@ -2687,6 +2687,7 @@ void Client::Handle_OP_Buff(const EQApplicationPacket *app)
 				int emptyslot = -1;
 				FindAffectSlot(this, spid, &emptyslot, 1);
 				buffs[emptyslot] = savedbuff;
+				RebuildEffectIndex();
 				CalcBonuses();
 
 				// reapply buff client-side
@@ -125,15 +125,6 @@ bool Client::Process() {
 			}
 		}
 
-		if(hpupdate_timer.Check())
-		{
-			CalcMaxHP();
-			DoHPRegen();
-		}
-
-		if(mana_timer.Check())
-			SendManaUpdatePacket();
-
 		if(dead && dead_timer.Check()) 
 		{
 			m_pp.zone_id = m_pp.binds[0].zoneId;
@@ -158,12 +149,6 @@ bool Client::Process() {
 			return(false);
 		}
 
-		if (zoning_timer.Check())
-		{
-			zone_mode = ZoneUnsolicited;
-			zoning_timer.Disable();
-		}
-
 		if (camp_timer.Check())
 		{
 			// If a player starts to camp and then cancels it by typing /camp the server gets no packet telling us to set camping to false.
@@ -444,28 +429,6 @@ bool Client::Process() {
 			}
 		}
 
-		if (position_timer.Check()) {
-			if (IsAIControlled())
-			{
-				if (!IsMoving())
-				{
-					animation = 0;
-					m_Delta = glm::vec4(0.0f, 0.0f, 0.0f, m_Delta.w);
-					SendPosUpdate(2);
-				}
-			}
-
-			// Send a position packet every 9 seconds - if not done, other clients
-			// see this char disappear after 10-12 seconds of inactivity
-			if (position_timer_counter >= 36) { // Approx. 4 ticks per second
-				entity_list.SendPositionUpdates(this);
-				position_timer_counter = 0;
-			}
-			else {
-				position_timer_counter++;
-			}
-		}
-
 		if (GetClass() == Class::Warrior && GetShieldTarget())
 		{
 			if (GetShieldTarget()->IsCorpse() || GetShieldTarget()->GetHP() < 1 || GetShieldTarget()->CastToClient()->IsDead()
@@ -478,72 +441,11 @@ bool Client::Process() {
 
 		ProcessHungerThirst();
 
-		if(disc_ability_timer.Check())
-		{
-			disc_ability_timer.Disable();
-			if (active_disc_spell && IsValidSpell(active_disc_spell))
-			{
-				this->Message(Chat::Disciplines, "%s", spells[active_disc_spell].spell_fades);
-			}
-			FadeDisc();
-
-			auto outapp = new EQApplicationPacket(OP_DisciplineChange, sizeof(ClientDiscipline_Struct));
-			ClientDiscipline_Struct *d = (ClientDiscipline_Struct*)outapp->pBuffer;
-			d->disc_id = 0;
-			QueuePacket(outapp);
-			safe_delete(outapp);
-		}
-
-		if (tic_timer.Check() && !dead) 
-		{
-			ProcessFatigue();
-			CalcMaxMana();
-			DoManaRegen();
-			BuffProcess();
-
-			if (fishing_timer.Check()) 
-			{
-				GoFish();
-			}
-
-			if (autosave_timer.Check()) 
-			{
-				Save(0);
-			}
-
-			if(m_pp.intoxication > 0)
-			{
-				--m_pp.intoxication;
-				CalcBonuses();
-			}
-
-			if(ItemTickTimer.Check())
-			{
-				TickItemCheck();
-			}
-
-			if(ItemQuestTimer.Check())
-			{
-				ItemTimerCheck();
-			}
-		}
-
-		if (apperance_timer.Check())
-		{
-			apperance_timer.Disable();
-		}
-
 		// Right now, only veeshan has floor teleports. If more are discovered, create a method to determine which zones need the timer.
 		if (GetZoneID() == Zones::VEESHAN && !door_check_timer.Enabled())
 		{
 			door_check_timer.Start();
 		}
-
-		if (mend_reset_timer.Check())
-		{
-			ResetSkill(EQ::skills::SkillMend);
-			mend_reset_timer.Disable();
-		}
 	}
 
 	if (client_state == CLIENT_KICKED) {
@@ -730,6 +632,99 @@ void Client::OnDisconnect(bool hard_disconnect) {
 
 }
 
+// runs from the timer wheel when the active discipline's duration is up
+void Client::OnDiscAbilityTimer() {
+	if (active_disc_spell && IsValidSpell(active_disc_spell))
+	{
+		this->Message(Chat::Disciplines, "%s", spells[active_disc_spell].spell_fades);
+	}
+	FadeDisc();
+
+	auto outapp = new EQApplicationPacket(OP_DisciplineChange, sizeof(ClientDiscipline_Struct));
+	ClientDiscipline_Struct *d = (ClientDiscipline_Struct*)outapp->pBuffer;
+	d->disc_id = 0;
+	QueuePacket(outapp);
+	safe_delete(outapp);
+}
+
+// tic, hp, mana and position updates run from the timer wheel rather than
+// Process(), they skip the clients Process() would not have run them for
+void Client::OnTicTimer() {
+	if (!ClientDataLoaded() || !(Connected() || IsLD()) || dead)
+		return;
+
+	ProcessFatigue();
+	CalcMaxMana();
+	DoManaRegen();
+	BuffProcess();
+
+	if (fishing_timer.Check()) 
+	{
+		GoFish();
+	}
+
+	if (autosave_timer.Check()) 
+	{
+		Save(0);
+	}
+
+	if(m_pp.intoxication > 0)
+	{
+		--m_pp.intoxication;
+		CalcBonuses();
+	}
+
+	if(ItemTickTimer.Check())
+	{
+		TickItemCheck();
+	}
+
+	if(ItemQuestTimer.Check())
+	{
+		ItemTimerCheck();
+	}
+}
+
+void Client::OnHPUpdateTimer() {
+	if (!ClientDataLoaded() || !(Connected() || IsLD()))
+		return;
+
+	CalcMaxHP();
+	DoHPRegen();
+}
+
+void Client::OnManaTimer() {
+	if (!ClientDataLoaded() || !(Connected() || IsLD()))
+		return;
+
+	SendManaUpdatePacket();
+}
+
+void Client::OnPositionTimer() {
+	if (!ClientDataLoaded() || !(Connected() || IsLD()))
+		return;
+
+	if (IsAIControlled())
+	{
+		if (!IsMoving())
+		{
+			animation = 0;
+			m_Delta = glm::vec4(0.0f, 0.0f, 0.0f, m_Delta.w);
+			SendPosUpdate(2);
+		}
+	}
+
+	// Send a position packet every 9 seconds - if not done, other clients
+	// see this char disappear after 10-12 seconds of inactivity
+	if (position_timer_counter >= 36) { // Approx. 4 ticks per second
+		entity_list.SendPositionUpdates(this);
+		position_timer_counter = 0;
+	}
+	else {
+		position_timer_counter++;
+	}
+}
+
 // Sends the client complete inventory used in character login
 void Client::BulkSendInventoryItems() {
 
@@ -799,17 +799,26 @@ std::vector<DoorsRepository::Doors> ZoneDatabase::LoadDoors(const std::string &z
 	return door_entries;
 }
 
+void Doors::SetOpenState(bool st)
+{
+	if (is_open != st && zone)
+		zone->los_cache.Invalidate();
+	is_open = st;
+}
+
 void Doors::SetLocation(float x, float y, float z)
 {
 	entity_list.DespawnAllDoors();
     m_position = glm::vec4(x, y, z, m_position.w);
 	entity_list.RespawnAllDoors();
+	zone->los_cache.Invalidate();
 }
 
 void Doors::SetPosition(const glm::vec4& position) {
 	entity_list.DespawnAllDoors();
 	m_position = position;
 	entity_list.RespawnAllDoors();
+	zone->los_cache.Invalidate();
 }
 
 void Doors::SetIncline(int in) {
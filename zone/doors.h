@@ -60,7 +60,7 @@ public:
 	void SetLocation(float x, float y, float z);
 	void SetLockpick(uint16 in) { lockpick = in; }
 	void SetNoKeyring(uint8 in) { no_key_ring = in; }
-	void SetOpenState(bool st) { is_open = st; }
+	void SetOpenState(bool st);
 	void SetOpenType(uint8 in);
 	void SetPosition(const glm::vec4& position);
 	void SetSize(uint16 size);
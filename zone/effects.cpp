@@ -1058,6 +1058,27 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 	if (center->IsBeacon())
 		targets_hit = center->CastToBeacon()->GetTargetsHit();
 
+	// trace line of sight to everyone in range up front in one batch instead of a
+	// ray at a time in the loop below. NPC casters only hit the few NPCs they are
+	// hostile to, so their NPC candidates are left to the per target check.
+	std::unordered_map<uint16, bool> los_results;
+	if (detrimental && !zone->SkipLoS() && !spells[spell_id].npc_no_los) {
+		std::vector<Mob*> los_targets;
+		for (auto &e : mob_list) {
+			Mob *m = e.second;
+			if (!m || m == caster || (!clientcaster && m->IsNPC()))
+				continue;
+			if (DistanceSquared(m->GetPosition(), center->GetPosition()) > dist2)
+				continue;
+			los_targets.push_back(m);
+		}
+
+		std::vector<uint8> los;
+		center->CheckLosFNBatch(los_targets, los, true);
+		for (size_t i = 0; i < los_targets.size(); ++i)
+			los_results[los_targets[i]->GetID()] = los[i] != 0;
+	}
+
 	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
 		curmob = it->second;
 		if (!curmob)
@@ -1147,8 +1168,11 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 				}		
 			}
 
-			if (!zone->SkipLoS() && !spells[spell_id].npc_no_los && curmob != caster && !center->CheckLosFN(curmob, true))
-				continue;
+			if (!zone->SkipLoS() && !spells[spell_id].npc_no_los && curmob != caster) {
+				auto los = los_results.find(curmob->GetID());
+				if (los != los_results.end() ? !los->second : !center->CheckLosFN(curmob, true))
+					continue;
+			}
 		}
 		else { 
 			// Balance of the Nameless, Cazic's Gift, recourse spells
@@ -1301,8 +1325,12 @@ void EntityList::AEAttack(Mob *attacker, float dist, int targetLimit)
 
 	int hit = 0;
 
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		curmob = it->second;
+	// Attack() can kill and spawn things, so gather the candidates up front
+	std::vector<NPC *> candidates;
+	ForEachNPCInRange(attacker->GetPosition(), dist, [&candidates](NPC *npc) { candidates.push_back(npc); });
+
+	for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+		curmob = *it;
 		if (!curmob) {
 			continue;
 		}
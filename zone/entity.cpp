@@ -253,7 +253,8 @@ EntityList::EntityList()
 	corpse_depop_timer(250),
 	group_timer(1000),
 	raid_timer(1000),
-	trap_timer(1000)
+	trap_timer(1000),
+	locality_dirty(true)
 {
 
 
@@ -296,6 +297,7 @@ void EntityList::AddClient(Client *client)
 	client->SetID(GetFreeID());
 	client_list.insert(std::pair<uint16, Client *>(client->GetID(), client));
 	mob_list.insert(std::pair<uint16, Mob *>(client->GetID(), client));
+	client_grid.Insert(client->GetID(), client, client->GetX(), client->GetY(), GridFlags(client));
 }
 
 
@@ -487,6 +489,9 @@ void EntityList::MobProcess()
 		Mob *mob = it->second;
 		size_t sz = mob_list.size();
 
+		// catch anything that moved without going through ProcessMove
+		UpdateGridPosition(mob);
+
 		if (zone && RuleB(Zone, IdleWhenEmpty) && !zone->ZoneWillNotIdle() && !zone->IsBoatZone())
 		{
 			static Timer* mob_settle_timer = new Timer();
@@ -522,7 +527,7 @@ void EntityList::MobProcess()
 			}
 
 
-			if (zone->process_mobs_while_empty || !zone->idle || numclients > 0 || mob_settle_timer->Enabled() || mob->GetWanderType() == GridOneWayRepop || mob->GetWanderType() == GridOneWayDepop)
+			if (mob_settle_timer->Enabled() || !zone->MobProcessSuspended(mob))
 			{
 				// Normal processing, or assuring that spawns that should
 				// path and depop do that.  Otherwise all of these type mobs
@@ -731,6 +736,7 @@ void EntityList::AddNPC(NPC *npc, bool SendSpawnPacket, bool dontqueue)
 
 	npc_list.insert(std::pair<uint16, NPC *>(npc->GetID(), npc));
 	mob_list.insert(std::pair<uint16, Mob *>(npc->GetID(), npc));
+	npc_grid.Insert(npc->GetID(), npc, npc->GetX(), npc->GetY(), GridFlags(npc));
 
 	npc->SetAttackTimer(true); // set attacker timers to be ready immediately on spawn
 
@@ -1546,10 +1552,8 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 		dist = 600;
 	float dist2 = dist * dist; //pow(dist, 2);
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		Client *ent = it->second;
-
+	EQBroadcastPacket bp(app);
+	ForEachClientInRange(sender->GetPosition(), dist, [&](Client *ent) {
 		if (ent != nullptr && (!ignore_sender || ent != sender) && (ent != SkipThisMob)) {
 			eqFilterMode filter2 = ent->GetFilter(filter);
 			if(ent->Connected() &&
@@ -1559,23 +1563,23 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 					(ent->GetGroup() && ent->GetGroup()->IsGroupMember(sender))))
 				|| (filter2 == FilterShowSelfOnly && ent == sender))
 			&& (DistanceSquared(ent->GetPosition(), sender->GetPosition()) <= dist2)) {
-				ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+				ent->QueuePacket(bp, ackreq, Client::CLIENT_CONNECTED);
 			}
 		}
-		++it;
-	}
+	});
 }
 
 //sender can be null
 void EntityList::QueueClientsPosUpdate(Mob *sender, const EQApplicationPacket *app,
 	bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender)) {
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(bp, ackreq, Client::CLIENT_CONNECTED);
 		}
 		++it;
 	}
@@ -1585,12 +1589,13 @@ void EntityList::QueueClientsPosUpdate(Mob *sender, const EQApplicationPacket *a
 void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(bp, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -1707,12 +1712,13 @@ void EntityList::QueueWearChange(Mob *sender, const EQApplicationPacket *app, bo
 		}
 	}
 
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender) && (slot != EQ::textures::armorHead || ent->ShowHelm() || force_helm_update))
-			ent->QueuePacket(app, true, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(bp, true, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -2162,14 +2168,12 @@ void EntityList::MessageStatus(uint32 to_guild_id, int to_minstatus, uint32 type
 // works much like MessageClose, but with formatted strings
 void EntityList::MessageClose_StringID(Mob *sender, bool skipsender, float dist, uint32 type, uint32 string_id, const char* message1,const char* message2,const char* message3,const char* message4,const char* message5,const char* message6,const char* message7,const char* message8,const char* message9)
 {
-	Client *c;
 	float dist2 = dist * dist;
 
-	for (auto it = client_list.begin(); it != client_list.end(); ++it) {
-		c = it->second;
+	ForEachClientInRange(sender->GetPosition(), dist, [&](Client *c) {
 		if(c && DistanceSquared(c->GetPosition(), sender->GetPosition()) <= dist2 && (!skipsender || c != sender))
 			c->Message_StringID(type, string_id, message1, message2, message3, message4, message5, message6, message7, message8, message9);
-	}
+	});
 }
 
 void EntityList::FilteredMessageClose_StringID(Mob *sender, bool skipsender,
@@ -2178,16 +2182,14 @@ void EntityList::FilteredMessageClose_StringID(Mob *sender, bool skipsender,
 		const char *message4, const char *message5, const char *message6,
 		const char *message7, const char *message8, const char *message9)
 {
-	Client *c;
 	float dist2 = dist * dist;
 
-	for (auto it = client_list.begin(); it != client_list.end(); ++it) {
-		c = it->second;
+	ForEachClientInRange(sender->GetPosition(), dist, [&](Client *c) {
 		if (c && DistanceSquared(c->GetPosition(), sender->GetPosition()) <= dist2 && (!skipsender || c != sender))
 			c->FilteredMessage_StringID(sender, type, filter, string_id,
 					message1, message2, message3, message4, message5,
 					message6, message7, message8, message9);
-	}
+	});
 }
 
 void EntityList::Message_StringID(Mob *sender, bool skipsender, uint32 type, uint32 string_id, const char* message1,const char* message2,const char* message3,const char* message4,const char* message5,const char* message6,const char* message7,const char* message8,const char* message9)
@@ -2229,12 +2231,10 @@ void EntityList::MessageClose(Mob* sender, bool skipsender, float dist, uint32 t
 
 	float dist2 = dist * dist;
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		if (DistanceSquared(it->second->GetPosition(), sender->GetPosition()) <= dist2 && (!skipsender || it->second != sender))
-			it->second->Message(type, buffer);
-		++it;
-	}
+	ForEachClientInRange(sender->GetPosition(), dist, [&](Client *c) {
+		if (DistanceSquared(c->GetPosition(), sender->GetPosition()) <= dist2 && (!skipsender || c != sender))
+			c->Message(type, buffer);
+	});
 }
 
 void EntityList::RemoveAllMobs()
@@ -2249,18 +2249,22 @@ void EntityList::RemoveAllMobs()
 		free_ids.push(it->first);
 		it = mob_list.erase(it);
 	}
+	client_grid.Clear();
+	npc_grid.Clear();
 }
 
 void EntityList::RemoveAllClients()
 {
 	// doesn't clear the data
 	client_list.clear();
+	client_grid.Clear();
 }
 
 void EntityList::RemoveAllNPCs()
 {
 	// doesn't clear the data
 	npc_list.clear();
+	npc_grid.Clear();
 	npc_limit_list.clear();
 }
 
@@ -2397,6 +2401,8 @@ bool EntityList::RemoveMob(Mob *delete_mob)
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
 		if (it->second == delete_mob) {
+			client_grid.Remove(it->first);
+			npc_grid.Remove(it->first);
 			safe_delete(it->second);
 			if (!corpse_list.count(it->first))
 				free_ids.push(it->first);
@@ -2414,6 +2420,7 @@ bool EntityList::RemoveNPC(uint16 delete_id)
 	if (it != npc_list.end()) {
 		NPC* npc = it->second;
 		RemoveProximity(delete_id);
+		npc_grid.Remove(delete_id);
 		npc_list.erase(it);
 		
 		if (npc_limit_list.count(delete_id)) {
@@ -2429,6 +2436,7 @@ bool EntityList::RemoveClient(uint16 delete_id)
 {
 	auto it = client_list.find(delete_id);
 	if (it != client_list.end()) {
+		client_grid.Remove(delete_id);
 		client_list.erase(it); // Already deleted
 		return true;
 	}
@@ -2441,6 +2449,7 @@ bool EntityList::RemoveClient(Client *delete_client)
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if (it->second == delete_client) {
+			client_grid.Remove(it->first);
 			client_list.erase(it);
 			return true;
 		}
@@ -3439,6 +3448,7 @@ void EntityList::AddProximity(NPC *proximity_for)
 	RemoveProximity(proximity_for->GetID());
 
 	proximity_list.push_back(proximity_for);
+	locality_dirty = true;
 
 	proximity_for->proximity = new NPCProximity; // deleted in NPC::~NPC
 }
@@ -3451,12 +3461,35 @@ bool EntityList::RemoveProximity(uint16 delete_npc_id)
 		return false;
 
 	proximity_list.erase(it);
+	locality_dirty = true;
 	return true;
 }
 
 void EntityList::RemoveAllLocalities()
 {
 	proximity_list.clear();
+	locality_dirty = true;
+}
+
+void EntityList::RebuildLocalityIndex()
+{
+	locality_entries.clear();
+	locality_index.Clear();
+
+	for (auto npc : proximity_list) {
+		NPCProximity *l = npc->proximity;
+		if (l == nullptr)
+			continue;
+		locality_index.Insert(locality_entries.size(), l->min_x, l->max_x, l->min_y, l->max_y);
+		locality_entries.push_back({ npc, nullptr });
+	}
+
+	for (auto &a : area_list) {
+		locality_index.Insert(locality_entries.size(), a.min_x, a.max_x, a.min_y, a.max_y);
+		locality_entries.push_back({ nullptr, &a });
+	}
+
+	locality_dirty = false;
 }
 
 struct quest_proximity_event {
@@ -3467,8 +3500,35 @@ struct quest_proximity_event {
 	int area_type;
 };
 
+uint8 EntityList::GridFlags(Mob *mob)
+{
+	uint8 flags = mob->IsClient() ? SpatialGrid::FlagClient : SpatialGrid::FlagNPC;
+	if (mob->GetOwnerID())
+		flags |= SpatialGrid::FlagPet;
+	return flags;
+}
+
+void EntityList::UpdateGridPosition(Mob *mob, float x, float y)
+{
+	if (!mob)
+		return;
+
+	if (mob->IsClient())
+		client_grid.Update(mob->GetID(), x, y, GridFlags(mob));
+	else if (mob->IsNPC())
+		npc_grid.Update(mob->GetID(), x, y, GridFlags(mob));
+}
+
+void EntityList::UpdateGridPosition(Mob *mob)
+{
+	if (mob)
+		UpdateGridPosition(mob, mob->GetX(), mob->GetY());
+}
+
 void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 {
+	UpdateGridPosition(c, location.x, location.y);
+
 	if (proximity_list.empty() && area_list.empty())
 		return;
 
@@ -3476,9 +3536,16 @@ void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 	float last_y = c->ProximityY();
 	float last_z = c->ProximityZ();
 
-	std::list<quest_proximity_event> events;
-	for (auto iter = proximity_list.begin(); iter != proximity_list.end(); ++iter) {
-		NPC *d = (*iter);
+	if (locality_dirty)
+		RebuildLocalityIndex();
+	locality_index.Query(last_x, last_y, location.x, location.y, locality_candidates);
+
+	std::vector<quest_proximity_event> events;
+	for (auto index : locality_candidates) {
+		if (!locality_entries[index].npc)
+			continue;
+
+		NPC *d = locality_entries[index].npc;
 		NPCProximity *l = d->proximity;
 		if (l == nullptr)
 			continue;
@@ -3517,8 +3584,11 @@ void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 		}
 	}
 
-	for (auto iter = area_list.begin(); iter != area_list.end(); ++iter) {
-		Area& a = (*iter);
+	for (auto index : locality_candidates) {
+		if (!locality_entries[index].area)
+			continue;
+
+		const Area& a = *locality_entries[index].area;
 		bool old_in = true;
 		bool new_in = true;
 		if (last_x < a.min_x || last_x > a.max_x ||
@@ -3570,6 +3640,8 @@ void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 
 void EntityList::ProcessMove(NPC *n, float x, float y, float z)
 {
+	UpdateGridPosition(n, x, y);
+
 	if (area_list.empty())
 		return;
 
@@ -3577,9 +3649,16 @@ void EntityList::ProcessMove(NPC *n, float x, float y, float z)
 	float last_y = n->GetY();
 	float last_z = n->GetZ();
 
-	std::list<quest_proximity_event> events;
-	for (auto iter = area_list.begin(); iter != area_list.end(); ++iter) {
-		Area& a = (*iter);
+	if (locality_dirty)
+		RebuildLocalityIndex();
+	locality_index.Query(last_x, last_y, x, y, locality_candidates);
+
+	std::vector<quest_proximity_event> events;
+	for (auto index : locality_candidates) {
+		if (!locality_entries[index].area)
+			continue;
+
+		const Area& a = *locality_entries[index].area;
 		bool old_in = true;
 		bool new_in = true;
 		if (last_x < a.min_x || last_x > a.max_x ||
@@ -3656,6 +3735,7 @@ void EntityList::AddArea(int id, int type, float min_x, float max_x, float min_y
 	}
 
 	area_list.push_back(a);
+	locality_dirty = true;
 }
 
 void EntityList::RemoveArea(int id)
@@ -3666,11 +3746,13 @@ void EntityList::RemoveArea(int id)
 		return;
 
 	area_list.erase(it);
+	locality_dirty = true;
 }
 
 void EntityList::ClearAreas()
 {
 	area_list.clear();
+	locality_dirty = true;
 }
 
 void EntityList::ProcessProximitySay(const char *Message, Client *c, uint8 language)
@@ -4681,37 +4763,35 @@ void EntityList::GetNearestNPCs(Mob *mob, std::list<Mob*> &npcList, float dist,
 
 	float t1, t2, m_dist;
 
-	for (auto it = npc_list.begin(); it != npc_list.end(); ++it)
-	{
-		NPC* npc = it->second;
+	ForEachNPCInRange(mob->GetPosition(), dist, [&](NPC *npc) {
 		if (!npc || npc == mob || (excludePets && npc->GetOwnerID()))
-			continue;
+			return;
 
 		t1 = npc->GetX() - mob->GetX();
 		if (t1 > dist)
-			continue;
+			return;
 		if (t1 < -dist)
-			continue;
+			return;
 
 		t2 = npc->GetY() - mob->GetY();
 		if (t2 > dist)
-			continue;
+			return;
 		if (t2 < -dist)
-			continue;
+			return;
 
 		if (npcClass && npcClass != npc->GetClass())
-			continue;
+			return;
 
 		if (friendlyOnly && npc->GetReverseFactionCon(mob) > FACTION_KINDLY)
-			continue;
+			return;
 
 		m_dist = DistanceSquaredNoZ(mob->GetPosition(), npc->GetPosition());
 
 		if (m_dist > dist*dist)
-			continue;
+			return;
 
 		npcList.push_back(npc);
-	}
+	});
 }
 
 void EntityList::SendClientAppearances(Client *to_client)
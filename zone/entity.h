@@ -28,6 +28,8 @@
 #include "../common/eq_constants.h"
 
 #include "position.h"
+#include "locality_index.h"
+#include "spatial_grid.h"
 #include "zonedb.h"
 #include "zonedump.h"
 
@@ -221,6 +223,41 @@ public:
 	void	EncounterProcess();
 	void	ProcessMove(Client *c, const glm::vec3& location);
 	void	ProcessMove(NPC *n, float x, float y, float z);
+	void	UpdateGridPosition(Mob *mob, float x, float y);
+	void	UpdateGridPosition(Mob *mob);
+
+	// Range queries backed by the client/npc spatial grids. The callback gets
+	// every entity whose position as of its last grid update is roughly within
+	// dist on the XY plane, so it still has to do its own distance check. It
+	// must not add or remove clients/npcs; collect the results first if the
+	// work it does can spawn, depop or zone anyone.
+	template<typename Fn>
+	void	ForEachClientInRange(const glm::vec3 &center, float dist, Fn fn) const
+	{
+		client_grid.ForEachWithin(center.x, center.y, dist, 0, [&fn](Entity *e) { fn(e->CastToClient()); });
+	}
+	template<typename Fn>
+	void	ForEachNPCInRange(const glm::vec3 &center, float dist, Fn fn) const
+	{
+		npc_grid.ForEachWithin(center.x, center.y, dist, 0, [&fn](Entity *e) { fn(e->CastToNPC()); });
+	}
+	// same as ForEachNPCInRange, but leaves out NPCs that had an owner as of
+	// their last grid update
+	template<typename Fn>
+	void	ForEachNonPetNPCInRange(const glm::vec3 &center, float dist, Fn fn) const
+	{
+		npc_grid.ForEachWithin(center.x, center.y, dist, SpatialGrid::FlagPet, [&fn](Entity *e) { fn(e->CastToNPC()); });
+	}
+	template<typename Fn>
+	void	ForEachClientInBox(float min_x, float min_y, float max_x, float max_y, Fn fn) const
+	{
+		client_grid.ForEachInBox(min_x, min_y, max_x, max_y, [&fn](Entity *e) { fn(e->CastToClient()); });
+	}
+	template<typename Fn>
+	void	ForEachNPCInBox(float min_x, float min_y, float max_x, float max_y, Fn fn) const
+	{
+		npc_grid.ForEachInBox(min_x, min_y, max_x, max_y, [&fn](Entity *e) { fn(e->CastToNPC()); });
+	}
 	void	AddArea(int id, int type, float min_x, float max_x, float min_y, float max_y, float min_z, float max_z);
 	void	RemoveArea(int id);
 	void	ClearAreas();
@@ -389,6 +426,7 @@ public:
 	bool	LimitCheckName(const char* npc_name);
 
 	void	CheckClientAggro(Client *around);
+	void	AIDecideProcess();
 	void	CheckCorpseDragAggro(Client *around);
 	bool	AICheckClientAggro(NPC* aggressor);
 	bool	AICheckNPCAggro(NPC* aggressor);
@@ -496,6 +534,23 @@ private:
 	std::list<Area> area_list;
 	std::queue<uint16> free_ids;
 
+	SpatialGrid client_grid;
+	SpatialGrid npc_grid;
+	static uint8 GridFlags(Mob *mob);
+
+	// proximity_list then area_list flattened in order, indexed by locality_index.
+	// rebuilt on the next move after either list changes, quests set proximity
+	// bounds right after AddProximity so they are final by then.
+	struct LocalityEntry {
+		NPC *npc;
+		const Area *area;
+	};
+	void RebuildLocalityIndex();
+	std::vector<LocalityEntry> locality_entries;
+	std::vector<uint32> locality_candidates;
+	LocalityIndex locality_index;
+	bool locality_dirty;
+
 	Timer object_timer;
 	Timer door_timer;
 	Timer corpse_timer;
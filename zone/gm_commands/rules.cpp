@@ -92,6 +92,7 @@ void command_rules(Client *c, const Seperator *sep)
 	}
 	else if (is_reload) {
 		RuleManager::Instance()->LoadRules(&database, RuleManager::Instance()->GetActiveRuleset(), true);
+		zone->InvalidateBonusCaches();
 		c->Message(
 			Chat::White,
 			fmt::format(
@@ -121,6 +122,7 @@ void command_rules(Client *c, const Seperator *sep)
 		}
 
 		RuleManager::Instance()->LoadRules(&database, sep->arg[2], true);
+		zone->InvalidateBonusCaches();
 
 		c->Message(
 			Chat::White,
@@ -143,6 +145,7 @@ void command_rules(Client *c, const Seperator *sep)
 		}
 
 		RuleManager::Instance()->LoadRules(&database, sep->arg[2], true);
+		zone->InvalidateBonusCaches();
 		c->Message(
 			Chat::White,
 			fmt::format(
@@ -243,6 +246,7 @@ void command_rules(Client *c, const Seperator *sep)
 				);
 			}
 			else {
+				zone->InvalidateBonusCaches();
 				c->Message(
 					Chat::White,
 					fmt::format(
@@ -271,6 +275,7 @@ void command_rules(Client *c, const Seperator *sep)
 				);
 			}
 			else {
+				zone->InvalidateBonusCaches();
 				c->Message(
 					Chat::White,
 					fmt::format(
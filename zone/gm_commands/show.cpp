@@ -11,12 +11,14 @@
 #include "show/inventory.cpp"
 #include "show/ip_lookup.cpp"
 #include "show/line_of_sight.cpp"
+#include "show/los_cache.cpp"
 #include "show/network_stats.cpp"
 #include "show/npc_global_loot.cpp"
 #include "show/npc_stats.cpp"
 #include "show/npc_type.cpp"
 #include "show/quest_errors.cpp"
 #include "show/quest_globals.cpp"
+#include "show/raycast_benchmark.cpp"
 #include "show/server_info.cpp"
 #include "show/skills.cpp"
 #include "show/spawn_status.cpp"
@@ -56,12 +58,14 @@ void command_show(Client *c, const Seperator *sep)
 		Cmd{.cmd = "inventory", .u = "inventory", .fn = ShowInventory, .a = {"#peekinv"}},
 		Cmd{.cmd = "ip_lookup", .u = "ip_lookup", .fn = ShowIPLookup, .a = {"#iplookup"}},
 		Cmd{.cmd = "line_of_sight", .u = "line_of_sight", .fn = ShowLineOfSight, .a = {"#checklos"}},
+		Cmd{.cmd = "los_cache", .u = "los_cache [reset]", .fn = ShowLoSCache},
 		Cmd{.cmd = "network_stats", .u = "network_stats", .fn = ShowNetworkStats, .a = {"#netstats"}},
 		Cmd{.cmd = "npc_global_loot", .u = "npc_global_loot", .fn = ShowNPCGlobalLoot, .a = {"#shownpcgloballoot"}},
 		Cmd{.cmd = "npc_stats", .u = "npc_stats", .fn = ShowNPCStats, .a = {"#npcstats"}},
 		Cmd{.cmd = "npc_type", .u = "npc_type [NPC ID]", .fn = ShowNPCType, .a = {"#viewnpctype"}},
 		Cmd{.cmd = "quest_errors", .u = "quest_errors", .fn = ShowQuestErrors, .a = {"#questerrors"}},
 		Cmd{.cmd = "quest_globals", .u = "quest_globals", .fn = ShowQuestGlobals, .a = {"#globalview"}},
+		Cmd{.cmd = "raycast_benchmark", .u = "raycast_benchmark [Rays] (Rays defaults to 10000)", .fn = ShowRaycastBenchmark},
 		Cmd{.cmd = "server_info", .u = "server_info", .fn = ShowServerInfo, .a = {"#serverinfo"}},
 		Cmd{.cmd = "skills", .u = "skills", .fn = ShowSkills, .a = {"#showskills"}},
 		Cmd{.cmd = "spawn_status", .u = "spawn_status [all|disabled|enabled|Spawn ID]", .fn = ShowSpawnStatus, .a = {"#spawnstatus"}},
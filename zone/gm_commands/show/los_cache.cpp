@@ -0,0 +1,34 @@
+#include "../../client.h"
+
+void ShowLoSCache(Client* c, const Seperator* sep)
+{
+	if (!strcasecmp(sep->arg[2], "reset")) {
+		zone->los_cache.ClearStats();
+		c->Message(Chat::White, "Line of sight cache statistics reset.");
+		return;
+	}
+
+	const auto& s = zone->los_cache.GetStats();
+	const uint64 lookups = s.hits + s.misses;
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Line of sight cache is {} | Entries: {}",
+			RuleB(Map, LoSCacheEnabled) ? "enabled" : "disabled",
+			zone->los_cache.Size()
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Hits: {} Misses: {} Hit Rate: {:.1f}% | Expired: {} Invalidations: {}",
+			s.hits,
+			s.misses,
+			lookups ? (static_cast<double>(s.hits) * 100.0 / lookups) : 0.0,
+			s.expired,
+			s.invalidations
+		).c_str()
+	);
+}
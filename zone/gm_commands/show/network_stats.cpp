@@ -21,6 +21,9 @@ void ShowNetworkStats(Client* c, const Seperator* sep)
 			c->Message(Chat::White, "Recieved:");
 			c->Message(Chat::White, "Total: %u, per second: %u", c->Connection()->GetBytesRecieved(), c->Connection()->GetBytesRecvPerSecond());
 		}
+
+		c->Message(Chat::White, "Broadcast encodes: %llu, encodes saved: %llu",
+			(unsigned long long)EQBroadcastPacket::GetEncodeCount(), (unsigned long long)EQBroadcastPacket::GetEncodesSaved());
 	}
 }
 
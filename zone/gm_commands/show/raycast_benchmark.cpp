@@ -0,0 +1,91 @@
+#include "../../client.h"
+#include "../../map.h"
+
+void ShowRaycastBenchmark(Client* c, const Seperator* sep)
+{
+	if (!zone->zonemap) {
+		c->Message(Chat::White, "This zone has no map loaded.");
+		return;
+	}
+
+	uint32 rays = sep->IsNumber(2) ? static_cast<uint32>(atoi(sep->arg[2])) : 10000;
+	rays = std::min<uint32>(std::max<uint32>(rays, 1), 1000000);
+
+	Map::RaycastBenchmark r;
+	if (!zone->zonemap->RunRaycastBenchmark(rays, 200, r)) {
+		c->Message(Chat::White, "Raycast benchmark failed.");
+		return;
+	}
+
+	auto per_ray_us = [](double ms, uint32 n) { return n ? ms * 1000.0 / n : 0.0; };
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Raycast benchmark | Triangles: {} Rays: {} Hits: {} | Active mesh: {}",
+			r.triangles,
+			r.rays,
+			r.hits,
+			RuleB(Map, UseWideBVH) ? "wide BVH" : "binary tree"
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Binary tree: {:.2f} ms ({:.3f} us/ray) | Wide BVH: {:.2f} ms ({:.3f} us/ray) | Wide BVH batch: {:.2f} ms ({:.3f} us/ray)",
+			r.tree_ms,
+			per_ray_us(r.tree_ms, r.rays),
+			r.bvh_ms,
+			per_ray_us(r.bvh_ms, r.rays),
+			r.bvh_batch_ms,
+			per_ray_us(r.bvh_batch_ms, r.rays)
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Brute force: {:.2f} ms over {} rays ({:.3f} us/ray)",
+			r.brute_ms,
+			r.brute_rays,
+			per_ray_us(r.brute_ms, r.brute_rays)
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Mismatches | Binary tree vs BVH: {} Batch vs BVH: {} Brute force vs BVH: {}",
+			r.tree_mismatches,
+			r.batch_mismatches,
+			r.brute_mismatches
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Height field | Cells: {} ({:.1f} units) Dense: {} ({:.1f}%) | Active: {}",
+			r.height_field_cells,
+			r.height_field_cell_size,
+			r.height_field_dense_cells,
+			r.height_field_cells ? r.height_field_dense_cells * 100.0 / r.height_field_cells : 0.0,
+			RuleB(Map, UseWideBVH) && RuleB(Map, UseHeightField) ? "yes" : "no"
+		).c_str()
+	);
+
+	c->Message(
+		Chat::White,
+		fmt::format(
+			"Vertical rays: {} Hits: {} | Tree walk: {:.2f} ms ({:.3f} us/ray) | Height field: {:.2f} ms ({:.3f} us/ray) | Mismatches: {}",
+			r.vertical_rays,
+			r.vertical_hits,
+			r.vertical_bvh_ms,
+			per_ray_us(r.vertical_bvh_ms, r.vertical_rays),
+			r.height_field_ms,
+			per_ray_us(r.height_field_ms, r.vertical_rays),
+			r.height_field_mismatches
+		).c_str()
+	);
+}
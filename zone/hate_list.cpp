@@ -204,8 +204,8 @@ void HateList::CheckFrenzyHate()
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent->GetHPRatio() >= 20.0f)
-			(*iterator)->bFrenzy = false;
+		if (iterator->ent->GetHPRatio() >= 20.0f)
+			iterator->bFrenzy = false;
 		++iterator;
 	}
 }
@@ -216,19 +216,19 @@ void HateList::Wipe(bool from_memblur)
 	{
 		aggroDeaggroTime = Timer::GetCurrentTime();
 	}
-	auto iterator = list.begin();
 
-	while(iterator != list.end())
+	// the event can change the list, so walk it by position
+	for (size_t i = 0; i < list.size(); ++i)
 	{
-		Mob* m = (*iterator)->ent;
+		Mob* m = list[i].ent;
 		if(m)
 		{
 			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), m, "0", 0);
 		}
-		delete (*iterator);
-		iterator = list.erase(iterator);
-
 	}
+	list.clear();
+	index.clear();
+	by_hate.clear();
 
 	if (!from_memblur)
 	{
@@ -316,14 +316,73 @@ bool HateList::IsOnHateList(Mob *mob)
 
 tHateEntry *HateList::Find(Mob *ent)
 {
-	auto iterator = list.begin();
-	while(iterator != list.end())
+	auto it = index.find(ent);
+	if (it == index.end())
+		return nullptr;
+	return &list[it->second];
+}
+
+// positions after pos move down one, fix up the index and ordering to match
+void HateList::Erase(uint32 pos)
+{
+	uint32 rank = list[pos].rank;
+	index.erase(list[pos].ent);
+	list.erase(list.begin() + pos);
+	by_hate.erase(by_hate.begin() + rank);
+
+	for (uint32 r = 0; r < by_hate.size(); ++r)
 	{
-		if((*iterator)->ent == ent)
-			return (*iterator);
-		++iterator;
+		if (by_hate[r] > pos)
+			by_hate[r]--;
+		if (r >= rank)
+			list[by_hate[r]].rank = r;
 	}
-	return nullptr;
+	for (uint32 i = pos; i < list.size(); ++i)
+		index[list[i].ent] = i;
+}
+
+// moves the entry at pos to its place in by_hate after its hate changed
+void HateList::Reorder(uint32 pos)
+{
+	uint32 rank = list[pos].rank;
+	while (rank > 0 && HatedMore(pos, by_hate[rank - 1]))
+	{
+		by_hate[rank] = by_hate[rank - 1];
+		list[by_hate[rank]].rank = rank;
+		rank--;
+	}
+	while (rank + 1 < by_hate.size() && HatedMore(by_hate[rank + 1], pos))
+	{
+		by_hate[rank] = by_hate[rank + 1];
+		list[by_hate[rank]].rank = rank;
+		rank++;
+	}
+	by_hate[rank] = pos;
+	list[pos].rank = rank;
+}
+
+void HateList::SetEntryHate(Mob *ent, int32 in_hate)
+{
+	tHateEntry *p = Find(ent);
+	if (p)
+	{
+		p->hate = in_hate;
+		Reorder(p - list.data());
+	}
+}
+
+// a mob already on the list keeps its own entry
+bool HateList::SetEntryEnt(Mob *ent, Mob *new_ent)
+{
+	auto it = index.find(ent);
+	if (!new_ent || it == index.end() || index.count(new_ent))
+		return false;
+
+	uint32 pos = it->second;
+	index.erase(it);
+	list[pos].ent = new_ent;
+	index[new_ent] = pos;
+	return true;
 }
 
 void HateList::Set(Mob* other, int32 in_hate, int32 in_dam)
@@ -335,7 +394,10 @@ void HateList::Set(Mob* other, int32 in_hate, int32 in_dam)
 			p->damage = in_dam;
 
 		if (in_hate > -1)
+		{
 			p->hate = in_hate;
+			Reorder(p - list.data());
+		}
 		if (owner->IsNPC())
 		{
 			bool send_engage_notice = owner->CastToNPC()->HasEngageNotice();
@@ -381,7 +443,7 @@ int32 HateList::GetEntPetDamage(Mob* ent)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		m = (*iterator)->ent;
+		m = iterator->ent;
 
 		if (m->IsNPC() && (m->IsPet() || m->CastToNPC()->GetSwarmInfo()))
 		{
@@ -390,7 +452,7 @@ int32 HateList::GetEntPetDamage(Mob* ent)
 			
 			if ((pet_owner && pet_owner == ent) || (swarm_info && swarm_info->GetOwner() && swarm_info->GetOwner() == ent))
 			{
-				dmg += (*iterator)->damage;
+				dmg += iterator->damage;
 			}
 		}
 		++iterator;
@@ -405,8 +467,8 @@ Mob* HateList::GetDamageTopSingleMob(int32& return_dmg) {
 	int32 top_dmg = 0;
 	auto iterator = list.begin();
 	while (iterator != list.end()) {
-		m = (*iterator)->ent;
-		dmg = (*iterator)->damage;
+		m = iterator->ent;
+		dmg = iterator->damage;
 		if (!m) {
 			++iterator;
 			continue;
@@ -443,8 +505,8 @@ Mob* HateList::GetDamageTop(int32& return_dmg, bool combine_pet_dmg, bool client
 	{
 		grp = nullptr;
 		r = nullptr;
-		m = (*iterator)->ent;
-		dmg = (*iterator)->damage;
+		m = iterator->ent;
+		dmg = iterator->damage;
 		
 		if (!m)
 		{
@@ -535,7 +597,7 @@ bool HateList::IsClientOnHateList()
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && ((*iterator)->ent->IsClient() || (*iterator)->ent->IsPlayerOwned()))
+		if (iterator->ent != nullptr && (iterator->ent->IsClient() || iterator->ent->IsPlayerOwned()))
 		{
 			return true;
 		}
@@ -552,9 +614,9 @@ bool HateList::IsCharacterOnHateList(uint32 character_id)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && ((*iterator)->ent->IsClient() || (*iterator)->ent->IsPlayerOwned()))
+		if (iterator->ent != nullptr && (iterator->ent->IsClient() || iterator->ent->IsPlayerOwned()))
 		{
-			Mob* potential_client = (*iterator)->ent->GetOwnerOrSelf();
+			Mob* potential_client = iterator->ent->GetOwnerOrSelf();
 			if (potential_client->IsClient())
 			{
 				Client* c = potential_client->CastToClient();
@@ -575,9 +637,9 @@ bool HateList::IsGroupOnHateList(uint32 group_id)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && ((*iterator)->ent->IsClient() || (*iterator)->ent->IsPlayerOwned()))
+		if (iterator->ent != nullptr && (iterator->ent->IsClient() || iterator->ent->IsPlayerOwned()))
 		{
-			Mob* potential_client = (*iterator)->ent->GetOwnerOrSelf();
+			Mob* potential_client = iterator->ent->GetOwnerOrSelf();
 			if (potential_client->IsClient())
 			{
 				Client* c = potential_client->CastToClient();
@@ -598,9 +660,9 @@ bool HateList::IsRaidOnHateList(uint32 raid_id)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && ((*iterator)->ent->IsClient() || (*iterator)->ent->IsPlayerOwned()))
+		if (iterator->ent != nullptr && (iterator->ent->IsClient() || iterator->ent->IsPlayerOwned()))
 		{
-			Mob* potential_client = (*iterator)->ent->GetOwnerOrSelf();
+			Mob* potential_client = iterator->ent->GetOwnerOrSelf();
 			if (potential_client->IsClient())
 			{
 				Client* c = potential_client->CastToClient();
@@ -621,9 +683,9 @@ bool HateList::IsGuildOnHateList(uint32 guild_id)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && ((*iterator)->ent->IsClient() || (*iterator)->ent->IsPlayerOwned()))
+		if (iterator->ent != nullptr && (iterator->ent->IsClient() || iterator->ent->IsPlayerOwned()))
 		{
-			Mob* potential_client = (*iterator)->ent->GetOwnerOrSelf();
+			Mob* potential_client = iterator->ent->GetOwnerOrSelf();
 			if (potential_client->IsClient())
 			{
 				Client* c = potential_client->CastToClient();
@@ -652,15 +714,15 @@ Mob* HateList::GetClosest(Mob *hater)
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr) {
-			this_distance = DistanceSquaredNoZ((*iterator)->ent->GetPosition(), hater->GetPosition());
+		if (iterator->ent != nullptr) {
+			this_distance = DistanceSquaredNoZ(iterator->ent->GetPosition(), hater->GetPosition());
 
-			if(this_distance <= close_distance && !(*iterator)->ent->DivineAura()
-				&& (!(*iterator)->ent->IsClient() || !(*iterator)->ent->CastToClient()->IsFeigned() || owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+			if(this_distance <= close_distance && !iterator->ent->DivineAura()
+				&& (!iterator->ent->IsClient() || !iterator->ent->CastToClient()->IsFeigned() || owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 			)
 			{
 				close_distance = this_distance;
-				close_entity = (*iterator)->ent;
+				close_entity = iterator->ent;
 			}
 		}
 		++iterator;
@@ -687,8 +749,8 @@ Mob* HateList::GetClosestClient(Mob *hater)
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && (*iterator)->ent->IsClient()) {
-			this_distance = DistanceSquaredNoZ((*iterator)->ent->GetPosition(), hater->GetPosition());
+		if (iterator->ent != nullptr && iterator->ent->IsClient()) {
+			this_distance = DistanceSquaredNoZ(iterator->ent->GetPosition(), hater->GetPosition());
 
 			float ignoreDistance = 200.0f;
 			if (owner->IsNPC())
@@ -697,7 +759,7 @@ Mob* HateList::GetClosestClient(Mob *hater)
 			if (owner->GetOwner() && owner->GetOwner()->IsClient() && owner->GetPetType() != petHatelist)
 				ignoreDistance = RuleR(Pets, AttackCommandRange);
 
-			if ((*iterator)->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+			if (iterator->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 			{
 				++iterator;
 				continue;
@@ -712,10 +774,10 @@ Mob* HateList::GetClosestClient(Mob *hater)
 				continue;
 			}
 
-			if(this_distance <= close_distance && !(*iterator)->ent->DivineAura())
+			if(this_distance <= close_distance && !iterator->ent->DivineAura())
 			{
 				close_distance = this_distance;
-				close_entity = (*iterator)->ent;
+				close_entity = iterator->ent;
 			}
 		}
 		++iterator;
@@ -739,8 +801,8 @@ Mob* HateList::GetClosestNPC(Mob *hater)
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent != nullptr && (*iterator)->ent->IsNPC()) {
-			this_distance = DistanceSquaredNoZ((*iterator)->ent->GetPosition(), hater->GetPosition());
+		if (iterator->ent != nullptr && iterator->ent->IsNPC()) {
+			this_distance = DistanceSquaredNoZ(iterator->ent->GetPosition(), hater->GetPosition());
 
 			float ignoreDistance = 200.0f;
 			if (owner->IsNPC())
@@ -758,10 +820,10 @@ Mob* HateList::GetClosestNPC(Mob *hater)
 				continue;
 			}
 
-			if(this_distance <= close_distance && !(*iterator)->ent->DivineAura())
+			if(this_distance <= close_distance && !iterator->ent->DivineAura())
 			{
 				close_distance = this_distance;
-				close_entity = (*iterator)->ent;
+				close_entity = iterator->ent;
 			}
 		}
 		++iterator;
@@ -779,8 +841,8 @@ void HateList::RecordInitialClientHateIds(Mob* const ent) {
 	auto clientExistsIter = std::find_if(
 		list.begin(),
 		list.end(),
-		[](const tHateEntry* e) {
-			return e->ent != nullptr && (e->ent->IsClient() || e->ent->IsPlayerOwned());
+		[](const tHateEntry& e) {
+			return e.ent != nullptr && (e.ent->IsClient() || e.ent->IsPlayerOwned());
 		}
 	);
 	if (clientExistsIter != std::end(list)) {
@@ -992,19 +1054,19 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 				in_hate = 1;
 		}
 
-		p = new tHateEntry;
-		p->ent = ent;
+		tHateEntry e = {};
+		e.ent = ent;
 		if (in_dam > 0) {
-			p->damage = in_dam;
-			p->last_damage = Timer::GetCurrentTime();
-		}
-		else {
-			p->damage = 0;
-			p->last_damage = 0;
-		}
-		p->hate = in_hate;
-		p->bFrenzy = bFrenzy;
-		list.push_back(p);
+			e.damage = in_dam;
+			e.last_damage = Timer::GetCurrentTime();
+		}
+		e.hate = in_hate;
+		e.bFrenzy = bFrenzy;
+		e.rank = by_hate.size();
+		index[ent] = list.size();
+		by_hate.push_back(list.size());
+		list.push_back(e);
+		Reorder(list.size() - 1);
 		parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "1", 0);
 		Log(Logs::Detail, Logs::Aggro, "%s is creating %d damage and %d hate on %s hatelist.", ent->GetName(), in_dam, in_hate, owner->GetName());
 	}
@@ -1110,6 +1172,8 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 		}
 	}
 
+	// the event above can add to or remove from the list
+	p = Find(ent);
 	if (p)
 	{
 		// this prevents jolt spells from reducing hate below 1
@@ -1117,6 +1181,7 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 			p->hate = 1;
 
 		p->last_hate = Timer::GetCurrentTime();
+		Reorder(p - list.data());
 	}
 }
 
@@ -1126,23 +1191,18 @@ bool HateList::RemoveEnt(Mob *ent)
 		return false;
 
 	bool found = false;
-	auto iterator = list.begin();
 
-	while (iterator != list.end())
+	if (Find(ent))
 	{
-		if ((*iterator)->ent == ent)
-		{
-			if (ent)
-				parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
-			found = true;
+		parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
+		found = true;
 
-			RemoveInitialClientHateIds(ent);
+		RemoveInitialClientHateIds(ent);
 
-			delete (*iterator);
-			iterator = list.erase(iterator);
-		}
-		else
-			++iterator;
+		// look it up again, the event can change the list
+		auto it = index.find(ent);
+		if (it != index.end())
+			Erase(it->second);
 	}
 	if (GetNumHaters() == 0)
 	{
@@ -1223,8 +1283,8 @@ void HateList::DoFactionHits(int32 nfl_id, bool &success) {
 	{
 		Client *p;
 
-		if ((*iterator)->ent && (*iterator)->ent->IsClient())
-			p = (*iterator)->ent->CastToClient();
+		if (iterator->ent && iterator->ent->IsClient())
+			p = iterator->ent->CastToClient();
 		else
 			p = nullptr;
 
@@ -1246,7 +1306,7 @@ int HateList::SummonedPetCount(Mob *hater) {
 	auto iterator = list.begin();
 	while(iterator != list.end()) {
 
-		if((*iterator)->ent != nullptr && (*iterator)->ent->IsNPC() && 	((*iterator)->ent->CastToNPC()->IsPet() || ((*iterator)->ent->CastToNPC()->GetSwarmOwner() > 0)))
+		if(iterator->ent != nullptr && iterator->ent->IsNPC() && 	(iterator->ent->CastToNPC()->IsPet() || (iterator->ent->CastToNPC()->GetSwarmOwner() > 0)))
 		{
 			++petcount;
 		}
@@ -1345,50 +1405,50 @@ Mob *HateList::GetTop()
 	ignoreDistance *= ignoreDistance;
 
 	tHateEntry *cur;
-	auto iterator = list.begin();
-	while (iterator != list.end()) {
-		cur = (*iterator);
-		if (!cur || !cur->ent)
-		{
-			safe_delete(*iterator);
-			iterator = list.erase(iterator);
-			continue;
-		}
+	for (uint32 i = 0; i < list.size();) {
+		cur = &list[i];
 		// remove mobs that have not added hate in 10 minutes
 		if (((current_time - cur->last_hate) > 600000) || cur->ent->HasDied())
 		{
-			if (cur && cur->ent) {
-				parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), cur->ent, "0", 0);
-				if (owner && !owner->HasDied())
-					owner->RemoveFromRampageList(cur->ent, true);
-			}
-			safe_delete(*iterator);
-			iterator = list.erase(iterator);
+			Mob *ent = cur->ent;
+			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
+			if (owner && !owner->HasDied())
+				owner->RemoveFromRampageList(ent, true);
+
+			// the event can change the list, look it up again
+			auto it = index.find(ent);
+			if (it != index.end())
+				Erase(it->second);
 			continue;
 		}
-		cur->dist_squared = DistanceSquaredNoZ(cur->ent->GetPosition(), owner->GetPosition());
-		int z_diff = std::abs(cur->ent->GetZ() - owner->GetZ());
-		z_diff *= z_diff;
-		// If NPC has ignore distance < 1000 (generally indoor zones) then add a 1000 unit Z check to ignore range.
-		// I would use the real ignore range instead of 1000 but it was wonky in BoT towers due to the way our pathing
-		// works so setting it to 1000 and relying on scripts to prevent exploits on certain NPCs
-		if (ignoreDistance < 1000*1000 && z_diff > 1000*1000 && cur->dist_squared < z_diff)
-			cur->dist_squared = z_diff;
+		// GetTop can run several times a tick, distances only change between ticks
+		if (cur->dist_time != current_time)
+		{
+			cur->dist_squared = DistanceSquaredNoZ(cur->ent->GetPosition(), owner->GetPosition());
+			int z_diff = std::abs(cur->ent->GetZ() - owner->GetZ());
+			z_diff *= z_diff;
+			// If NPC has ignore distance < 1000 (generally indoor zones) then add a 1000 unit Z check to ignore range.
+			// I would use the real ignore range instead of 1000 but it was wonky in BoT towers due to the way our pathing
+			// works so setting it to 1000 and relying on scripts to prevent exploits on certain NPCs
+			if (ignoreDistance < 1000*1000 && z_diff > 1000*1000 && cur->dist_squared < z_diff)
+				cur->dist_squared = z_diff;
+			cur->dist_time = current_time;
+		}
 
 		if (cur->dist_squared < closestMobDist)
 		{
 			closestMob = cur->ent;
 			closestMobDist = cur->dist_squared;
 		}
-		++iterator;
+		++i;
 	}
 	if (list.size() == 0)
 		return nullptr;
 
-	iterator = list.begin();
+	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		cur = (*iterator);
+		cur = &(*iterator);
 
 		auto hateEntryPosition = glm::vec3(cur->ent->GetX(), cur->ent->GetY(), cur->ent->GetZ());
 
@@ -1518,6 +1578,21 @@ Mob *HateList::GetTop()
 
 Mob *HateList::GetMostHate(bool includeBonus)
 {
+	// without bonuses the answer is the first unfeigned entry in hate order
+	if (!includeBonus)
+	{
+		for (uint32 pos : by_hate)
+		{
+			tHateEntry *cur = &list[pos];
+			if (cur->hate < 0)
+				break;
+			if (cur->ent->IsClient() && cur->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+				continue;
+			return cur->ent;
+		}
+		return nullptr;
+	}
+
 	Mob* topMob = nullptr;
 	int32 topHate = -1;
 	bool firstInRangeBonusApplied = false;
@@ -1525,7 +1600,7 @@ Mob *HateList::GetMostHate(bool includeBonus)
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		cur = (*iterator);
+		cur = &(*iterator);
 		int32 bonus = 0;
 
 		if (cur->ent->IsClient() && cur->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
@@ -1570,10 +1645,10 @@ Mob *HateList::GetRandom()
 	{
 		if (i < random)
 			++iterator;
-		else if ((*iterator)->ent->IsClient() && (*iterator)->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+		else if (iterator->ent->IsClient() && iterator->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 			++iterator;
 		else
-			return (*iterator)->ent;
+			return iterator->ent;
 	}
 
 	if (random > 0)
@@ -1581,10 +1656,10 @@ Mob *HateList::GetRandom()
 		iterator = list.begin();
 		for (int i = 0; i < random; i++)
 		{
-			if ((*iterator)->ent->IsClient() && (*iterator)->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+			if (iterator->ent->IsClient() && iterator->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 				++iterator;
 			else
-				return (*iterator)->ent;
+				return iterator->ent;
 		}
 	}
 
@@ -1602,12 +1677,12 @@ Client *HateList::GetRandomClient(int32 max_dist)
 	int random = zone->random.Int(0, count - 1);
 	for (int i = 0; i < count; i++)
 	{
-		if (i < random || !(*iterator)->ent->IsClient())
+		if (i < random || !iterator->ent->IsClient())
 			++iterator;
-		else if ((*iterator)->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+		else if (iterator->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 			++iterator;
-		else if (max_dist == 0 || (*iterator)->dist_squared < max_dist)
-			return (*iterator)->ent->CastToClient();
+		else if (max_dist == 0 || iterator->dist_squared < max_dist)
+			return iterator->ent->CastToClient();
 		else
 			++iterator;
 	}
@@ -1617,12 +1692,12 @@ Client *HateList::GetRandomClient(int32 max_dist)
 		iterator = list.begin();
 		for (int i = 0; i < random; i++)
 		{
-			if (!(*iterator)->ent->IsClient())
+			if (!iterator->ent->IsClient())
 				++iterator;
-			if ((*iterator)->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
+			if (iterator->ent->CastToClient()->IsFeigned() && !owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity))
 				++iterator;
-			else if (max_dist == 0 || (*iterator)->dist_squared < max_dist)
-				return (*iterator)->ent->CastToClient();
+			else if (max_dist == 0 || iterator->dist_squared < max_dist)
+				return iterator->ent->CastToClient();
 			else
 				++iterator;
 		}
@@ -1633,20 +1708,21 @@ Client *HateList::GetRandomClient(int32 max_dist)
 
 int32 HateList::GetEntHate(Mob *ent, bool includeBonus)
 {
+	if (!includeBonus)
+	{
+		tHateEntry *p = Find(ent);
+		return p ? p->hate : 0;
+	}
+
+	// the first in range bonus goes to whoever is earliest on the list, so walk it in order
 	bool firstInRangeBonusApplied = false;
 	bool combatRange;
 	tHateEntry *p;
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		p = (*iterator);
+		p = &(*iterator);
 
-		if (!p)
-		{
-			++iterator;
-			continue;
-		}
-		
 		if (includeBonus)
 		{
 			combatRange = owner->CombatRange(p->ent);
@@ -1676,35 +1752,21 @@ int32 HateList::GetEntHate(Mob *ent, bool includeBonus)
 int32 HateList::GetEntDamage(Mob *ent, bool combine_pet_dmg)
 {
 	int32 dmg = 0;
-	tHateEntry *p;
-	auto iterator = list.begin();
-	while (iterator != list.end())
-	{
-		p = (*iterator);
-
-		if (!p)
-		{
-			++iterator;
-			continue;
-		}
+	tHateEntry *p = Find(ent);
+	if (!p)
+		return 0;
 
-		if (p->ent == ent)
-		{
-			if (ent->IsClient() && ent->CastToClient()->IsFeigned()
-				&& (!owner->IsFleeing() || owner->IsRooted() || (Distance(owner->GetPosition(), ent->GetPosition()) > 100.0f))
-			)
-				dmg = 0;
-			else
-				dmg = p->damage;
+	if (ent->IsClient() && ent->CastToClient()->IsFeigned()
+		&& (!owner->IsFleeing() || owner->IsRooted() || (Distance(owner->GetPosition(), ent->GetPosition()) > 100.0f))
+	)
+		dmg = 0;
+	else
+		dmg = p->damage;
 
-			if (combine_pet_dmg)
-				return dmg + GetEntPetDamage(p->ent);
-			else
-				return dmg;
-		}
-		++iterator;
-	}
-	return 0;
+	if (combine_pet_dmg)
+		return dmg + GetEntPetDamage(p->ent);
+	else
+		return dmg;
 }
 
 //looking for any mob with hate > -1
@@ -1715,11 +1777,7 @@ bool HateList::IsEmpty() {
 // Prints hate list to a client
 void HateList::PrintToClient(Client *c)
 {
-	std::list<tHateEntry*> list2 = list;
-	list2.sort([](tHateEntry* a, tHateEntry* b) { return a->hate > b->hate; });
-
 	int32 bonusHate = 0;
-	auto iterator = list2.begin();
 	Mob* closestMob = GetClosest();
 	Mob* firstInRange = GetFirstMobInRange();
 	uint32 aggroTime = GetAggroDeaggroTime();
@@ -1742,10 +1800,9 @@ void HateList::PrintToClient(Client *c)
 
 		return;
 	}
-	tHateEntry *e;
-	while (iterator != list2.end())
+	for (uint32 pos : by_hate)
 	{
-		e = (*iterator);
+		tHateEntry *e = &list[pos];
 		uint32 timer = Timer::GetCurrentTime() - e->last_hate;
 		if (timer > 0)
 		{
@@ -1772,8 +1829,6 @@ void HateList::PrintToClient(Client *c)
 			(e->ent && e->ent->GetName()) ? e->ent->GetName() : "(null)",
 			GetClassIDName(e->ent->GetClass(), 1),
 			timer, e->damage, buffer, e->hate, buffer2);
-
-		++iterator;
 	}
 
 	if (owner->GetSpecialAbility(SpecialAbility::Rampage))
@@ -1840,7 +1895,7 @@ int HateList::AreaRampage(Mob *caster, Mob *target, int count, int damagePct)
 
 	// if the rampager dies during the rampge this hate list is wiped and its elements deleted, so make a copy of the list of hated mobs before starting the rampage
 	std::list<Mob *> hated_mobs;
-	std::for_each(list.begin(), list.end(), [&](tHateEntry *h) { hated_mobs.push_back(h->ent); });
+	std::for_each(list.begin(), list.end(), [&](const tHateEntry &h) { hated_mobs.push_back(h.ent); });
 
 	for(auto it = hated_mobs.begin(); it != hated_mobs.end() && !caster->HasDied() && targetsHit < count; ++it)
 	{
@@ -1890,7 +1945,7 @@ void HateList::SpellCast(Mob *caster, uint32 spell_id, float range, Mob* ae_cent
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		h = (*iterator);
+		h = &(*iterator);
 		if(range > 0)
 		{
 			dist_targ = DistanceSquared(center->GetPosition(), h->ent->GetPosition());
@@ -1928,11 +1983,11 @@ void HateList::ReportDmgTotals(Mob* mob, bool corpse, bool xp, bool faction, int
 	{
 		Client *p;
 
-		if ((*iterator)->ent && (*iterator)->ent->IsClient())
-			p = (*iterator)->ent->CastToClient();
-		else if ((*iterator)->ent && (*iterator)->ent->IsPlayerOwned())
+		if (iterator->ent && iterator->ent->IsClient())
+			p = iterator->ent->CastToClient();
+		else if (iterator->ent && iterator->ent->IsPlayerOwned())
 		{
-			p = (*iterator)->ent->GetOwner()->CastToClient();
+			p = iterator->ent->GetOwner()->CastToClient();
 			if (mob && mob->IsNPC() && mob->CastToNPC()->IsOnHatelist(p))
 			{
 				// Owner is on the hatelist, so it will have its own entry. Set to null to prevent a double message.
@@ -1953,21 +2008,10 @@ void HateList::ReportDmgTotals(Mob* mob, bool corpse, bool xp, bool faction, int
 // returns -1 for invalid n
 int HateList::GetHateN(int n)
 {
-	if (n < 1 || n > list.size() || list.size() == 0)
+	if (n < 1 || n > by_hate.size())
 		return -1;
 
-	std::list<tHateEntry*> list2 = list;
-	list2.sort([](tHateEntry* a, tHateEntry* b) { return a->hate > b->hate; });
-
-	auto iterator = list2.begin();
-	std::advance(iterator, n-1);
-
-	tHateEntry *entity = (*iterator);
-
-	if (entity)
-		return entity->hate;
-	else
-		return -1;
+	return list[by_hate[n - 1]].hate;
 }
 
 Mob* HateList::GetFirstMobInRange()
@@ -1994,7 +2038,7 @@ Mob* HateList::GetFirstMobInRange()
 
 	while (iterator != list.end())
 	{
-		e = (*iterator);
+		e = &(*iterator);
 		if (owner->CombatRange(e->ent) && (!e->ent->IsClient() || !e->ent->CastToClient()->IsFeigned() || owner->GetSpecialAbility(SpecialAbility::FeignDeathImmunity)))
 			return e->ent;
 
@@ -2005,19 +2049,16 @@ Mob* HateList::GetFirstMobInRange()
 
 void HateList::RemoveFeigned()
 {
-	auto iterator = list.begin();
-	while (iterator != list.end())
+	for (uint32 i = 0; i < list.size();)
 	{
-		const auto ent = (*iterator)->ent;
+		const auto ent = list[i].ent;
 		if (ent && ent->IsClient() && ent->CastToClient()->IsFeigned())
 		{
 			RemoveInitialClientHateIds(ent);
-
-			safe_delete(*iterator);
-			iterator = list.erase(iterator);
+			Erase(i);
 			continue;
 		}
-		++iterator;
+		++i;
 	}
 
 	if (owner->GetPet() && !owner->GetPet()->IsCharmed())
@@ -19,6 +19,9 @@
 #ifndef HATELIST_H
 #define HATELIST_H
 
+#include <unordered_map>
+#include <vector>
+
 class Client;
 class Group;
 class Mob;
@@ -30,8 +33,10 @@ struct tHateEntry
 	int32 damage, hate;
 	bool bFrenzy;
 	float dist_squared;
+	uint32 dist_time; // Timer::GetCurrentTime() dist_squared was worked out at
 	uint32 last_damage;
 	uint32 last_hate;
+	uint32 rank; // position in HateList::by_hate
 };
 
 struct SInitialEngageEntry {
@@ -129,8 +134,12 @@ public:
 	uint32 GetIgnoreStuckCount() { return ignoreStuckCount; }
 	void PrintToClient(Client *c);
 
-	//For accessing the hate list via perl; don't use for anything else
-	std::list<tHateEntry*>& GetHateList() { return list; }
+	//For accessing the hate list via lua; don't use for anything else
+	const std::vector<tHateEntry>& GetEntries() const { return list; }
+	tHateEntry *GetEntry(Mob *ent) { return Find(ent); }
+	// hate and ent are indexed, change them through these rather than GetEntry()
+	void SetEntryHate(Mob *ent, int32 in_hate);
+	bool SetEntryEnt(Mob *ent, Mob *new_ent);
 
 	//setting owner
 	void SetOwner(Mob *newOwner);
@@ -152,7 +161,16 @@ protected:
 	void RemoveInitialClientHateIds(Mob* const ent);
 
 private:
-	std::list<tHateEntry*> list;
+	void Erase(uint32 pos);
+	void Reorder(uint32 pos);
+	bool HatedMore(uint32 a, uint32 b) const { return list[a].hate > list[b].hate || (list[a].hate == list[b].hate && a < b); }
+
+	// in the order mobs were added, first in range bonuses and the like depend on it
+	std::vector<tHateEntry> list;
+	// ent -> position in list, only changed from the main thread so AI workers can Find()
+	std::unordered_map<const Mob *, uint32> index;
+	// positions in list, most hated first with ties in list order
+	std::vector<uint32> by_hate;
 	Mob *owner;
 	int32 combatRangeBonus;
 	int32 sitInsideBonus;
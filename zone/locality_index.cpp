@@ -0,0 +1,88 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "locality_index.h"
+
+#include <algorithm>
+
+LocalityIndex::LocalityIndex(float cell_size)
+{
+	m_inv_cell_size = 1.0f / (cell_size > 1.0f ? cell_size : 1.0f);
+}
+
+void LocalityIndex::Insert(uint32 entry, float min_x, float max_x, float min_y, float max_y)
+{
+	// a box with nan or inverted bounds still has to be tested the same way the caller always did
+	if (!(min_x <= max_x) || !(min_y <= max_y)) {
+		m_wide.push_back(entry);
+		return;
+	}
+
+	int32 cx0 = CellCoord(min_x);
+	int32 cx1 = CellCoord(max_x);
+	int32 cy0 = CellCoord(min_y);
+	int32 cy1 = CellCoord(max_y);
+
+	int64 span = static_cast<int64>(cx1 - cx0 + 1) * static_cast<int64>(cy1 - cy0 + 1);
+	if (span > MaxCellsPerEntry) {
+		m_wide.push_back(entry);
+		return;
+	}
+
+	for (int32 cx = cx0; cx <= cx1; ++cx) {
+		for (int32 cy = cy0; cy <= cy1; ++cy)
+			m_cells[CellKey(cx, cy)].push_back(entry);
+	}
+}
+
+void LocalityIndex::Clear()
+{
+	m_cells.clear();
+	m_wide.clear();
+}
+
+void LocalityIndex::Query(float x1, float y1, float x2, float y2, std::vector<uint32> &out) const
+{
+	out.clear();
+	out.insert(out.end(), m_wide.begin(), m_wide.end());
+	Append(x1, y1, out);
+	if (CellCoord(x1) != CellCoord(x2) || CellCoord(y1) != CellCoord(y2))
+		Append(x2, y2, out);
+
+	std::sort(out.begin(), out.end());
+	out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void LocalityIndex::Append(float x, float y, std::vector<uint32> &out) const
+{
+	auto it = m_cells.find(CellKey(CellCoord(x), CellCoord(y)));
+	if (it != m_cells.end())
+		out.insert(out.end(), it->second.begin(), it->second.end());
+}
+
+int32 LocalityIndex::CellCoord(float v) const
+{
+	// nan lands in the lowest cell, a box test against it fails anyway
+	if (!(v > -MaxCoord))
+		v = -MaxCoord;
+	else if (v > MaxCoord)
+		v = MaxCoord;
+	float c = v * m_inv_cell_size;
+	int32 i = static_cast<int32>(c);
+	return (c < i) ? i - 1 : i;
+}
@@ -0,0 +1,55 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef LOCALITY_INDEX_H
+#define LOCALITY_INDEX_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "../common/types.h"
+
+// Uniform grid over the XY extent of quest proximity and area boxes, so a move
+// only tests the boxes near where it started and ended.  Entries are small
+// integers handed out by the caller; Query returns them in ascending order so
+// events keep firing in the order the boxes were registered.
+class LocalityIndex
+{
+public:
+	explicit LocalityIndex(float cell_size = 128.0f);
+
+	void Insert(uint32 entry, float min_x, float max_x, float min_y, float max_y);
+	void Clear();
+
+	// Replaces out with every entry whose box may contain either point.
+	void Query(float x1, float y1, float x2, float y2, std::vector<uint32> &out) const;
+
+private:
+	// boxes spanning more cells than this are tested on every query instead
+	static constexpr int64 MaxCellsPerEntry = 256;
+	static constexpr float MaxCoord = 1000000.0f;
+
+	int32 CellCoord(float v) const;
+	static inline int64 CellKey(int32 cx, int32 cy) { return (static_cast<int64>(cx) << 32) | static_cast<uint32>(cy); }
+	void Append(float x, float y, std::vector<uint32> &out) const;
+
+	float m_inv_cell_size;
+	std::unordered_map<int64, std::vector<uint32>> m_cells;
+	std::vector<uint32> m_wide;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "los_cache.h"
+#include "../common/rulesys.h"
+#include "../common/timer.h"
+
+#include <cmath>
+
+LosCache::LosCache()
+	: m_next_prune(0)
+{
+	ClearStats();
+}
+
+bool LosCache::Key::operator==(const Key &o) const
+{
+	for (int i = 0; i < 6; ++i) {
+		if (c[i] != o.c[i])
+			return false;
+	}
+	return true;
+}
+
+size_t LosCache::KeyHash::operator()(const Key &k) const
+{
+	uint64 h = 1469598103934665603ULL;
+	for (int i = 0; i < 6; ++i) {
+		h ^= static_cast<uint32>(k.c[i]);
+		h *= 1099511628211ULL;
+	}
+	return static_cast<size_t>(h);
+}
+
+LosCache::Key LosCache::MakeKey(const glm::vec3 &from, const glm::vec3 &to) const
+{
+	float cell = RuleR(Map, LoSCacheCellSize);
+	float inv = cell > 0.01f ? 1.0f / cell : 100.0f;
+
+	Key k;
+	k.c[0] = static_cast<int32>(std::floor(from.x * inv));
+	k.c[1] = static_cast<int32>(std::floor(from.y * inv));
+	k.c[2] = static_cast<int32>(std::floor(from.z * inv));
+	k.c[3] = static_cast<int32>(std::floor(to.x * inv));
+	k.c[4] = static_cast<int32>(std::floor(to.y * inv));
+	k.c[5] = static_cast<int32>(std::floor(to.z * inv));
+	return k;
+}
+
+bool LosCache::Lookup(const glm::vec3 &from, const glm::vec3 &to, bool &result)
+{
+	uint32 now = Timer::GetCurrentTime();
+	if (now >= m_next_prune)
+		Prune(now);
+
+	auto it = m_entries.find(MakeKey(from, to));
+	if (it == m_entries.end()) {
+		m_stats.misses++;
+		return false;
+	}
+
+	if (now >= it->second.expires) {
+		m_entries.erase(it);
+		m_stats.expired++;
+		m_stats.misses++;
+		return false;
+	}
+
+	m_stats.hits++;
+	result = it->second.result;
+	return true;
+}
+
+bool LosCache::Contains(const glm::vec3 &from, const glm::vec3 &to) const
+{
+	auto it = m_entries.find(MakeKey(from, to));
+	return it != m_entries.end() && Timer::GetCurrentTime() < it->second.expires;
+}
+
+void LosCache::Store(const glm::vec3 &from, const glm::vec3 &to, bool result)
+{
+	uint32 now = Timer::GetCurrentTime();
+	if (m_entries.size() >= MaxEntries) {
+		Prune(now);
+		// everything is still live, a crowded zone churns through this quickly anyway
+		if (m_entries.size() >= MaxEntries)
+			m_entries.clear();
+	}
+
+	m_entries[MakeKey(from, to)] = { result, now + static_cast<uint32>(RuleI(Map, LoSCacheTTL)) };
+}
+
+void LosCache::Invalidate()
+{
+	if (!m_entries.empty()) {
+		m_entries.clear();
+		m_stats.invalidations++;
+	}
+}
+
+void LosCache::ClearStats()
+{
+	m_stats = {};
+}
+
+void LosCache::Prune(uint32 now)
+{
+	for (auto it = m_entries.begin(); it != m_entries.end();) {
+		if (now >= it->second.expires) {
+			it = m_entries.erase(it);
+			m_stats.expired++;
+		}
+		else {
+			++it;
+		}
+	}
+
+	m_next_prune = now + PruneInterval;
+}
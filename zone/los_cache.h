@@ -0,0 +1,81 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef LOS_CACHE_H
+#define LOS_CACHE_H
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "../common/types.h"
+#include "position.h"
+
+// Short lived cache of zone map line of sight results.  Endpoints are snapped
+// to Map:LoSCacheCellSize cells, so repeated checks between mobs that have not
+// moved (aggro scans, casting, assists) skip the raycast.  Entries live for
+// Map:LoSCacheTTL ms and everything is dropped when a door or object changes.
+class LosCache
+{
+public:
+	struct Stats {
+		uint64 hits;
+		uint64 misses;
+		uint64 expired;
+		uint64 invalidations;
+	};
+
+	LosCache();
+
+	// Returns true and fills result if a live entry exists for from -> to.
+	bool Lookup(const glm::vec3 &from, const glm::vec3 &to, bool &result);
+	void Store(const glm::vec3 &from, const glm::vec3 &to, bool result);
+	// Lookup without touching stats or expiring anything, so several threads
+	// can ask at once while nothing is being stored.
+	bool Contains(const glm::vec3 &from, const glm::vec3 &to) const;
+	void Invalidate();
+
+	inline size_t Size() const { return m_entries.size(); }
+	inline const Stats &GetStats() const { return m_stats; }
+	void ClearStats();
+
+private:
+	struct Key {
+		int32 c[6];
+		bool operator==(const Key &o) const;
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &k) const;
+	};
+
+	struct Entry {
+		bool   result;
+		uint32 expires;
+	};
+
+	static constexpr size_t MaxEntries = 65536;
+	static constexpr uint32 PruneInterval = 5000;
+
+	Key MakeKey(const glm::vec3 &from, const glm::vec3 &to) const;
+	void Prune(uint32 now);
+
+	std::unordered_map<Key, Entry, KeyHash> m_entries;
+	uint32 m_next_prune;
+	Stats  m_stats;
+};
+
+#endif
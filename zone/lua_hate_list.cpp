@@ -12,42 +12,54 @@
 
 Lua_Mob Lua_HateEntry::GetEnt() {
 	Lua_Safe_Call_Class(Lua_Mob);
-	return Lua_Mob(self->ent);
+	tHateEntry *entry = self->GetEntry(ent_);
+	return Lua_Mob(entry ? entry->ent : nullptr);
 }
 
 void Lua_HateEntry::SetEnt(Lua_Mob e) {
 	Lua_Safe_Call_Void();
-	self->ent = e;
+	if(self->SetEntryEnt(ent_, e)) {
+		ent_ = e;
+	}
 }
 
 int Lua_HateEntry::GetDamage() {
 	Lua_Safe_Call_Int();
-	return self->damage;
+	tHateEntry *entry = self->GetEntry(ent_);
+	return entry ? entry->damage : 0;
 }
 
 void Lua_HateEntry::SetDamage(int value) {
 	Lua_Safe_Call_Void();
-	self->damage = value;
+	tHateEntry *entry = self->GetEntry(ent_);
+	if(entry) {
+		entry->damage = value;
+	}
 }
 
 int Lua_HateEntry::GetHate() {
 	Lua_Safe_Call_Int();
-	return self->hate;
+	tHateEntry *entry = self->GetEntry(ent_);
+	return entry ? entry->hate : 0;
 }
 
 void Lua_HateEntry::SetHate(int value) {
 	Lua_Safe_Call_Void();
-	self->hate = value;
+	self->SetEntryHate(ent_, value);
 }
 
 int Lua_HateEntry::GetFrenzy() {
 	Lua_Safe_Call_Int();
-	return self->bFrenzy;
+	tHateEntry *entry = self->GetEntry(ent_);
+	return entry ? entry->bFrenzy : 0;
 }
 
 void Lua_HateEntry::SetFrenzy(bool value) {
 	Lua_Safe_Call_Void();
-	self->bFrenzy = value;
+	tHateEntry *entry = self->GetEntry(ent_);
+	if(entry) {
+		entry->bFrenzy = value;
+	}
 }
 
 luabind::scope lua_register_hate_entry() {
@@ -5,17 +5,20 @@
 #include "lua_ptr.h"
 
 class Lua_Mob;
-struct tHateEntry;
+class HateList;
+class Mob;
 
 luabind::scope lua_register_hate_entry();
 luabind::scope lua_register_hate_list();
 
-class Lua_HateEntry : public Lua_Ptr<tHateEntry>
+// entries are looked up by mob each call, the list stores them by value and
+// moves them around as mobs are added and removed
+class Lua_HateEntry : public Lua_Ptr<HateList>
 {
-	typedef tHateEntry NativeType;
+	typedef HateList NativeType;
 public:
-	Lua_HateEntry() : Lua_Ptr(nullptr) { }
-	Lua_HateEntry(tHateEntry *d) : Lua_Ptr(d) { }
+	Lua_HateEntry() : Lua_Ptr(nullptr), ent_(nullptr) { }
+	Lua_HateEntry(HateList *d, Mob *ent) : Lua_Ptr(d), ent_(ent) { }
 	virtual ~Lua_HateEntry() { }
 	
 	Lua_Mob GetEnt();
@@ -26,6 +29,9 @@ public:
 	void SetHate(int value);
 	int GetFrenzy();
 	void SetFrenzy(bool value);
+
+private:
+	Mob *ent_;
 };
 
 struct Lua_HateList
@@ -785,12 +785,10 @@ Lua_HateList Lua_Mob::GetHateList() {
 	Lua_Safe_Call_Class(Lua_HateList);
 	Lua_HateList ret;
 
-	auto h_list = self->GetHateList();
-	auto iter = h_list.begin();
-	while(iter != h_list.end()) {
-		Lua_HateEntry e(*iter);
+	HateList &h_list = self->GetHateList();
+	for(const auto &entry : h_list.GetEntries()) {
+		Lua_HateEntry e(&h_list, entry.ent);
 		ret.entries.push_back(e);
-		++iter;
 	}
 
 	return ret;
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 
 #include "../common/spdat.h"
 #include "masterentity.h"
@@ -35,6 +36,7 @@
 #include "lua_packet.h"
 #include "lua_parser.h"
 #include "lua_raid.h"
+#include "lua_script_cache.h"
 #include "lua_spawn.h"
 #include "lua_spell.h"
 
@@ -212,6 +214,19 @@ LuaParser::LuaParser() {
 #endif
 
 	L = nullptr;
+	gc_in_cycle_ = false;
+	gc_floor_kb_ = 0;
+	event_count_ = 0;
+	event_alloc_bytes_ = 0;
+	script_loads_ = 0;
+	script_cache_hits_ = 0;
+	script_load_us_ = 0;
+}
+
+LuaParser::EntityRefs::EntityRefs() {
+	for(int i = 0; i < LuaWrapCount; ++i) {
+		ref[i] = LUA_NOREF;
+	}
 }
 
 LuaParser::~LuaParser() {
@@ -219,6 +234,7 @@ LuaParser::~LuaParser() {
 	lua_encounters.clear();
 	lua_encounter_events_registered.clear();
 	lua_encounters_loaded.clear();
+	entity_refs_.clear();
 	if(L) {
 		lua_close(L);
 	}
@@ -266,6 +282,7 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 	const char *sub_name = LuaEvents[evt];
 
 	int start = lua_gettop(L);
+	uint64 heap_before = GetHeapBytes();
 
 	try {
 		int npop = 1;
@@ -277,11 +294,9 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, 4);
 		//always push self
-		Lua_NPC l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		PushNPC(npc);
 		lua_setfield(L, -2, "self");
 
 		auto arg_function = NPCArgumentDispatch[evt];
@@ -301,7 +316,7 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
 			lua_pop(L, npop);
-			lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+			CollectGarbage(heap_before);
 			return ret;
 		}
 		lua_pop(L, npop);
@@ -317,7 +332,7 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 			lua_pop(L, n);
 		}
 	}
-	lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+	CollectGarbage(heap_before);
 	return 0;
 }
 
@@ -361,6 +376,7 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 							std::vector<std::any> *extra_pointers, luabind::adl::object *l_func) {
 	const char *sub_name = LuaEvents[evt];
 	int start = lua_gettop(L);
+	uint64 heap_before = GetHeapBytes();
 
 	try {
 		int npop = 1;
@@ -372,11 +388,9 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, 4);
 		//push self
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		PushClient(client);
 		lua_setfield(L, -2, "self");
 
 		auto arg_function = PlayerArgumentDispatch[evt];
@@ -395,7 +409,7 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
 			lua_pop(L, npop);
-			lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+			CollectGarbage(heap_before);
 			return ret;
 		}
 
@@ -412,7 +426,7 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 			lua_pop(L, n);
 		}
 	}
-	lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+	CollectGarbage(heap_before);
 	return 0;
 }
 
@@ -441,6 +455,7 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 	const char *sub_name = LuaEvents[evt];
 
 	int start = lua_gettop(L);
+	uint64 heap_before = GetHeapBytes();
 
 	try {
 		int npop = 1;
@@ -452,16 +467,14 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, 4);
 		//always push self
 		Lua_ItemInst l_item(item);
 		luabind::adl::object l_item_o = luabind::adl::object(L, l_item);
 		l_item_o.push(L);
 		lua_setfield(L, -2, "self");
 
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		PushClient(client);
 		lua_setfield(L, -2, "owner");
 
 		//redo this arg function
@@ -481,7 +494,7 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
 			lua_pop(L, npop);
-			lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+			CollectGarbage(heap_before);
 			return ret;
 		}
 
@@ -498,7 +511,7 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 			lua_pop(L, n);
 		}
 	}
-	lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+	CollectGarbage(heap_before);
 	return 0;
 }
 
@@ -523,6 +536,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 	const char *sub_name = LuaEvents[evt];
 
 	int start = lua_gettop(L);
+	uint64 heap_before = GetHeapBytes();
 
 	try {
 		int npop = 1;
@@ -534,7 +548,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, 4);
 
 		//always push self even if invalid
 		if(IsValidSpell(spell_id)) {
@@ -557,7 +571,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 			AddError(error);
 			quest_manager.EndQuest();
 			lua_pop(L, npop);
-			lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+			CollectGarbage(heap_before);
 			return 0;
 		}
 		quest_manager.EndQuest();
@@ -565,7 +579,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 		if(lua_isnumber(L, -1)) {
 			int ret = static_cast<int>(lua_tointeger(L, -1));
 			lua_pop(L, npop);
-			lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+			CollectGarbage(heap_before);
 			return ret;
 		}
 
@@ -582,7 +596,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 			lua_pop(L, n);
 		}
 	}
-	lua_gc(L, LUA_GCCOLLECT, 0); // collect garbage
+	CollectGarbage(heap_before);
 	return 0;
 }
 
@@ -611,7 +625,7 @@ int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::
 		lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
 		lua_getfield(L, -1, sub_name);
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, 4);
 		lua_pushstring(L, encounter_name.c_str());
 		lua_setfield(L, -2, "name");
 
@@ -659,10 +673,8 @@ bool LuaParser::HasQuestSub(uint32 npc_id, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "npc_" + std::to_string(npc_id);
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	auto iter = npc_subs_.find(npc_id);
+	return iter != npc_subs_.end() && iter->second.test(evt);
 }
 
 bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
@@ -671,8 +683,7 @@ bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_npc");
+	return global_npc_subs_.test(evt);
 }
 
 bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
@@ -681,8 +692,7 @@ bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "player");
+	return player_subs_.test(evt);
 }
 
 bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
@@ -691,8 +701,7 @@ bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_player");
+	return global_player_subs_.test(evt);
 }
 
 bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
@@ -701,10 +710,8 @@ bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "spell_" + std::to_string(spell_id);
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	auto iter = spell_subs_.find(spell_id);
+	return iter != spell_subs_.end() && iter->second.test(evt);
 }
 
 bool LuaParser::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
@@ -716,11 +723,8 @@ bool LuaParser::ItemHasQuestSub(EQ::ItemInstance *itm, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "item_";
-	package_name += std::to_string(itm->GetID());
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	auto iter = item_subs_.find(itm->GetID());
+	return iter != item_subs_.end() && iter->second.test(evt);
 }
 
 bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID evt) {
@@ -729,28 +733,26 @@ bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID ev
 		return false;
 	}
 
-	std::string package_name = "encounter_" + encounter_name;
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	auto iter = loaded_.find("encounter_" + encounter_name);
+	return iter != loaded_.end() && iter->second.test(evt);
 }
 
 void LuaParser::LoadNPCScript(std::string filename, int npc_id) {
 	std::string package_name = "npc_" + std::to_string(npc_id);
 
-	LoadScript(filename, package_name);
+	npc_subs_[npc_id] = LoadScript(filename, package_name);
 }
 
 void LuaParser::LoadGlobalNPCScript(std::string filename) {
-	LoadScript(filename, "global_npc");
+	global_npc_subs_ = LoadScript(filename, "global_npc");
 }
 
 void LuaParser::LoadPlayerScript(std::string filename) {
-	LoadScript(filename, "player");
+	player_subs_ = LoadScript(filename, "player");
 }
 
 void LuaParser::LoadGlobalPlayerScript(std::string filename) {
-	LoadScript(filename, "global_player");
+	global_player_subs_ = LoadScript(filename, "global_player");
 }
 
 void LuaParser::LoadItemScript(std::string filename, EQ::ItemInstance *item) {
@@ -759,13 +761,13 @@ void LuaParser::LoadItemScript(std::string filename, EQ::ItemInstance *item) {
 	std::string package_name = "item_";
 	package_name += std::to_string(item->GetID());
 
-	LoadScript(filename, package_name);
+	item_subs_[item->GetID()] = LoadScript(filename, package_name);
 }
 
 void LuaParser::LoadSpellScript(std::string filename, uint32 spell_id) {
 	std::string package_name = "spell_" + std::to_string(spell_id);
 
-	LoadScript(filename, package_name);
+	spell_subs_[spell_id] = LoadScript(filename, package_name);
 }
 
 void LuaParser::LoadEncounterScript(std::string filename, std::string encounter_name) {
@@ -791,8 +793,148 @@ void LuaParser::Init() {
 	ReloadQuests();
 }
 
+// after every event, only the legacy policy collects here
+void LuaParser::CollectGarbage(uint64 heap_before) {
+	// a collection step inside the event can leave the heap smaller, those
+	// events still count with nothing added
+	uint64 heap_after = GetHeapBytes();
+	event_count_++;
+	if(heap_after > heap_before) {
+		event_alloc_bytes_ += heap_after - heap_before;
+	}
+
+	if(RuleI(Lua, GCMode) == LuaGCFullPerEvent) {
+		lua_gc(L, LUA_GCCOLLECT, 0);
+	}
+}
+
+// Budgeted policy, once per zone tick. Incremental steps run while a cycle is
+// underway or once the heap has grown a quarter past what the last cycle left,
+// and stop at the time budget. Past the memory limit it collects in full.
+void LuaParser::Process() {
+	ReportScriptLoads();
+
+	if(!L || RuleI(Lua, GCMode) != LuaGCBudgeted) {
+		return;
+	}
+
+	int heap_kb = lua_gc(L, LUA_GCCOUNT, 0);
+	int limit_kb = RuleI(Lua, GCFullCollectKB);
+	if(limit_kb > 0 && heap_kb >= limit_kb) {
+		lua_gc(L, LUA_GCCOLLECT, 0);
+		gc_in_cycle_ = false;
+		gc_floor_kb_ = lua_gc(L, LUA_GCCOUNT, 0);
+		LogQuests("Lua heap reached [{}] KB (limit [{}] KB), full collect left [{}] KB", heap_kb, limit_kb, gc_floor_kb_);
+		return;
+	}
+
+	int budget_us = RuleI(Lua, GCStepBudgetUS);
+	if(budget_us <= 0 || (!gc_in_cycle_ && heap_kb < gc_floor_kb_ + gc_floor_kb_ / 4)) {
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	gc_in_cycle_ = true;
+	do {
+		if(lua_gc(L, LUA_GCSTEP, 0)) {
+			gc_in_cycle_ = false;
+			gc_floor_kb_ = lua_gc(L, LUA_GCCOUNT, 0);
+			break;
+		}
+	} while(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() < budget_us);
+}
+
+uint64 LuaParser::GetHeapKB() {
+	return L ? static_cast<uint64>(lua_gc(L, LUA_GCCOUNT, 0)) : 0;
+}
+
+uint64 LuaParser::GetHeapBytes() {
+	return static_cast<uint64>(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+void LuaParser::GetEventAllocStats(uint64 &events, uint64 &bytes) {
+	events = event_count_;
+	bytes = event_alloc_bytes_;
+}
+
+template<typename W, typename T>
+void LuaParser::PushEntity(T *ent, LuaEntityWrap kind) {
+	if(!ent) {
+		luabind::adl::object(L, W()).push(L);
+		return;
+	}
+
+	int &ref = entity_refs_[ent].ref[kind];
+	if(ref == LUA_NOREF) {
+		luabind::adl::object(L, W(ent)).push(L);
+		lua_pushvalue(L, -1);
+		ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		return;
+	}
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+}
+
+void LuaParser::PushMob(Mob *mob) {
+	PushEntity<Lua_Mob>(mob, LuaWrapMob);
+}
+
+void LuaParser::PushClient(Client *client) {
+	PushEntity<Lua_Client>(client, LuaWrapClient);
+}
+
+void LuaParser::PushNPC(NPC *npc) {
+	PushEntity<Lua_NPC>(npc, LuaWrapNPC);
+}
+
+void LuaParser::RemoveEntity(Mob *mob) {
+	auto iter = entity_refs_.find(mob);
+	if(iter == entity_refs_.end()) {
+		return;
+	}
+
+	for(int i = 0; i < LuaWrapCount; ++i) {
+		int ref = iter->second.ref[i];
+		if(ref == LUA_NOREF) {
+			continue;
+		}
+
+		// null the pointer inside the userdata so scripts holding on to it
+		// get the invalid wrapper behaviour instead of a dangling entity
+		lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+		try {
+			luabind::adl::object obj(luabind::from_stack(L, -1));
+			switch(i) {
+			case LuaWrapMob:
+				luabind::object_cast<Lua_Mob*>(obj)->SetLuaPtrData(nullptr);
+				break;
+			case LuaWrapClient:
+				luabind::object_cast<Lua_Client*>(obj)->SetLuaPtrData(nullptr);
+				break;
+			case LuaWrapNPC:
+				luabind::object_cast<Lua_NPC*>(obj)->SetLuaPtrData(nullptr);
+				break;
+			}
+		} catch(std::exception &ex) {
+			std::string error = "Lua Exception: ";
+			error += std::string(ex.what());
+			AddError(error);
+		}
+		lua_pop(L, 1);
+		luaL_unref(L, LUA_REGISTRYINDEX, ref);
+	}
+
+	entity_refs_.erase(iter);
+}
+
 void LuaParser::ReloadQuests() {
 	loaded_.clear();
+	npc_subs_.clear();
+	item_subs_.clear();
+	spell_subs_.clear();
+	global_npc_subs_.reset();
+	player_subs_.reset();
+	global_player_subs_.reset();
 	errors_.clear();
 	lua_encounter_events_registered.clear();
 	lua_encounters_loaded.clear();
@@ -806,12 +948,16 @@ void LuaParser::ReloadQuests() {
 	// And there is situations where it wouldn't be :P
 	entity_list.EncounterProcess();
 
+	// the wrappers go with the state, entities get new ones on their next event
+	entity_refs_.clear();
 	if(L) {
 		lua_close(L);
 	}
 
 	L = luaL_newstate();
 	luaL_openlibs(L);
+	gc_in_cycle_ = false;
+	gc_floor_kb_ = 0;
 
 	auto top = lua_gettop(L);
 
@@ -906,7 +1052,7 @@ void LuaParser::ReloadQuests() {
 	if(f) {
 		fclose(f);
 
-		if (luaL_dofile(L, filename.c_str())) {
+		if (LoadFile(filename) || lua_pcall(L, 0, LUA_MULTRET, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 		}
@@ -920,7 +1066,7 @@ void LuaParser::ReloadQuests() {
 		if (f) {
 			fclose(f);
 
-			if (luaL_dofile(L, zone_script.c_str())) {
+			if (LoadFile(zone_script) || lua_pcall(L, 0, LUA_MULTRET, 0)) {
 				std::string error = lua_tostring(L, -1);
 				AddError(error);
 			}
@@ -944,18 +1090,59 @@ void LuaParser::RemoveEncounter(const std::string& name)
 	lua_encounters.erase(name);
 }
 
-void LuaParser::LoadScript(std::string filename, std::string package_name) {
+// luaL_loadfile through the bytecode cache, counting toward the load report
+int LuaParser::LoadFile(const std::string &filename) {
+	auto start = std::chrono::steady_clock::now();
+
+	LuaScriptCache::Result result;
+	if(RuleB(Lua, BytecodeCache)) {
+		result = LuaScriptCache::LoadFile(L, filename);
+	} else {
+		result = luaL_loadfile(L, filename.c_str()) ? LuaScriptCache::Failed : LuaScriptCache::Compiled;
+	}
+
+	last_script_load_ = std::chrono::steady_clock::now();
+	script_load_us_ += std::chrono::duration_cast<std::chrono::microseconds>(last_script_load_ - start).count();
+	script_loads_++;
+	if(result == LuaScriptCache::Cached) {
+		script_cache_hits_++;
+	}
+
+	return result == LuaScriptCache::Failed ? 1 : 0;
+}
+
+// Scripts load on demand as the zone fills in, so the report waits for loads
+// to go quiet for a few seconds and covers the whole burst, boot or reload.
+void LuaParser::ReportScriptLoads() {
+	if(script_loads_ == 0 || std::chrono::steady_clock::now() - last_script_load_ < std::chrono::seconds(5)) {
+		return;
+	}
+
+	LogInfo(
+		"Loaded [{}] Lua scripts for [{}] in [{}] ms, [{}] from the bytecode cache",
+		script_loads_,
+		zone ? zone->GetShortName() : "no zone",
+		script_load_us_ / 1000,
+		script_cache_hits_
+	);
+
+	script_loads_ = 0;
+	script_cache_hits_ = 0;
+	script_load_us_ = 0;
+}
+
+LuaEventMask LuaParser::LoadScript(std::string filename, std::string package_name) {
 	auto iter = loaded_.find(package_name);
 	if(iter != loaded_.end()) {
-		return;
+		return iter->second;
 	}
 
 	auto top = lua_gettop(L);
-	if(luaL_loadfile(L, filename.c_str())) {
+	if(LoadFile(filename)) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
-		return;
+		return LuaEventMask();
 	}
 
 	//This makes an env table named: package_name
@@ -978,10 +1165,7 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
-		return;
-	}
-	else {
-		loaded_[package_name] = true;
+		return LuaEventMask();
 	}
 
 	auto end = lua_gettop(L);
@@ -989,26 +1173,26 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 	if (n > 0) {
 		lua_pop(L, n);
 	}
-}
-
-bool LuaParser::HasFunction(std::string subname, std::string package_name) {
-	std::transform(subname.begin(), subname.end(), subname.begin(), ::tolower);
-
-	auto iter = loaded_.find(package_name);
-	if(iter == loaded_.end()) {
-		return false;
-	}
 
+	// the handlers a package defines once its body has run, so the HasQuestSub
+	// family can answer without looking anything up in lua
+	LuaEventMask subs;
 	lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
-	lua_getfield(L, -1, subname.c_str());
+	for(int i = 0; i < _LargestEventID; ++i) {
+		if(!LuaEvents[i]) {
+			continue;
+		}
 
-	if(lua_isfunction(L, -1)) {
-		lua_pop(L, 2);
-		return true;
+		lua_getfield(L, -1, LuaEvents[i]);
+		if(lua_isfunction(L, -1)) {
+			subs.set(i);
+		}
+		lua_pop(L, 1);
 	}
+	lua_pop(L, 1);
 
-	lua_pop(L, 2);
-	return false;
+	loaded_[package_name] = subs;
+	return subs;
 }
 
 bool LuaParser::HasEncounterSub(const std::string& package_name, QuestEventID evt)
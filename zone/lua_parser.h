@@ -4,9 +4,12 @@
 
 #include "quest_parser_collection.h"
 #include "quest_interface.h"
+#include <bitset>
+#include <chrono>
 #include <string>
 #include <list>
 #include <map>
+#include <unordered_map>
 
 #include "zone_config.h"
 
@@ -14,6 +17,7 @@ extern const ZoneConfig *Config;
 
 struct lua_State;
 class Client;
+class Mob;
 class NPC;
 
 namespace EQ
@@ -29,6 +33,22 @@ namespace luabind {
 	}
 }
 
+typedef std::bitset<_LargestEventID> LuaEventMask;
+
+// kinds of wrapper kept per entity, an entity can be handed out as more than one
+enum LuaEntityWrap {
+	LuaWrapMob = 0,
+	LuaWrapClient,
+	LuaWrapNPC,
+	LuaWrapCount
+};
+
+// values of the Lua:GCMode rule
+enum LuaGCMode {
+	LuaGCFullPerEvent = 0,
+	LuaGCBudgeted = 1
+};
+
 class LuaParser : public QuestInterface {
 public:
 	LuaParser();
@@ -72,6 +92,17 @@ public:
 	virtual void ReloadQuests();
     virtual uint32 GetIdentifier() { return 0xb0712acc; }
 	virtual void RemoveEncounter(const std::string& name);
+	virtual void Process();
+	virtual uint64 GetHeapKB();
+	virtual void GetEventAllocStats(uint64 &events, uint64 &bytes);
+	virtual void RemoveEntity(Mob *mob);
+
+	// Push the wrapper for an entity onto the stack. Wrappers are made once,
+	// held in the registry and reused for every event until the entity goes
+	// away, at which point any copy a script kept reads as invalid.
+	void PushMob(Mob *mob);
+	void PushClient(Client *client);
+	void PushNPC(NPC *npc);
 
 	virtual int DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 		std::vector<std::any> *extra_pointers);
@@ -94,15 +125,44 @@ private:
 	int _EventEncounter(std::string package_name, QuestEventID evt, std::string encounter_name, std::string data, uint32 extra_data,
 		std::vector<std::any> *extra_pointers);
 
-	void LoadScript(std::string filename, std::string package_name);
-	bool HasFunction(std::string function, std::string package_name);
+	LuaEventMask LoadScript(std::string filename, std::string package_name);
+	int LoadFile(const std::string &filename);
+	void ReportScriptLoads();
 	void ClearStates();
 	void MapFunctions(lua_State *L);
 	QuestEventID ConvertLuaEvent(QuestEventID evt);
+	void CollectGarbage(uint64 heap_before);
+	uint64 GetHeapBytes();
+	template<typename W, typename T>
+	void PushEntity(T *ent, LuaEntityWrap kind);
 
 	std::map<std::string, std::string> vars_;
-	std::map<std::string, bool> loaded_;
+	// loaded packages and the event handlers each one defines
+	std::map<std::string, LuaEventMask> loaded_;
+	std::unordered_map<uint32, LuaEventMask> npc_subs_;
+	std::unordered_map<uint32, LuaEventMask> item_subs_;
+	std::unordered_map<uint32, LuaEventMask> spell_subs_;
+	LuaEventMask global_npc_subs_;
+	LuaEventMask player_subs_;
+	LuaEventMask global_player_subs_;
 	lua_State *L;
+	// budgeted gc: whether a cycle is underway and the heap the last one left
+	bool gc_in_cycle_;
+	int gc_floor_kb_;
+	// heap growth across events, from argument setup until the handler returns
+	uint64 event_count_;
+	uint64 event_alloc_bytes_;
+	// registry references to each entity's wrappers, LUA_NOREF where not made yet
+	struct EntityRefs {
+		int ref[LuaWrapCount];
+		EntityRefs();
+	};
+	std::unordered_map<const Mob*, EntityRefs> entity_refs_;
+	// scripts loaded since the last report, see ReportScriptLoads
+	uint32 script_loads_;
+	uint32 script_cache_hits_;
+	uint64 script_load_us_;
+	std::chrono::steady_clock::time_point last_script_load_;
 
 	NPCArgumentHandler NPCArgumentDispatch[_LargestEventID];
 	PlayerArgumentHandler PlayerArgumentDispatch[_LargestEventID];
@@ -22,6 +22,7 @@
 #include "lua_packet.h"
 #include "lua_encounter.h"
 #include "zone.h"
+#include "lua_parser.h"
 #include "lua_parser_events.h"
 
 //NPC
@@ -36,9 +37,7 @@ void handle_npc_event_say(
 ) {
 	npc->DoQuestPause(init);
 
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 
 	lua_pushstring(L, data.c_str());
@@ -57,9 +56,7 @@ void handle_npc_event_trade(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 	
 	lua_createtable(L, 0, 0);
@@ -109,7 +106,7 @@ void handle_npc_event_trade(
 		lua_setfield(L, -2, "enable_multiquest");
 	}
 	// set a reference to the client inside of the trade object as well for plugins to process
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 
 	lua_setfield(L, -2, "trade");
@@ -148,9 +145,7 @@ void handle_npc_single_mob(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(init);
 	lua_setfield(L, -2, "other");
 }
 
@@ -163,9 +158,7 @@ void handle_npc_single_client(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 }
 
@@ -178,9 +171,7 @@ void handle_npc_single_npc(
 	uint32 extra_data,
 	std::vector<std::any> *extra_pointers
 ) {
-	Lua_NPC l_npc(reinterpret_cast<NPC*>(init));
-	luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-	l_npc_o.push(L);
+	static_cast<LuaParser*>(parse)->PushNPC(reinterpret_cast<NPC*>(init));
 	lua_setfield(L, -2, "other");
 }
 
@@ -193,9 +184,7 @@ void handle_npc_waypoint(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(init);
 	lua_setfield(L, -2, "other");
 	Seperator sep(data.c_str());
 
@@ -215,9 +204,7 @@ void handle_npc_hate(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(init);
 	lua_setfield(L, -2, "other");
 
 	lua_pushboolean(L, Strings::ToBool(data) == 0 ? false : true);
@@ -266,17 +253,13 @@ void handle_npc_death(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(init);
 	lua_setfield(L, -2, "other");
 
 	Seperator sep(data.c_str());
 
 	Mob* killer = entity_list.GetMob(Strings::ToInt(sep.arg[0]));
-	Lua_Mob l_mob2(killer);
-	luabind::adl::object l_mob_o2 = luabind::adl::object(L, l_mob2);
-	l_mob_o2.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(killer);
 	lua_setfield(L, -2, "killer");
 
 	lua_pushinteger(L, Strings::ToInt(sep.arg[1]));
@@ -432,9 +415,7 @@ void handle_player_death(
 	Seperator sep(data.c_str());
 
 	Mob *o = entity_list.GetMobID(std::stoi(sep.arg[0]));
-	Lua_Mob l_mob(o);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(o);
 	lua_setfield(L, -2, "other");
 
 	lua_pushinteger(L, Strings::ToInt(sep.arg[1]));
@@ -606,9 +587,7 @@ void handle_player_duel_win(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Client l_client(std::any_cast<Client*>(extra_pointers->at(1)));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(std::any_cast<Client*>(extra_pointers->at(1)));
 	lua_setfield(L, -2, "other");
 }
 
@@ -620,9 +599,7 @@ void handle_player_duel_loss(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Client l_client(std::any_cast<Client*>(extra_pointers->at(0)));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	static_cast<LuaParser*>(parse)->PushClient(std::any_cast<Client*>(extra_pointers->at(0)));
 	lua_setfield(L, -2, "other");
 }
 
@@ -693,9 +670,7 @@ void handle_player_feign(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_NPC l_npc(std::any_cast<NPC*>(extra_pointers->at(0)));
-	luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-	l_npc_o.push(L);
+	static_cast<LuaParser*>(parse)->PushNPC(std::any_cast<NPC*>(extra_pointers->at(0)));
 	lua_setfield(L, -2, "other");
 }
 
@@ -795,9 +770,7 @@ void handle_item_proc(
 	uint32 extra_data,
 	std::vector<std::any>* extra_pointers
 ) {
-	Lua_Mob l_mob(mob);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	static_cast<LuaParser*>(parse)->PushMob(mob);
 	lua_setfield(L, -2, "target");
 
 	if(IsValidSpell(extra_data)) {
@@ -873,17 +846,11 @@ void handle_spell_effect(
 	std::vector<std::any> *extra_pointers
 ) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -905,17 +872,11 @@ void handle_spell_tic(
 	std::vector<std::any> *extra_pointers
 ) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -943,17 +904,11 @@ void handle_spell_fade(
 	std::vector<std::any> *extra_pointers
 ) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -975,17 +930,11 @@ void handle_translocate_finish(
 	std::vector<std::any> *extra_pointers
 ) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		static_cast<LuaParser*>(parse)->PushMob(nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
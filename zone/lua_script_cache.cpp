@@ -0,0 +1,181 @@
+#ifdef LUA_EQEMU
+
+#include "lua.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include "../common/crc32.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/path_manager.h"
+#include "../common/serverinfo.h"
+#include "lua_script_cache.h"
+
+namespace fs = std::filesystem;
+
+static const char   CacheMagic[4] = { 'E', 'Q', 'L', 'C' };
+static const uint32 CacheFormat   = 1;
+
+struct LuaScriptCacheHeader {
+	char   magic[4];
+	uint32 format;
+	int64  mtime;
+	uint64 size;
+	uint32 source_length;
+	uint32 build_length;
+};
+
+// bytecode only loads on the Lua build and word size that wrote it
+static std::string GetBuildTag()
+{
+#ifdef LUAJIT_VERSION
+	return fmt::format("{} {}", LUAJIT_VERSION, sizeof(void *) * 8);
+#else
+	return fmt::format("{} {}", LUA_RELEASE, sizeof(void *) * 8);
+#endif
+}
+
+static int WriteChunk(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	static_cast<std::string *>(ud)->append(static_cast<const char *>(p), sz);
+	return 0;
+}
+
+LuaScriptCache::Result LuaScriptCache::LoadFile(lua_State *L, const std::string &filename)
+{
+	// zone and the warm-cache command name files differently, key on the full path
+	std::error_code ec;
+	std::string     source = fs::absolute(filename, ec).lexically_normal().string();
+	int64           mtime  = 0;
+	uint64          size   = 0;
+	if (!ec) {
+		mtime = fs::last_write_time(source, ec).time_since_epoch().count();
+	}
+	if (!ec) {
+		size = fs::file_size(source, ec);
+	}
+
+	// missing or unreadable source, let lua report it
+	if (ec) {
+		return luaL_loadfile(L, filename.c_str()) ? Failed : Compiled;
+	}
+
+	std::string entry = GetEntryPath(source);
+	std::string chunk;
+	if (ReadEntry(entry, source, mtime, size, chunk)) {
+		std::string chunk_name = "@" + filename;
+		if (luaL_loadbuffer(L, chunk.data(), chunk.size(), chunk_name.c_str()) == 0) {
+			return Cached;
+		}
+
+		LogQuestsDetail("Discarding unloadable bytecode cache entry [{}] for [{}]", entry, filename);
+		lua_pop(L, 1);
+	}
+
+	if (luaL_loadfile(L, filename.c_str())) {
+		return Failed;
+	}
+
+	chunk.clear();
+	if (lua_dump(L, WriteChunk, &chunk) == 0 && !chunk.empty()) {
+		WriteEntry(entry, source, mtime, size, chunk);
+	}
+
+	return Compiled;
+}
+
+std::string LuaScriptCache::GetCacheDirectory()
+{
+	return fmt::format("{}/cache/lua", path.GetServerPath());
+}
+
+std::string LuaScriptCache::GetEntryPath(const std::string &source)
+{
+	uint32 crc = CRC32::Generate(reinterpret_cast<const uint8 *>(source.data()), static_cast<uint32>(source.size()));
+	return fmt::format("{}/{:08x}_{}c", GetCacheDirectory(), crc, fs::path(source).filename().string());
+}
+
+bool LuaScriptCache::ReadEntry(const std::string &entry, const std::string &source, int64 mtime, uint64 size, std::string &chunk)
+{
+	FILE *f = fopen(entry.c_str(), "rb");
+	if (!f) {
+		return false;
+	}
+
+	std::string          build = GetBuildTag();
+	LuaScriptCacheHeader header;
+	bool                 fresh = fread(&header, sizeof(header), 1, f) == 1 &&
+		memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) == 0 &&
+		header.format == CacheFormat &&
+		header.mtime == mtime &&
+		header.size == size &&
+		header.source_length == source.size() &&
+		header.build_length == build.size();
+
+	// the entry name is a hash, the full source path and build are stored to check against
+	if (fresh) {
+		std::string stored(header.source_length + header.build_length, '\0');
+		fresh = fread(&stored[0], stored.size(), 1, f) == 1 &&
+			stored.compare(0, source.size(), source) == 0 &&
+			stored.compare(source.size(), build.size(), build) == 0;
+	}
+
+	if (fresh) {
+		long start = ftell(f);
+		fseek(f, 0, SEEK_END);
+		long end = ftell(f);
+		fseek(f, start, SEEK_SET);
+
+		fresh = start >= 0 && end > start;
+		if (fresh) {
+			chunk.resize(end - start);
+			fresh = fread(&chunk[0], chunk.size(), 1, f) == 1;
+		}
+	}
+
+	fclose(f);
+	return fresh;
+}
+
+void LuaScriptCache::WriteEntry(const std::string &entry, const std::string &source, int64 mtime, uint64 size, const std::string &chunk)
+{
+	std::error_code ec;
+	fs::create_directories(GetCacheDirectory(), ec);
+
+	std::string          build = GetBuildTag();
+	LuaScriptCacheHeader header;
+	memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+	header.format        = CacheFormat;
+	header.mtime         = mtime;
+	header.size          = size;
+	header.source_length = static_cast<uint32>(source.size());
+	header.build_length  = static_cast<uint32>(build.size());
+
+	// several zones can compile the same script at once, each writes its own
+	// file and renames it over the entry so readers never see a partial one
+	std::string temp = fmt::format("{}.{}.tmp", entry, EQ::GetPID());
+	FILE        *f   = fopen(temp.c_str(), "wb");
+	if (!f) {
+		LogQuestsDetail("Unable to write bytecode cache entry [{}]", temp);
+		return;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		fwrite(source.data(), source.size(), 1, f) == 1 &&
+		fwrite(build.data(), build.size(), 1, f) == 1 &&
+		fwrite(chunk.data(), chunk.size(), 1, f) == 1;
+	written = fclose(f) == 0 && written;
+
+	if (written) {
+		fs::rename(temp, entry, ec);
+	}
+
+	if (!written || ec) {
+		LogQuestsDetail("Unable to write bytecode cache entry [{}]", entry);
+		fs::remove(temp, ec);
+	}
+}
+
+#endif
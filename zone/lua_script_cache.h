@@ -0,0 +1,37 @@
+#ifndef EQEMU_LUA_SCRIPT_CACHE_H
+#define EQEMU_LUA_SCRIPT_CACHE_H
+#ifdef LUA_EQEMU
+
+#include <string>
+
+#include "../common/types.h"
+
+struct lua_State;
+
+/*
+ * On disk cache of compiled quest scripts. Each source file has one entry
+ * under cache/lua holding its bytecode along with the source path, size and
+ * modification time it was built from and the Lua build that made it. An
+ * entry that doesn't match all of those is ignored and the source compiled
+ * again, so editing a script never needs the cache cleared by hand.
+ */
+class LuaScriptCache {
+public:
+	enum Result {
+		Failed = 0, // didn't compile, the error message is on the stack
+		Cached,     // chunk came from the cache
+		Compiled    // chunk came from the source and the cache was refreshed
+	};
+
+	// luaL_loadfile that goes through the cache, leaves the chunk on the stack
+	static Result LoadFile(lua_State *L, const std::string &filename);
+	static std::string GetCacheDirectory();
+
+private:
+	static std::string GetEntryPath(const std::string &source);
+	static bool ReadEntry(const std::string &entry, const std::string &source, int64 mtime, uint64 size, std::string &chunk);
+	static void WriteEntry(const std::string &entry, const std::string &source, int64 mtime, uint64 size, const std::string &chunk);
+};
+
+#endif
+#endif
@@ -94,7 +94,13 @@ extern volatile bool is_zone_loaded;
 #include "zone_event_scheduler.h"
 #include "../common/file.h"
 #include "../common/path_manager.h"
+#include "../common/timer_wheel.h"
+#include "tick_profiler.h"
+#include "zone_cli.h"
 
+//entities cancel their wheel timers as they're destroyed, keep this ahead of entity_list
+TimerWheel  timer_wheel;
+TickProfiler tick_profiler(32);
 EntityList  entity_list;
 WorldServer worldserver;
 ZoneStore zone_store;
@@ -113,6 +119,7 @@ WorldContentService   content_service;
 PathManager           path;
 SkillCaps             skill_caps;
 const SPDat_Spell_Struct* spells;
+const SPDat_Spell_Class* spell_classes = nullptr;
 std::map<std::tuple<int,int,int>, SpellModifier_Struct> spellModifiers;
 int32 SPDAT_RECORDS = -1;
 const ZoneConfig *Config;
@@ -135,6 +142,9 @@ int main(int argc, char** argv) {
 
 	path.LoadPaths();
 
+	// exits when argv names a command, otherwise the arguments are a zone to boot
+	ZoneCLI::CommandHandler(argc, argv);
+
 	QServ = new QueryServ;
 
 	LogInfo("Loading server configuration..");
@@ -310,7 +320,7 @@ int main(int argc, char** argv) {
 		LogError("Failed. But ignoring error and going on...");
 	}
 
-	if(!database.LoadSpells(hotfix_name, &SPDAT_RECORDS, &spells)) {
+	if(!database.LoadSpells(hotfix_name, &SPDAT_RECORDS, &spells, &spell_classes)) {
 		LogError("Loading spells FAILED!");
 		return 1;
 	}
@@ -394,6 +404,7 @@ int main(int argc, char** argv) {
 			//profiler block to omit the sleep from times
 			//Advance the timer to our current point in time
 			Timer::SetCurrentTime();
+			tick_profiler.StartTick();
 
 			/**
 			* Calculate frame time
@@ -471,21 +482,40 @@ int main(int argc, char** argv) {
 				}
 			}
 
+			tick_profiler.Lap(TickPhase::Network);
+
 			if (is_zone_loaded)
 			{
+				timer_wheel.Advance();
+				tick_profiler.Lap(TickPhase::TimerWheel);
+
 				entity_list.GroupProcess();
+				tick_profiler.Lap(TickPhase::Groups);
 				entity_list.DoorProcess();
+				tick_profiler.Lap(TickPhase::Doors);
 				entity_list.ObjectProcess();
+				tick_profiler.Lap(TickPhase::Objects);
 				entity_list.CorpseProcess();
+				tick_profiler.Lap(TickPhase::Corpses);
 				entity_list.CorpseDepopProcess();
+				tick_profiler.Lap(TickPhase::CorpseDepop);
 				entity_list.TrapProcess();
+				tick_profiler.Lap(TickPhase::Traps);
 				entity_list.RaidProcess();
+				tick_profiler.Lap(TickPhase::Raids);
 
 				entity_list.Process();
+				tick_profiler.Lap(TickPhase::Entities);
+				entity_list.AIDecideProcess();
+				tick_profiler.Lap(TickPhase::AIDecide);
 				entity_list.MobProcess();
+				tick_profiler.Lap(TickPhase::Mobs);
 				entity_list.BeaconProcess();
+				tick_profiler.Lap(TickPhase::Beacons);
 				entity_list.EncounterProcess();
+				tick_profiler.Lap(TickPhase::Encounters);
 				event_scheduler.Process(zone, &content_service);
+				tick_profiler.Lap(TickPhase::EventScheduler);
 
 				if (zone) {
 					// this was put in to appease concerns about the RNG being affected by the time of day or day of week the server was started on, resulting in bad loot
@@ -499,10 +529,14 @@ int main(int argc, char** argv) {
 						Zone::Shutdown();
 					}
 				}
+				tick_profiler.Lap(TickPhase::Zone);
 
 				if (quest_timers.Check()) {
 					quest_manager.Process();
 				}
+				tick_profiler.Lap(TickPhase::QuestTimers);
+				parse->Process();
+				tick_profiler.Lap(TickPhase::QuestGC);
 			}
 			if (InterserverTimer.Check()) {
 				InterserverTimer.Start();
@@ -511,6 +545,8 @@ int main(int argc, char** argv) {
 				entity_list.UpdateWho();
 
 			}
+			tick_profiler.Lap(TickPhase::Interserver);
+			tick_profiler.EndTick();
 
 #ifdef EQPROFILE
 #ifdef PROFILE_DUMP_TIME
@@ -2,21 +2,31 @@
 #include "../common/misc_functions.h"
 
 #include "map.h"
+#include "raycast_bvh.h"
 #include "raycast_mesh.h"
 #include "zone.h"
 #include "../common/file.h"
 #include "../common/path_manager.h"
 #include "../common/misc_functions.h"
+#include "../common/rulesys.h"
+#include "../common/ipc_mutex.h"
+#include "../common/memory_mapped_file.h"
+#include "../common/eqemu_logsys.h"
 
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <map>
 #include <memory>
+#include <random>
 #include <tuple>
 #include <vector>
 #include <zlib.h>
 
 extern Zone* zone;
 
+namespace fs = std::filesystem;
+
 uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_len_max) {
 	z_stream zstream;
 	int zerror = 0;
@@ -53,9 +63,32 @@ uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_
 
 struct Map::impl
 {
-	RaycastMesh *rm;
+	RaycastMesh *rm = nullptr;
+	// backs rm when it was mapped from a shared file
+	std::unique_ptr<EQ::MemoryMappedFile> mmf;
+};
+
+// start of a shared map file, the BVH block written by writeRaycastBVH follows
+struct SharedMapHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint64 source_size;	// the .map it was built from, a changed .map means a rebuild
+	int64 source_time;
+	uint32 bvh_size;
+	uint32 reserved;
 };
 
+static const uint32 SharedMapMagic = 0x424D5145;	// "EQMB"
+static const uint32 SharedMapVersion = 1;
+
+static RaycastMesh *CreateMapMesh(RmUint32 vcount, const RmReal *vertices, RmUint32 tcount, const RmUint32 *indices) {
+	if (RuleB(Map, UseWideBVH))
+		return createRaycastBVH(vcount, vertices, tcount, indices, RuleB(Map, UseHeightField));
+
+	return createRaycastMesh(vcount, vertices, tcount, indices);
+}
+
 Map::Map() {
 	imp = nullptr;
 }
@@ -374,6 +407,131 @@ bool Map::CheckLoS(glm::vec3 myloc, glm::vec3 oloc) const {
 	return !imp->rm->raycast((const RmReal*)&myloc, (const RmReal*)&oloc, nullptr, nullptr, nullptr);
 }
 
+void Map::CheckLoSBatch(const glm::vec3 &myloc, const glm::vec3 *olocs, size_t count, bool *results) const {
+	if (!imp) {
+		std::fill(results, results + count, false);
+		return;
+	}
+
+	std::vector<glm::vec3> from(count, myloc);
+	imp->rm->raycastBatch((RmUint32)count, (const RmReal*)from.data(), (const RmReal*)olocs, results);
+	for (size_t i = 0; i < count; ++i)
+		results[i] = !results[i];
+}
+
+bool Map::SupportsConcurrentLoS() const {
+	// the wide BVH keeps no per query state, the original tree does
+	return imp && getRaycastBVHSize(imp->rm) != 0;
+}
+
+bool Map::RunRaycastBenchmark(uint32 rays, uint32 brute_rays, RaycastBenchmark &out) const {
+	out = RaycastBenchmark();
+	if (!imp || rays == 0)
+		return false;
+
+	RaycastMesh *active = imp->rm;
+	RmUint32 vcount = active->getVertexCount();
+	RmUint32 tcount = active->getTriangleCount();
+	RaycastMesh *bvh = createRaycastBVH(vcount, active->getVertices(), tcount, active->getIndices());
+	RaycastMesh *tree = createRaycastMesh(vcount, active->getVertices(), tcount, active->getIndices());
+
+	// segments of aggro / spell range length between random points in the zone bounds,
+	// seeded so repeated runs on one zone trace the same rays
+	const RmReal *bmin = active->getBoundMin();
+	const RmReal *bmax = active->getBoundMax();
+	std::mt19937 gen(0x5EED);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<glm::vec3> from(rays), to(rays);
+	for (uint32 i = 0; i < rays; ++i) {
+		for (int axis = 0; axis < 3; ++axis) {
+			from[i][axis] = bmin[axis] + (bmax[axis] - bmin[axis]) * unit(gen);
+			to[i][axis] = from[i][axis] + (unit(gen) * 2.0f - 1.0f) * 300.0f;
+		}
+	}
+
+	auto time_ms = [](std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	std::vector<uint8> tree_hits(rays), bvh_hits(rays);
+	std::vector<float> tree_dist(rays), bvh_dist(rays);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rays; ++i)
+		tree_hits[i] = tree->raycast((const RmReal*)&from[i], (const RmReal*)&to[i], nullptr, nullptr, &tree_dist[i]);
+	out.tree_ms = time_ms(start);
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rays; ++i)
+		bvh_hits[i] = bvh->raycast((const RmReal*)&from[i], (const RmReal*)&to[i], nullptr, nullptr, &bvh_dist[i]);
+	out.bvh_ms = time_ms(start);
+
+	std::unique_ptr<bool[]> batch_hits(new bool[rays]);
+	start = std::chrono::steady_clock::now();
+	bvh->raycastBatch(rays, (const RmReal*)from.data(), (const RmReal*)to.data(), batch_hits.get());
+	out.bvh_batch_ms = time_ms(start);
+
+	out.rays = rays;
+	out.triangles = tcount;
+	for (uint32 i = 0; i < rays; ++i) {
+		if (bvh_hits[i])
+			out.hits++;
+		if (tree_hits[i] != bvh_hits[i] || (bvh_hits[i] && std::abs(tree_dist[i] - bvh_dist[i]) > 0.001f))
+			out.tree_mismatches++;
+		if (batch_hits[i] != (bvh_hits[i] != 0))
+			out.batch_mismatches++;
+	}
+
+	// brute force is linear in the triangle count, only a slice of the rays are run through it
+	out.brute_rays = std::min(rays, brute_rays);
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < out.brute_rays; ++i) {
+		float dist = 0.0f;
+		bool hit = bvh->bruteForceRaycast((const RmReal*)&from[i], (const RmReal*)&to[i], nullptr, nullptr, &dist);
+		if (hit != (bvh_hits[i] != 0) || (hit && dist != bvh_dist[i]))
+			out.brute_mismatches++;
+	}
+	out.brute_ms = time_ms(start);
+
+	// FindBestZ style drops straight down from random points, through the height field and
+	// through the tree walk it stands in for
+	RaycastMesh *height_field = createRaycastBVH(vcount, active->getVertices(), tcount, active->getIndices(), true);
+	RaycastHeightFieldInfo info;
+	getRaycastBVHHeightField(height_field, info);
+	out.height_field_cells = info.cells_x * info.cells_y;
+	out.height_field_dense_cells = info.dense_cells;
+	out.height_field_cell_size = info.cell_size;
+
+	for (uint32 i = 0; i < rays; ++i) {
+		to[i] = glm::vec3(from[i].x, from[i].y, BEST_Z_INVALID);
+	}
+
+	std::vector<glm::vec3> bvh_loc(rays), field_loc(rays);
+	std::vector<uint8> field_hits(rays);
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rays; ++i)
+		bvh_hits[i] = bvh->raycast((const RmReal*)&from[i], (const RmReal*)&to[i], (RmReal*)&bvh_loc[i], nullptr, nullptr);
+	out.vertical_bvh_ms = time_ms(start);
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rays; ++i)
+		field_hits[i] = height_field->raycast((const RmReal*)&from[i], (const RmReal*)&to[i], (RmReal*)&field_loc[i], nullptr, nullptr);
+	out.height_field_ms = time_ms(start);
+
+	out.vertical_rays = rays;
+	for (uint32 i = 0; i < rays; ++i) {
+		if (field_hits[i])
+			out.vertical_hits++;
+		if (field_hits[i] != bvh_hits[i] || (field_hits[i] && field_loc[i].z != bvh_loc[i].z))
+			out.height_field_mismatches++;
+	}
+
+	height_field->release();
+	tree->release();
+	bvh->release();
+	return true;
+}
+
 // returns true if a collision happens
 bool Map::DoCollisionCheck(glm::vec3 myloc, glm::vec3 oloc, glm::vec3& outnorm, float& distance) const {
 	if (!imp)
@@ -387,7 +545,8 @@ Map *Map::LoadMapFile(std::string file) {
 	std::string filename = fmt::format("{}/{}.map", path.GetMapsPath(), file);
 
 	auto m = new Map();
-	if (m->Load(filename)) {
+	bool shared = RuleB(Map, UseWideBVH) && RuleB(Map, UseSharedMapFiles);
+	if (shared ? m->LoadShared(filename, file) : m->Load(filename)) {
 		return m;
 	}
 
@@ -395,6 +554,150 @@ Map *Map::LoadMapFile(std::string file) {
 	return nullptr;
 }
 
+/**
+ * Zones share one prebuilt BVH per map through a memory mapped file in the shared
+ * memory directory. The first zone to boot a map builds it from the .map and writes
+ * the file, every zone after that maps it in place and skips the inflate and build.
+ *
+ * @param filename
+ * @param name
+ * @return
+ */
+bool Map::LoadShared(const std::string& filename, const std::string& name) {
+	std::error_code ec;
+	uint64 source_size = fs::file_size(filename, ec);
+	if (ec) {
+		return false;
+	}
+	int64 source_time = fs::last_write_time(filename, ec).time_since_epoch().count();
+	if (ec) {
+		return false;
+	}
+
+	std::string shared_dir = fmt::format("{}/maps", path.GetSharedMemoryPath());
+	std::string shared_file = fmt::format("{}/{}.bvh", shared_dir, name);
+
+	try {
+		// keeps zones booting the same map at once from all building it
+		EQ::IPCMutex mutex(fmt::format("map_{}", name));
+		mutex.Lock();
+
+		if (OpenShared(shared_file, source_size, source_time)) {
+			LogInfo("Mapped shared map file [{}]", shared_file);
+			return true;
+		}
+
+		if (!Load(filename)) {
+			return false;
+		}
+
+		if (WriteShared(shared_dir, shared_file, source_size, source_time) && OpenShared(shared_file, source_size, source_time)) {
+			LogInfo("Wrote shared map file [{}]", shared_file);
+		}
+	} catch (std::exception &ex) {
+		LogError("Shared map file [{}] unavailable: {}", shared_file, ex.what());
+		return imp != nullptr || Load(filename);
+	}
+
+	return imp != nullptr;
+}
+
+bool Map::OpenShared(const std::string& shared_file, uint64 source_size, int64 source_time) {
+	// a truncated or empty file from a zone that died mid write gets rebuilt, not mapped
+	std::error_code ec;
+	uint64 file_size = fs::file_size(shared_file, ec);
+	if (ec || file_size < sizeof(SharedMapHeader)) {
+		return false;
+	}
+
+	// every zone on this map shares the pages, map them read only so a stray write
+	// faults in the zone that made it rather than corrupting the others
+	std::unique_ptr<EQ::MemoryMappedFile> mmf;
+	try {
+		mmf = std::make_unique<EQ::MemoryMappedFile>(shared_file, EQ::MemoryMappedFile::ReadOnly());
+	} catch (std::exception &) {
+		return false;
+	}
+
+	if (mmf->Size() < sizeof(SharedMapHeader)) {
+		return false;
+	}
+
+	SharedMapHeader header;
+	memcpy(&header, mmf->Get(), sizeof(header));
+	if (header.magic != SharedMapMagic || header.version != SharedMapVersion ||
+		header.source_size != source_size || header.source_time != source_time ||
+		header.bvh_size != mmf->Size() - sizeof(header)) {
+		return false;
+	}
+
+	RaycastMesh *rm = createRaycastBVHView(reinterpret_cast<const char*>(mmf->Get()) + sizeof(header), header.bvh_size);
+	if (!rm) {
+		return false;
+	}
+
+	// built before Map:UseHeightField was flipped, rebuild it the way the rule asks for
+	RaycastHeightFieldInfo height_field;
+	if (getRaycastBVHHeightField(rm, height_field) != RuleB(Map, UseHeightField)) {
+		rm->release();
+		return false;
+	}
+
+	if (imp) {
+		imp->rm->release();
+	} else {
+		imp = new impl;
+	}
+
+	imp->rm = rm;
+	imp->mmf = std::move(mmf);
+	return true;
+}
+
+bool Map::WriteShared(const std::string& shared_dir, const std::string& shared_file, uint64 source_size, int64 source_time) const {
+	uint32 bvh_size = imp ? getRaycastBVHSize(imp->rm) : 0;
+	if (bvh_size == 0) {
+		return false;
+	}
+
+	std::error_code ec;
+	fs::create_directories(shared_dir, ec);
+
+	// written aside and renamed over the old file, zones still running on the old
+	// file keep their mapping of it
+	std::string temp_file = shared_file + ".tmp";
+	bool written = false;
+	{
+		EQ::MemoryMappedFile mmf(temp_file, sizeof(SharedMapHeader) + bvh_size);
+		mmf.ZeroFile();
+
+		SharedMapHeader header = {};
+		header.magic = SharedMapMagic;
+		header.version = SharedMapVersion;
+		header.source_size = source_size;
+		header.source_time = source_time;
+		header.bvh_size = bvh_size;
+
+		char *data = reinterpret_cast<char*>(mmf.Get());
+		memcpy(data, &header, sizeof(header));
+		written = writeRaycastBVH(imp->rm, data + sizeof(header), bvh_size);
+	}
+
+	if (!written) {
+		fs::remove(temp_file, ec);
+		return false;
+	}
+
+	fs::rename(temp_file, shared_file, ec);
+	if (ec) {
+		LogError("Unable to write shared map file [{}]: {}", shared_file, ec.message());
+		fs::remove(temp_file, ec);
+		return false;
+	}
+
+	return true;
+}
+
 /**
  * @param filename
  * @return
@@ -480,11 +783,12 @@ bool Map::LoadV1(FILE *f) {
 	if(imp) {
 		imp->rm->release();
 		imp->rm = nullptr;
+		imp->mmf.reset();
 	} else {
 		imp = new impl;
 	}
 	
-	imp->rm = createRaycastMesh((RmUint32)verts.size(), (const RmReal*)&verts[0], face_count, &indices[0]);
+	imp->rm = CreateMapMesh((RmUint32)verts.size(), (const RmReal*)&verts[0], face_count, &indices[0]);
 	
 	if(!imp->rm) {
 		delete imp;
@@ -1104,12 +1408,13 @@ bool Map::LoadV2(FILE *f) {
 	if (imp) {
 		imp->rm->release();
 		imp->rm = nullptr;
+		imp->mmf.reset();
 	}
 	else {
 		imp = new impl;
 	}
 
-	imp->rm = createRaycastMesh((RmUint32)verts.size(), (const RmReal*)&verts[0], face_count, &indices[0]);
+	imp->rm = CreateMapMesh((RmUint32)verts.size(), (const RmReal*)&verts[0], face_count, &indices[0]);
 
 	if (!imp->rm) {
 		delete imp;
@@ -37,6 +37,28 @@ uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_
 class Map
 {
 public:
+	struct RaycastBenchmark {
+		uint32 rays = 0;
+		uint32 triangles = 0;
+		uint32 hits = 0;
+		double tree_ms = 0.0;
+		double bvh_ms = 0.0;
+		double bvh_batch_ms = 0.0;
+		uint32 brute_rays = 0;
+		double brute_ms = 0.0;
+		uint32 tree_mismatches = 0;
+		uint32 batch_mismatches = 0;
+		uint32 brute_mismatches = 0;
+		uint32 vertical_rays = 0;
+		uint32 vertical_hits = 0;
+		double vertical_bvh_ms = 0.0;
+		double height_field_ms = 0.0;
+		uint32 height_field_mismatches = 0;
+		uint32 height_field_cells = 0;
+		uint32 height_field_dense_cells = 0;
+		float height_field_cell_size = 0.0f;
+	};
+
 	Map();
 	~Map();
 
@@ -49,16 +71,27 @@ public:
 	bool LineIntersectsZoneCeiling(glm::vec3 start, glm::vec3 end, float step, glm::vec3 *hitLocation, glm::vec3 *hitNormal = nullptr, float *hitDistance = nullptr) const;
 	bool LineIntersectsZoneNoZLeaps(glm::vec3 start, glm::vec3 end, float step_mag, glm::vec3 *result) const;
 	bool CheckLoS(glm::vec3 myloc, glm::vec3 oloc) const;
+	// results[i] is CheckLoS(myloc, olocs[i]), traced in one pass for AE and aggro scans.
+	void CheckLoSBatch(const glm::vec3 &myloc, const glm::vec3 *olocs, size_t count, bool *results) const;
+	// true when CheckLoS may be called from several threads at once
+	bool SupportsConcurrentLoS() const;
 	bool DoCollisionCheck(glm::vec3 myloc, glm::vec3 oloc, glm::vec3& outnorm, float& distance) const;
 	bool Load(const std::string& filename);
 	static Map *LoadMapFile(std::string file);
 	bool NoHazardsAccurate(glm::vec3 From, glm::vec3 To, float size = 6.0f, int max_steps = 20, float interval = 5.0f);
+	// times the same random segments through the original binary tree, the wide BVH and
+	// a brute force scan of the loaded map, and counts where their answers differ. Also
+	// drops vertical rays through the BVH with and without its height field.
+	bool RunRaycastBenchmark(uint32 rays, uint32 brute_rays, RaycastBenchmark &out) const;
 private:
 	void RotateVertex(glm::vec3 &v, float rx, float ry, float rz);
 	void ScaleVertex(glm::vec3 &v, float sx, float sy, float sz);
 	void TranslateVertex(glm::vec3 &v, float tx, float ty, float tz);
 	bool LoadV1(FILE *f);
 	bool LoadV2(FILE *f);
+	bool LoadShared(const std::string& filename, const std::string& name);
+	bool OpenShared(const std::string& shared_file, uint64 source_size, int64 source_time);
+	bool WriteShared(const std::string& shared_dir, const std::string& shared_file, uint64 source_size, int64 source_time) const;
 
 	struct impl;
 	impl *imp;
@@ -37,6 +37,7 @@ extern EntityList entity_list;
 
 extern Zone* zone;
 extern WorldServer worldserver;
+extern TimerWheel timer_wheel;
 
 Mob::Mob(const char* in_name,
 		const char* in_lastname,
@@ -89,11 +90,11 @@ Mob::Mob(const char* in_name,
 		uint8		in_feettexture,
 		uint8		in_chesttexture
 		) :
-		attack_timer(2000),
-		attack_dw_timer(2000),
-		ranged_timer(2000),
-		tic_timer(6000),
-		mana_timer(2000),
+		attack_timer(timer_wheel, 2000),
+		attack_dw_timer(timer_wheel, 2000),
+		ranged_timer(timer_wheel, 2000),
+		tic_timer(timer_wheel, 6000, [this]() { OnTicTimer(); }, true),
+		mana_timer(timer_wheel, 2000, [this]() { OnManaTimer(); }, true),
 		spellend_timer(0),
 		rewind_timer(30000), //Timer used for determining amount of time between actual player position updates for /rewind.
 		bindwound_timer(10000),
@@ -106,7 +107,8 @@ Mob::Mob(const char* in_name,
 		m_TargetV(glm::vec3()),
 		flee_timer(FLEE_CHECK_TIMER),
 		m_Position(position),
-		position_update_melee_push_timer(500)
+		position_update_melee_push_timer(500),
+		instillDoubtStageTimer(timer_wheel, 0, [this]() { InstillDoubt(nullptr, 1); }) // the target ID is saved in instillDoubtTargetID
 {
 	mMovementManager = &MobMovementManager::Get();
 	mMovementManager->AddMob(this);
@@ -408,6 +410,7 @@ Mob::Mob(const char* in_name,
 Mob::~Mob()
 {
 	quest_manager.stopalltimers(this);
+	parse->RemoveEntity(this);
 
 	mMovementManager->RemoveMob(this);
 
@@ -2980,6 +2983,8 @@ int Mob::CountDispellableBuffs()
 int Mob::GetSnaredAmount()
 {
 	int worst_snare = -1;
+	if (!CouldHaveEffect(SE_MovementSpeed))
+		return worst_snare;
 
 	int buff_count = GetMaxTotalSlots();
 	for (int i = 0; i < buff_count; i++)
@@ -3589,6 +3594,15 @@ bool Mob::TryReflectSpell(uint32 spell_id)
 	return false;
 }
 
+WaterRegionType Mob::GetWaterRegionType()
+{
+	if (!zone->watermap) {
+		return RegionTypeNormal;
+	}
+
+	return zone->watermap->ReturnRegionType(glm::vec3(GetX(), GetY(), GetZ()), water_region_cache);
+}
+
 bool Mob::IsBoat() const 
 {
 	return (GetBaseRace() == SHIP || GetBaseRace() == LAUNCH || GetBaseRace() == CONTROLLED_BOAT || GetBaseRace() == GHOST_SHIP);
@@ -3943,6 +3957,9 @@ FACTION_VALUE Mob::GetSpecialFactionCon(Mob* iOther) {
 
 bool Mob::HasSpellEffect(int effectid)
 {
+    if (!CouldHaveEffect(effectid))
+        return(0);
+
     int i;
 
     int buff_count = GetMaxTotalSlots();
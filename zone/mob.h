@@ -28,8 +28,10 @@
 #include "aa.h"
 #include "../common/light_source.h"
 #include "../common/emu_constants.h"
+#include "../common/timer_wheel.h"
 
 #include <any>
+#include <bitset>
 #include <set>
 #include <vector>
 #include <memory>
@@ -288,13 +290,16 @@ public:
 	virtual int GetCurBuffSlots() const { return 0; }
 	virtual int GetMaxBuffSlots() const { return 0; }
 	virtual int GetMaxTotalSlots() const { return 0; }
-	virtual void InitializeBuffSlots() { buffs = nullptr; current_buff_count = 0; }
+	virtual void InitializeBuffSlots() { buffs = nullptr; current_buff_count = 0; active_effects.reset(); }
 	virtual void UninitializeBuffSlots() { }
 	inline Buffs_Struct* GetBuffs() { return buffs; }
 	void DamageShield(Mob* other, bool spell_ds = false);
 	int32 RuneAbsorb(int32 damage, uint16 type);
 	bool FindBuff(uint16 spellid);
 	bool FindType(uint16 type, bool bOffensive = false, uint16 threshold = 100);
+	// false when no buff in a slot has the effect, lets effect lookups skip the buff scan
+	inline bool CouldHaveEffect(uint16 type) const { return type >= EffectIndexSize || active_effects.test(type); }
+	void RebuildEffectIndex();
 	int16 GetBuffSlotFromType(uint16 type);
 	uint16 GetSpellIDFromSlot(uint8 slot);
 	int CountDispellableBuffs();
@@ -547,10 +552,15 @@ public:
 	void SetHeading(float iHeading) { if(m_Position.w != iHeading) { m_Position.w = iHeading;} }
 	void WipeHateList(bool from_memblur = false);
 	void PrintHateListToClient(Client *who) { hate_list.PrintToClient(who); }
-	std::list<tHateEntry*>& GetHateList() { return hate_list.GetHateList(); }
+	HateList& GetHateList() { return hate_list; }
 	bool CheckLosFN(Mob* other, bool spell_casting = false);
 	bool CheckLosFN(float posX, float posY, float posZ, float mobSize, Mob* other = nullptr, bool spell_casting = false);
+	// results[i] is CheckLosFN(others[i]), cache misses are traced against the map in one batch.
+	void CheckLosFNBatch(const std::vector<Mob*> &others, std::vector<uint8> &results, bool spell_casting = false);
 	bool CheckRegion(Mob* other, bool skipwater = true);
+	// water map region at our position, answered from the region we were last in while we stay in it
+	WaterRegionType GetWaterRegionType();
+	bool InLiquidRegion() { WaterRegionType type = GetWaterRegionType(); return type == RegionTypeWater || type == RegionTypeLava; }
 	inline void SetLastLosState(bool value) { last_los_check = value; }
 	inline bool CheckLastLosState() const { return last_los_check; }
 
@@ -760,6 +770,7 @@ public:
 	bool CanDualWield();
 	bool IsDualWielding();
 	inline bool IsMezzed() const { return mezzed; }
+	inline bool IsAIScanAreaDue() const { return AI_scan_area_timer && AI_scan_area_timer->GetRemainingTime() == 0; }
 	inline bool IsStunned() const { return stunned; }
 	inline bool IsSilenced() const { return silenced; }
 	inline bool IsAmnesiad() const { return amnesiad; }
@@ -790,6 +801,9 @@ public:
 	virtual void AI_Stop();
 	virtual void AI_ShutDown();
 	virtual void AI_Process();
+	// tic_timer and mana_timer run these from the timer wheel, owners start the timers when they want them
+	virtual void OnTicTimer() { }
+	virtual void OnManaTimer() { }
 
 	bool ClearEntityVariables();
 	bool DeleteEntityVariable(std::string variable_name);
@@ -943,10 +957,10 @@ public:
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther);
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther, bool ignore_feign_death);
 	
-	Timer* GetAIThinkTimer() { return AIthink_timer.get(); }
-	Timer* GetAIMovementTimer() { return AImovement_timer.get(); }
-	Timer& GetAttackTimer() { return attack_timer; }
-	Timer& GetAttackDWTimer() { return attack_dw_timer; }
+	WheelTimer* GetAIThinkTimer() { return AIthink_timer.get(); }
+	WheelTimer* GetAIMovementTimer() { return AImovement_timer.get(); }
+	WheelTimer& GetAttackTimer() { return attack_timer; }
+	WheelTimer& GetAttackDWTimer() { return attack_dw_timer; }
 	inline uint8 GetManaPercent() { return (uint8)((float)cur_mana / (float)max_mana * 100.0f); }
 	inline void SpawnPacketSent(bool val) { spawnpacket_sent = val; };
 
@@ -1075,6 +1089,11 @@ protected:
 	uint32 scalerate;
 	Buffs_Struct *buffs;
 	uint32 current_buff_count;
+	// one bit per effect id carried by a buff in any slot. Set as buffs land
+	// and rebuilt from the slots when one is removed or replaced.
+	static constexpr uint16 EffectIndexSize = 512;
+	std::bitset<EffectIndexSize> active_effects;
+	void IndexBuffEffects(uint16 spell_id);
 	bool current_buff_refresh;
 	StatBonuses itembonuses;
 	StatBonuses spellbonuses;
@@ -1160,13 +1179,13 @@ protected:
 	int8 pRunAnimSpeed;
 	bool m_is_running; // This bool tells us if the NPC *should* be running or walking, to calculate speed.
 
-	Timer attack_timer;
-	Timer attack_dw_timer;
-	Timer ranged_timer;
+	WheelTimer attack_timer;
+	WheelTimer attack_dw_timer;
+	WheelTimer ranged_timer;
 	int16 attack_delay; //delay between attacks in milliseconds or hundreds of milliseconds
 	int16 slow_mitigation; // Allows for a slow mitigation (100 = 100%, 50% = 50%)
-	Timer tic_timer;
-	Timer mana_timer;
+	WheelTimer tic_timer;
+	WheelTimer mana_timer;
 
 	//spell casting vars
 	Timer spellend_timer;
@@ -1223,6 +1242,7 @@ protected:
 	bool blind;
 	bool amnesiad;
 	bool inWater; // Set to true or false by Water Detection code if enabled by rules
+	WaterMap::RegionCache water_region_cache;
 	bool offhand;
 	bool has_shieldequiped;
 	bool has_bowequipped = false;
@@ -1249,17 +1269,17 @@ protected:
 	eStandingPetOrder pStandingPetOrder;
 	float pAggroRange;
 	float pAssistRange;
-	std::unique_ptr<Timer> AIthink_timer;
-	std::unique_ptr<Timer> AImovement_timer;
+	std::unique_ptr<WheelTimer> AIthink_timer;
+	std::unique_ptr<WheelTimer> AImovement_timer;
 	bool permarooted;
-	std::unique_ptr<Timer> AI_scan_area_timer;
-	std::unique_ptr<Timer> AIwalking_timer;
-	std::unique_ptr<Timer> AIhail_timer;
-	std::unique_ptr<Timer> AIpetguard_timer;
-	std::unique_ptr<Timer> AIdoor_timer;
-	std::unique_ptr<Timer> AIloiter_timer;
-	std::unique_ptr<Timer> AIheading_timer;
-	std::unique_ptr<Timer> AIstackedmobs_timer;
+	std::unique_ptr<WheelTimer> AI_scan_area_timer;
+	std::unique_ptr<WheelTimer> AIwalking_timer;
+	std::unique_ptr<WheelTimer> AIhail_timer;
+	std::unique_ptr<WheelTimer> AIpetguard_timer;
+	std::unique_ptr<WheelTimer> AIdoor_timer;
+	std::unique_ptr<WheelTimer> AIloiter_timer;
+	std::unique_ptr<WheelTimer> AIheading_timer;
+	std::unique_ptr<WheelTimer> AIstackedmobs_timer;
 	HateList hate_list;
 	// This is to keep track of mobs we cast faction mod spells on
 	std::map<uint32,int32> faction_bonuses; // Primary FactionID, Bonus
@@ -1332,7 +1352,7 @@ protected:
 	bool engaged;
 
 	uint16 instillDoubtTargetID;
-	Timer instillDoubtStageTimer;
+	WheelTimer instillDoubtStageTimer;
 
 private:
 
@@ -41,6 +41,7 @@
 extern EntityList entity_list;
 extern WorldServer worldserver;
 extern Zone *zone;
+extern TimerWheel timer_wheel;
 
 #ifdef _EQDEBUG
 	#define MobAI_DEBUG_Spells	-1
@@ -480,20 +481,20 @@ void Mob::AI_Start() {
 	if (pAIControlled)
 		return;
 	pAIControlled = true;
-	AIthink_timer = std::unique_ptr<Timer>(new Timer(AIthink_duration));
+	AIthink_timer = std::make_unique<WheelTimer>(timer_wheel, AIthink_duration);
 	AIthink_timer->Trigger();
-	AIwalking_timer = std::unique_ptr<Timer>(new Timer(0));
-	AImovement_timer = std::unique_ptr<Timer>(new Timer(AImovement_duration));
+	AIwalking_timer = std::make_unique<WheelTimer>(timer_wheel, 0);
+	AImovement_timer = std::make_unique<WheelTimer>(timer_wheel, AImovement_duration);
 	if (zone->CanDoCombat() && CastToNPC()->GetNPCAggro()) {
-		AI_scan_area_timer = std::make_unique<Timer>(RandomTimer(RuleI(NPC, NPCToNPCAggroTimerMin), RuleI(NPC, NPCToNPCAggroTimerMax)));
+		AI_scan_area_timer = std::make_unique<WheelTimer>(timer_wheel, RandomTimer(RuleI(NPC, NPCToNPCAggroTimerMin), RuleI(NPC, NPCToNPCAggroTimerMax)));
 	}
-	AIhail_timer = std::unique_ptr<Timer>(new Timer(100));
+	AIhail_timer = std::make_unique<WheelTimer>(timer_wheel, 100);
 	AIhail_timer->Disable();
-	AIpetguard_timer = std::unique_ptr<Timer>(new Timer(500));
-	AIdoor_timer = std::unique_ptr<Timer>(new Timer(1250));
-	AIloiter_timer = std::unique_ptr<Timer>(new Timer(0));
-	AIheading_timer = std::unique_ptr<Timer>(new Timer(2000));
-	AIstackedmobs_timer = std::unique_ptr<Timer>(new Timer(1337));
+	AIpetguard_timer = std::make_unique<WheelTimer>(timer_wheel, 500);
+	AIdoor_timer = std::make_unique<WheelTimer>(timer_wheel, 1250);
+	AIloiter_timer = std::make_unique<WheelTimer>(timer_wheel, 0);
+	AIheading_timer = std::make_unique<WheelTimer>(timer_wheel, 2000);
+	AIstackedmobs_timer = std::make_unique<WheelTimer>(timer_wheel, 1337);
 
 	if (GetAggroRange() == 0)
 		pAggroRange = 70;
@@ -537,10 +538,10 @@ void NPC::AI_Start() {
 		return;
 
 	if (AIspells.empty()) {
-		AIautocastspell_timer = std::unique_ptr<Timer>(new Timer(1000));
+		AIautocastspell_timer = std::make_unique<WheelTimer>(timer_wheel, 1000);
 		AIautocastspell_timer->Disable();
 	} else {
-		AIautocastspell_timer = std::unique_ptr<Timer>(new Timer(750));
+		AIautocastspell_timer = std::make_unique<WheelTimer>(timer_wheel, 750);
 	}
 
 	if (NPCTypedata) {
@@ -2136,7 +2137,7 @@ void NPC::AI_DoMovement() {
 				glm::vec3 start(roambox_movingto_x, roambox_movingto_y, roambox_ceil);
 				glm::vec3 dest(roambox_movingto_x, roambox_movingto_y, GetZ());
 
-				if (zone->HasMap() && zone->HasWaterMap() && zone->watermap->InLiquid(GetPosition()) || zone->IsWaterZone(GetZ())) {
+				if (zone->HasMap() && zone->HasWaterMap() && InLiquidRegion() || zone->IsWaterZone(GetZ())) {
 					has_los = zone->zonemap->CheckLoS(GetPosition(), dest);
 				}
 				if (zone->random.Roll(5)) {
@@ -10,6 +10,7 @@
 #include "../common/fastmath.h"
 #include "../common/misc_functions.h"
 #include "pathfinder_interface.h"
+#include <algorithm>
 #include <vector>
 #include <deque>
 #include <map>
@@ -91,7 +92,7 @@ public:
 			mob->SetRunAnimation(0.0f);
 			if (dist > 13.0f && rotate_to_speed > 0.0f && rotate_to_speed <= 25.0f) { //send basic rotation
 				mob->SetDelta(glm::vec4(0.0f, 0.0f, 0.0f, static_cast<float>(m_rotate_to_dir * rotate_to_speed)));
-				mob->SendPosUpdate();
+				mob_movement_manager->SendPositionUpdate(mob);
 				mob->SendPosUpdate(2);
 				mob->SetMoving(true);
 				mob->SetMoved(false);
@@ -245,7 +246,7 @@ public:
 					m_distance_moved_since_correction = 0.0;
 					mob->FixZ();
 				}
-				mob->SendPosUpdate();
+				mob_movement_manager->SendPositionUpdate(mob);
 				mob->SendPosUpdate(2);
 				return false;
 			}
@@ -256,8 +257,10 @@ public:
 		double    distance_moved = frame_time * static_cast<double>(m_last_sent_speed) * 0.4f * 1.45f;
 
 		//When speed changes
+		bool speed_changed = false;
 		if (current_speed != m_last_sent_speed || mob_speed != current_float_speed) {
 			need_update = true;
+			speed_changed = true;
 		}
 		m_total_h_dist_moved += distance_moved;
 		if (distance_moved >= len || m_total_h_dist_moved > m_total_h_dist) {
@@ -270,7 +273,7 @@ public:
 				m_distance_moved_since_correction = 0.0;
 				mob->FixZ();
 			}
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob);
 			mob->SendPosUpdate(2);
 			return true;
 		}
@@ -307,7 +310,7 @@ public:
 			}
 			m_last_sent_speed = current_speed;
 			m_last_sent_time = current_time;
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob, !speed_changed);
 			mob->SendPosUpdate(2);
 		}
 
@@ -412,7 +415,7 @@ public:
 			m_last_sent_time  = current_time;
 			m_total_h_dist    = DistanceNoZ(mob->GetPosition(), glm::vec4(m_move_to_x, m_move_to_y, 0.0f, 0.0f));
 			m_total_v_dist    = m_move_to_z - mob->GetZ();
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob);
 			mob->SendPosUpdate(2);
 			return false;
 		}
@@ -422,7 +425,7 @@ public:
 			m_distance_moved_since_correction = 0.0;
 			m_last_sent_speed = current_speed;
 			m_last_sent_time  = current_time;
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob);
 			mob->SendPosUpdate(2);
 		}
 
@@ -445,7 +448,7 @@ public:
 			}
 			auto vec = glm::vec4(m_move_to_x, m_move_to_y, m_move_to_z, mob->GetHeading());
 			mob->SetPosition(vec);
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob);
 			mob->SendPosUpdate(2);
 			return true;
 		}
@@ -469,7 +472,7 @@ public:
 			m_distance_moved_since_correction = 0.0;
 			m_last_sent_speed = current_speed;
 			m_last_sent_time = current_time;
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob, true);
 			mob->SendPosUpdate(2);
 		}
 
@@ -573,7 +576,7 @@ public:
 			m_last_sent_speed = current_speed;
 			if (!currently_moving || (currently_moving && current_speed == 0)) {
 				m_last_sent_time = current_time;
-				mob->SendPosUpdate();
+				mob_movement_manager->SendPositionUpdate(mob);
 				mob->SendPosUpdate(2);
 				return false;
 			}
@@ -584,8 +587,10 @@ public:
 		double    distance_moved = frame_time * static_cast<double>(m_last_sent_speed) * 0.4f * 1.45f;
 
 		//When speed changes
+		bool speed_changed = false;
 		if (current_speed != m_last_sent_speed || mob_speed != current_float_speed) {
 			need_update = true;
+			speed_changed = true;
 		}
 		m_total_h_dist_moved += distance_moved;
 		if (distance_moved >= len || m_total_h_dist_moved > m_total_h_dist) {
@@ -594,7 +599,7 @@ public:
 			}
 			auto vec = glm::vec4(m_move_to_x, m_move_to_y, m_move_to_z, mob->GetHeading());
 			mob->SetPosition(vec);
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob);
 			mob->SendPosUpdate(2);
 			return true;
 		}
@@ -622,7 +627,7 @@ public:
 		if (need_update) {
 			m_last_sent_speed = current_speed;
 			m_last_sent_time = current_time;
-			mob->SendPosUpdate();
+			mob_movement_manager->SendPositionUpdate(mob, !speed_changed);
 			mob->SendPosUpdate(2);
 		}
 
@@ -661,7 +666,7 @@ public:
 		mob->SetHeading(mob_movement_manager->FixHeading(m_teleport_to_heading));
 		mob->SetDelta(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
 		mob->SetRunAnimation(0.0f);
-		mob->SendPosUpdate();
+		mob_movement_manager->SendPositionUpdate(mob);
 		mob->SendPosUpdate(2);
 		return true;
 	}
@@ -800,6 +805,12 @@ struct MovementStats {
 		TotalSentMovement = 0ULL;
 		TotalSentPosition = 0ULL;
 		TotalSentHeading  = 0ULL;
+		TotalSentClose    = 0ULL;
+		TotalSentMedium   = 0ULL;
+		TotalSentLong     = 0ULL;
+		TotalThrottled    = 0ULL;
+		TotalOutOfRange   = 0ULL;
+		TotalCatchUp      = 0ULL;
 	}
 
 	double   LastResetTime;
@@ -807,6 +818,12 @@ struct MovementStats {
 	uint64_t TotalSentMovement;
 	uint64_t TotalSentPosition;
 	uint64_t TotalSentHeading;
+	uint64_t TotalSentClose;
+	uint64_t TotalSentMedium;
+	uint64_t TotalSentLong;
+	uint64_t TotalThrottled;
+	uint64_t TotalOutOfRange;
+	uint64_t TotalCatchUp;
 };
 
 struct NavigateTo {
@@ -829,9 +846,24 @@ struct NavigateTo {
 	MobMovementMode navigate_to_mode;
 };
 
+struct PendingPathRequest {
+	uint32          request = 0;
+	float           x       = 0.0f;
+	float           y       = 0.0f;
+	float           z       = 0.0f;
+	MobMovementMode mode    = MovementWalking;
+	float           last_x  = 0.0f;
+	float           last_y  = 0.0f;
+	float           last_z  = 0.0f;
+};
+
 struct MobMovementEntry {
 	std::deque<std::unique_ptr<IMovementCommand>> Commands;
 	NavigateTo                                    NavTo;
+	PendingPathRequest                            PendingPath; // ground route still being worked out by the path workers
+	double                                        LastSentMedium = 0.0;
+	double                                        LastSentLong   = 0.0;
+	std::vector<uint16>                           OutOfRange; // clients that missed an update past the zone update range
 };
 
 void AdjustRoute(std::list<IPathfinder::IPathNode> &nodes, Mob *who)
@@ -870,6 +902,7 @@ struct MobMovementManager::Implementation {
 	std::map<Mob *, MobMovementEntry> Entries;
 	std::vector<Client *>             Clients;
 	MovementStats                     Stats;
+	double                            LastCatchUpTime = 0.0;
 };
 
 MobMovementManager::MobMovementManager()
@@ -883,10 +916,27 @@ MobMovementManager::~MobMovementManager()
 
 void MobMovementManager::Process()
 {
+	double current_time = static_cast<double>(Timer::GetCurrentTime()) / 1000.0;
+	if (current_time - _impl->LastCatchUpTime >= 1.0) {
+		_impl->LastCatchUpTime = current_time;
+		SendCatchUpUpdates();
+	}
+
 	for (auto &iter : _impl->Entries) {
 		auto &ent      = iter.second;
 		auto &commands = ent.Commands;
 
+		if (ent.PendingPath.request && zone->pathing) {
+			IPathfinder::IPath route;
+			bool partial = false;
+			bool stuck   = false;
+			if (zone->pathing->GetPathResult(ent.PendingPath.request, route, partial, stuck)) {
+				auto p = ent.PendingPath;
+				ent.PendingPath.request = 0;
+				ApplyPathGround(iter.first, route, partial, stuck, p.x, p.y, p.z, p.mode, p.last_x, p.last_y, p.last_z);
+			}
+		}
+
 		while (true != commands.empty()) {
 			auto &cmd = commands.front();
 			auto r    = cmd->Process(this, iter.first);
@@ -913,7 +963,11 @@ void MobMovementManager::AddMob(Mob *mob)
  */
 void MobMovementManager::RemoveMob(Mob *mob)
 {
-	_impl->Entries.erase(mob);
+	auto iter = _impl->Entries.find(mob);
+	if (iter != _impl->Entries.end()) {
+		CancelPendingPath(iter->second);
+		_impl->Entries.erase(iter);
+	}
 }
 
 /**
@@ -973,6 +1027,7 @@ void MobMovementManager::Teleport(Mob *who, float x, float y, float z, float hea
 	auto &ent = (*iter);
 
 	ent.second.Commands.clear();
+	CancelPendingPath(ent.second);
 
 	PushTeleportTo(ent.second, x, y, z, heading);
 }
@@ -1007,6 +1062,11 @@ void MobMovementManager::NavigateTo(Mob *who, float x, float y, float z, MobMove
 			6.0f
 		);
 
+		// a route to this spot is still being worked out, give the path workers a moment before asking again
+		if (ent.second.PendingPath.request && within && !speed_changed && (current_time - nav.last_set_time) < 2.0) {
+			return;
+		}
+
 		if (false == within || ent.second.Commands.size() == 0 || speed_changed) {
 
 			// we are updating path to a new location
@@ -1045,6 +1105,8 @@ void MobMovementManager::StopNavigation(Mob *who, float new_head)
 	nav.navigate_to_z       = 0.0;
 	nav.navigate_to_speed = 0.0f;
 
+	CancelPendingPath(ent.second);
+
 	if (new_head != -1.0f && who->GetHeading() != new_head) {
 		who->SetHeading(new_head);
 		who->SetMoving(true);
@@ -1090,13 +1152,21 @@ void MobMovementManager::SendCommandToClients(
 		return;
 	}
 
-	EQApplicationPacket outapp(OP_ClientUpdate, sizeof(SpawnPositionUpdate_Struct));
-	auto                *spu = (SpawnPositionUpdate_Struct*) outapp.pBuffer;
+	EQApplicationPacket outapp(OP_MobUpdate, sizeof(SpawnPositionUpdates_Struct));
+	auto                *spu = (SpawnPositionUpdates_Struct*) outapp.pBuffer;
 
-	FillCommandStruct(spu, mob, delta_x, delta_y, delta_z, delta_heading, anim);
+	spu->num_updates = 1;
+	FillCommandStruct(&spu->spawn_update, mob, delta_x, delta_y, delta_z, delta_heading, anim);
+	EQBroadcastPacket bp(&outapp);
 
-		//float short_range = RuleR(Pathing, ShortMovementUpdateRange);
-		//float long_range = zone->GetMaxMovementUpdateRange();
+	float short_range    = RuleR(Pathing, ShortMovementUpdateRange);
+	float medium_range   = RuleR(Pathing, MediumMovementUpdateRange);
+	float short_range_2  = short_range * short_range;
+	float medium_range_2 = medium_range * medium_range;
+	float long_range_2   = zone->update_range; // already squared
+
+	auto ent_iter = _impl->Entries.find(mob);
+	MobMovementEntry *ent = ent_iter != _impl->Entries.end() ? &ent_iter->second : nullptr;
 
 	for (auto& c : _impl->Clients) {
 		if (single_client && c != single_client) {
@@ -1107,21 +1177,158 @@ void MobMovementManager::SendCommandToClients(
 			continue;
 		}
 
-		bool match = true;
-		if (match) {
-			_impl->Stats.TotalSent++;
+		float dist_2 = DistanceSquared(c->GetPosition(), mob->GetPosition());
+
+		ClientRange band = ClientRangeNone;
+		if (dist_2 <= short_range_2) {
+			band = ClientRangeClose;
+		}
+		else if (dist_2 <= medium_range_2) {
+			band = ClientRangeMedium;
+		}
+		else if (dist_2 <= long_range_2) {
+			band = ClientRangeLong;
+		}
+
+		if (band == ClientRangeNone) {
+			_impl->Stats.TotalOutOfRange++;
 
-			if (anim != 0) {
-				_impl->Stats.TotalSentMovement++;
+			// they won't know where we stopped, catch them up once they get close again
+			if (ent && std::find(ent->OutOfRange.begin(), ent->OutOfRange.end(), c->GetID()) == ent->OutOfRange.end()) {
+				ent->OutOfRange.push_back(c->GetID());
 			}
-			else if (delta_heading != 0) {
-				_impl->Stats.TotalSentHeading++;
+			continue;
+		}
+
+		if ((range & band) == 0) {
+			_impl->Stats.TotalThrottled++;
+			continue;
+		}
+
+		if (ent && !ent->OutOfRange.empty()) {
+			auto stale = std::find(ent->OutOfRange.begin(), ent->OutOfRange.end(), c->GetID());
+			if (stale != ent->OutOfRange.end()) {
+				ent->OutOfRange.erase(stale);
 			}
-			else {
-				_impl->Stats.TotalSentPosition++;
+		}
+
+		_impl->Stats.TotalSent++;
+
+		if (anim != 0) {
+			_impl->Stats.TotalSentMovement++;
+		}
+		else if (delta_heading != 0) {
+			_impl->Stats.TotalSentHeading++;
+		}
+		else {
+			_impl->Stats.TotalSentPosition++;
+		}
+
+		if (band == ClientRangeClose) {
+			_impl->Stats.TotalSentClose++;
+		}
+		else if (band == ClientRangeMedium) {
+			_impl->Stats.TotalSentMedium++;
+		}
+		else {
+			_impl->Stats.TotalSentLong++;
+		}
+
+		c->QueuePacket(bp, false, Client::CLIENT_CONNECTED);
+	}
+}
+
+/**
+ * Sends a movement update for a mob to nearby clients. State changes (start, stop, speed change)
+ * go to every band; periodic resyncs only go to medium and long range clients once their
+ * interval has passed.
+ *
+ * @param mob
+ * @param periodic
+ */
+void MobMovementManager::SendPositionUpdate(Mob *mob, bool periodic)
+{
+	if (!mob->IsNPC() || mob->GetRace() == CONTROLLED_BOAT) {
+		mob->SendPosUpdate();
+		return;
+	}
+
+	double current_time = static_cast<double>(Timer::GetCurrentTime()) / 1000.0;
+	int    range        = ClientRangeAny;
+
+	auto iter = _impl->Entries.find(mob);
+	if (iter != _impl->Entries.end()) {
+		auto &ent = iter->second;
+
+		if (periodic) {
+			range = ClientRangeClose;
+			if (current_time - ent.LastSentMedium >= RuleR(Pathing, MediumMovementUpdateInterval)) {
+				range |= ClientRangeMedium;
+			}
+			if (current_time - ent.LastSentLong >= RuleR(Pathing, LongMovementUpdateInterval)) {
+				range |= ClientRangeLong;
+			}
+		}
+
+		if (range & ClientRangeMedium) {
+			ent.LastSentMedium = current_time;
+		}
+		if (range & ClientRangeLong) {
+			ent.LastSentLong = current_time;
+		}
+	}
+
+	SendCommandToClients(
+		mob,
+		mob->GetDeltaX(),
+		mob->GetDeltaY(),
+		0.0f,
+		mob->GetDeltaHeading(),
+		static_cast<int>(mob->GetRunAnimSpeed()),
+		static_cast<ClientRange>(range)
+	);
+}
+
+/**
+ * Clients that were past the update range when a mob last moved still have it wherever it was
+ * then. Once they come back in range, send them where it actually is.
+ */
+void MobMovementManager::SendCatchUpUpdates()
+{
+	float long_range_2 = zone->update_range;
+
+	for (auto &iter : _impl->Entries) {
+		auto &ent = iter.second;
+		if (ent.OutOfRange.empty()) {
+			continue;
+		}
+
+		Mob *mob = iter.first;
+		auto it  = ent.OutOfRange.begin();
+		while (it != ent.OutOfRange.end()) {
+			Client *c = entity_list.GetClientByID(*it);
+			if (!c) {
+				it = ent.OutOfRange.erase(it);
+				continue;
+			}
+
+			if (DistanceSquared(c->GetPosition(), mob->GetPosition()) > long_range_2) {
+				++it;
+				continue;
 			}
 
-			c->QueuePacket(&outapp, false);
+			it = ent.OutOfRange.erase(it);
+			_impl->Stats.TotalCatchUp++;
+			SendCommandToClients(
+				mob,
+				mob->GetDeltaX(),
+				mob->GetDeltaY(),
+				0.0f,
+				mob->GetDeltaHeading(),
+				static_cast<int>(mob->GetRunAnimSpeed()),
+				ClientRangeAny,
+				c
+			);
 		}
 	}
 }
@@ -1177,6 +1384,42 @@ void MobMovementManager::DumpStats(Client *client)
 		_impl->Stats.TotalSentPosition,
 		static_cast<double>(_impl->Stats.TotalSentPosition) / total_time
 	);
+	client->Message(
+		15,
+		"Close Range: %u (%.2f / sec)",
+		_impl->Stats.TotalSentClose,
+		static_cast<double>(_impl->Stats.TotalSentClose) / total_time
+	);
+	client->Message(
+		15,
+		"Medium Range: %u (%.2f / sec)",
+		_impl->Stats.TotalSentMedium,
+		static_cast<double>(_impl->Stats.TotalSentMedium) / total_time
+	);
+	client->Message(
+		15,
+		"Long Range: %u (%.2f / sec)",
+		_impl->Stats.TotalSentLong,
+		static_cast<double>(_impl->Stats.TotalSentLong) / total_time
+	);
+	client->Message(
+		15,
+		"Throttled: %u (%.2f / sec)",
+		_impl->Stats.TotalThrottled,
+		static_cast<double>(_impl->Stats.TotalThrottled) / total_time
+	);
+	client->Message(
+		15,
+		"Out of Range: %u (%.2f / sec)",
+		_impl->Stats.TotalOutOfRange,
+		static_cast<double>(_impl->Stats.TotalOutOfRange) / total_time
+	);
+	client->Message(
+		15,
+		"Catch Up: %u (%.2f / sec)",
+		_impl->Stats.TotalCatchUp,
+		static_cast<double>(_impl->Stats.TotalCatchUp) / total_time
+	);
 }
 
 void MobMovementManager::ClearStats()
@@ -1186,6 +1429,12 @@ void MobMovementManager::ClearStats()
 	_impl->Stats.TotalSentHeading  = 0;
 	_impl->Stats.TotalSentMovement = 0;
 	_impl->Stats.TotalSentPosition = 0;
+	_impl->Stats.TotalSentClose    = 0;
+	_impl->Stats.TotalSentMedium   = 0;
+	_impl->Stats.TotalSentLong     = 0;
+	_impl->Stats.TotalThrottled    = 0;
+	_impl->Stats.TotalOutOfRange   = 0;
+	_impl->Stats.TotalCatchUp      = 0;
 }
 
 /**
@@ -1240,7 +1489,7 @@ void MobMovementManager::UpdatePath(Mob *who, float x, float y, float z, MobMove
 	if (who->IsBoat()) {
 		UpdatePathBoat(who, x, y, z, mob_movement_mode);
 	}
-	else if ((who->IsNPC() && who->CastToNPC()->IsUnderwaterOnly()) || zone->IsWaterZone(who->GetZ()) || (zone->HasWaterMap() && zone->watermap->InLiquid(who->GetPosition()))) {
+	else if ((who->IsNPC() && who->CastToNPC()->IsUnderwaterOnly()) || zone->IsWaterZone(who->GetZ()) || (zone->HasWaterMap() && who->InLiquidRegion())) {
 		UpdatePathUnderwater(who, x, y, z, mob_movement_mode);
 	}
 	// If we can fly, and we have a target and we have LoS, simply fly to them.
@@ -1293,6 +1542,32 @@ void MobMovementManager::UpdatePathGround(Mob *who, float x, float y, float z, M
 
 	glm::vec3 end(x, y, z);
 
+	auto eiter = _impl->Entries.find(who);
+	auto &ent  = (*eiter);
+
+	CancelPendingPath(ent.second);
+
+	// hand the search to the path workers, the route is picked up by Process on a later tick
+	uint32 request = zone->pathing->RequestPath(begin, end, opts);
+	if (request) {
+		IPathfinder::IPath route;
+		if (zone->pathing->GetPathResult(request, route, partial, stuck)) {
+			ApplyPathGround(who, route, partial, stuck, x, y, z, mode, last_x, last_y, last_z);
+			return;
+		}
+
+		auto &pending = ent.second.PendingPath;
+		pending.request = request;
+		pending.x       = x;
+		pending.y       = y;
+		pending.z       = z;
+		pending.mode    = mode;
+		pending.last_x  = last_x;
+		pending.last_y  = last_y;
+		pending.last_z  = last_z;
+		return;
+	}
+
 	auto route   = zone->pathing->FindPath(
 		begin,
 		end,
@@ -1301,6 +1576,35 @@ void MobMovementManager::UpdatePathGround(Mob *who, float x, float y, float z, M
 		opts
 	);
 
+	ApplyPathGround(who, route, partial, stuck, x, y, z, mode, last_x, last_y, last_z);
+}
+
+/**
+ * Queues the movement commands for a route found by UpdatePathGround
+ *
+ * @param who
+ * @param route
+ * @param partial
+ * @param stuck
+ * @param x
+ * @param y
+ * @param z
+ * @param mode
+ */
+void MobMovementManager::ApplyPathGround(
+	Mob *who,
+	IPathfinder::IPath &route,
+	bool partial,
+	bool stuck,
+	float x,
+	float y,
+	float z,
+	MobMovementMode mode,
+	float last_x,
+	float last_y,
+	float last_z
+)
+{
 	auto eiter = _impl->Entries.find(who);
 	auto &ent  = (*eiter);
 
@@ -1461,7 +1765,7 @@ void MobMovementManager::UpdatePathUnderwater(Mob *who, float x, float y, float
 	auto eiter = _impl->Entries.find(who);
 	auto &ent  = (*eiter);
 	bool underwater_mob = who->IsNPC() && (who->CastToNPC()->IsUnderwaterOnly() || (zone->IsWaterZone(who->GetZ()) && zone->IsWaterZone(z)) ||
-		(zone->HasWaterMap() && zone->watermap->InLiquid(who->GetPosition()) && zone->watermap->InLiquid(glm::vec3(x, y, z))));
+		(zone->HasWaterMap() && who->InLiquidRegion() && zone->watermap->InLiquid(glm::vec3(x, y, z))));
 
 	if (underwater_mob && zone->zonemap->CheckLoS(who->GetPosition(), glm::vec3(x, y, z))) {
 		PushSwimTo(ent.second, x, y, z, movement_mode);
@@ -1651,6 +1955,22 @@ void MobMovementManager::PushEvadeCombat(MobMovementEntry &mob_movement_entry)
 	mob_movement_entry.Commands.emplace_back(std::unique_ptr<IMovementCommand>(new EvadeCombatCommand()));
 }
 
+/**
+ * @param ent
+ */
+void MobMovementManager::CancelPendingPath(MobMovementEntry &ent)
+{
+	if (ent.PendingPath.request == 0) {
+		return;
+	}
+
+	if (zone && zone->pathing) {
+		zone->pathing->CancelPath(ent.PendingPath.request);
+	}
+
+	ent.PendingPath.request = 0;
+}
+
 /**
  * @param who
  * @param x
@@ -1673,7 +1993,7 @@ void MobMovementManager::HandleStuckBehavior(Mob *who, float x, float y, float z
 	auto eiter = _impl->Entries.find(who);
 	auto &ent = (*eiter);
 
-	bool in_liquid = zone->HasWaterMap() && zone->watermap->InLiquid(who->GetPosition()) || zone->IsWaterZone(who->GetZ());
+	bool in_liquid = zone->HasWaterMap() && who->InLiquidRegion() || zone->IsWaterZone(who->GetZ());
 	bool dest_in_liquid = zone->HasWaterMap() && zone->watermap->InLiquid(glm::vec3(x, y, z)) || zone->IsWaterZone(z);
 
 	switch (sb) {
@@ -1,5 +1,6 @@
 #pragma once
 #include "map.h"
+#include "pathfinder_interface.h"
 #include <memory>
 
 class Mob;
@@ -63,6 +64,7 @@ public:
 		Client* single_client = nullptr,
 		Client* ignore_client = nullptr
 	);
+	void SendPositionUpdate(Mob *mob, bool periodic = false);
 
 	float FixHeading(float in);
 	void DumpStats(Client *client);
@@ -78,9 +80,12 @@ private:
 	MobMovementManager(const MobMovementManager&);
 	MobMovementManager& operator=(const MobMovementManager&);
 
+	void SendCatchUpUpdates();
 	void FillCommandStruct(SpawnPositionUpdate_Struct *position_update, Mob *mob, float delta_x, float delta_y, float delta_z, float delta_heading, int anim);
 	void UpdatePath(Mob *who, float x, float y, float z, MobMovementMode mob_movement_mode, float last_x = 0.0f, float last_y = 0.0f, float last_z = 0.0f);
 	void UpdatePathGround(Mob *who, float x, float y, float z, MobMovementMode mode, float last_x = 0.0f, float last_y = 0.0f, float last_z = 0.0f);
+	void ApplyPathGround(Mob *who, IPathfinder::IPath &route, bool partial, bool stuck, float x, float y, float z, MobMovementMode mode, float last_x, float last_y, float last_z);
+	void CancelPendingPath(MobMovementEntry &ent);
 	void UpdatePathUnderwater(Mob *who, float x, float y, float z, MobMovementMode movement_mode);
 	void UpdatePathBoat(Mob *who, float x, float y, float z, MobMovementMode mode);
 	void PushTeleportTo(MobMovementEntry &ent, float x, float y, float z, float heading);
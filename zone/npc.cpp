@@ -46,6 +46,7 @@
 
 #include <glm/gtx/projection.hpp>
 
+#include <algorithm>
 #include <cctype>
 #include <stdio.h>
 #include <string>
@@ -62,6 +63,7 @@
 extern Zone* zone;
 extern volatile bool is_zone_loaded;
 extern EntityList entity_list;
+extern TimerWheel timer_wheel;
 extern FastMath g_Math;
 extern SkillCaps skill_caps;
 
@@ -125,7 +127,7 @@ NPC::NPC(const NPCType *npc_type_data, Spawn2* in_respawn, const glm::vec4& posi
 	call_help_timer(AIassistcheck_delay),
 	qglobal_purge_timer(30000),
 	push_timer(500),
-	sendhpupdate_timer(1000),
+	sendhpupdate_timer(timer_wheel, 1000, [this]() { OnHPUpdateTimer(); }, true),
 	enraged_timer(1000),
 	taunt_timer(TauntReuseTime * 1000),
 	despawn_timer(1000),
@@ -405,8 +407,10 @@ NPC::NPC(const NPCType *npc_type_data, Spawn2* in_respawn, const glm::vec4& posi
 		}
 	}
 
-	reface_timer = new Timer(15000);
+	reface_timer = new WheelTimer(timer_wheel, 15000);
 	reface_timer->Disable();
+	tic_timer.Start();
+	sendhpupdate_timer.Start();
 	qGlobals = nullptr;
 	SetEmoteID(static_cast<uint32>(npc_type_data->emoteid));
 	if (npc_type_data->walkspeed > 0.0f)
@@ -546,38 +550,6 @@ bool NPC::Process()
 
 	ProcessFTE();
 
-	if(tic_timer.Check())
-	{
-		parse->EventNPC(EVENT_TICK, this, nullptr, "", 0);
-		BuffProcess();
-
-		if(flee_mode)
-			ProcessFlee();
-
-		int32 old_hp = GetHP();
-		if(GetHP() < GetMaxHP())
-			SetHP(GetHP() + GetHPRegen());
-
-		if(RuleB(Alkabor, NPCsSendHPUpdatesPerTic) && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient()))) 
-		{
-			if (old_hp != cur_hp || cur_hp<max_hp) 
-			{
-				SendHPUpdate(false);
-			}
-		}
-
-		if(GetMana() < GetMaxMana())
-			SetMana(GetMana() + GetManaRegen());
-	}
-
-	if (!RuleB(Alkabor, NPCsSendHPUpdatesPerTic) && sendhpupdate_timer.Check() && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient())))
-	{
-		if(!IsFullHP || cur_hp<max_hp)
-		{
-			SendHPUpdate();
-		}
-	}
-
 	if (IsMezzed())
 	{
 		AI_Process();
@@ -631,6 +603,49 @@ bool NPC::Process()
 	return true;
 }
 
+// the tic and hp update timers run from the timer wheel, not Process(). They
+// skip NPCs that are going away or that an idle zone has stopped processing.
+void NPC::OnTicTimer()
+{
+	if (p_depop || (zone && zone->MobProcessSuspended(this)))
+		return;
+
+	parse->EventNPC(EVENT_TICK, this, nullptr, "", 0);
+	BuffProcess();
+
+	if(flee_mode)
+		ProcessFlee();
+
+	int32 old_hp = GetHP();
+	if(GetHP() < GetMaxHP())
+		SetHP(GetHP() + GetHPRegen());
+
+	if(RuleB(Alkabor, NPCsSendHPUpdatesPerTic) && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient()))) 
+	{
+		if (old_hp != cur_hp || cur_hp<max_hp) 
+		{
+			SendHPUpdate(false);
+		}
+	}
+
+	if(GetMana() < GetMaxMana())
+		SetMana(GetMana() + GetManaRegen());
+}
+
+void NPC::OnHPUpdateTimer()
+{
+	if (p_depop || (zone && zone->MobProcessSuspended(this)))
+		return;
+
+	if (!RuleB(Alkabor, NPCsSendHPUpdatesPerTic) && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient())))
+	{
+		if(!IsFullHP || cur_hp<max_hp)
+		{
+			SendHPUpdate();
+		}
+	}
+}
+
 uint32 NPC::CountLoot() {
 	return(m_loot_items.size());
 }
@@ -2537,6 +2552,39 @@ FACTION_VALUE NPC::CheckNPCFactionAlly(int32 other_faction)
 	return FACTION_INDIFFERENTLY;
 }
 
+void NPC::BuildHostileFactions()
+{
+	hostile_factions.clear();
+	for (const auto& e : faction_list) {
+		if (e.npc_value < 0) {
+			hostile_factions.push_back(e.faction_id);
+		}
+	}
+	std::sort(hostile_factions.begin(), hostile_factions.end());
+	hostile_factions.erase(std::unique(hostile_factions.begin(), hostile_factions.end()), hostile_factions.end());
+}
+
+// Mirrors how CheckWillAggro reaches other->GetReverseFactionCon(this) for two NPCs:
+// only SCOWLS (or THREATENINGLY) aggros, and between plain NPC factions that comes
+// solely from our faction_list being negative on their primary faction.
+bool NPC::CanFactionAggroNPC(NPC *other)
+{
+	if (!other) {
+		return false;
+	}
+
+	// special factions and pets go through GetSpecialFactionCon/owner faction, don't guess
+	if (primary_faction < 0 || GetOwner() || other->GetOwner()) {
+		return true;
+	}
+
+	if (primary_faction == 0 || other->GetPrimaryFaction() == 0) {
+		return false;
+	}
+
+	return std::binary_search(hostile_factions.begin(), hostile_factions.end(), other->GetPrimaryFaction());
+}
+
 bool NPC::IsFactionListAlly(uint32 other_faction) 
 {
 	return CheckNPCFactionAlly(other_faction) == FACTION_ALLY;
@@ -33,6 +33,7 @@
 
 #include <deque>
 #include <list>
+#include <vector>
 
 typedef struct {
 	float min_x;
@@ -113,6 +114,8 @@ public:
 	virtual bool IsNPC() const { return true; }
 
 	virtual bool Process();
+	virtual void	OnTicTimer();
+	void	OnHPUpdateTimer();
 	virtual void	AI_Init();
 	virtual void	AI_Start();
 	virtual void	AI_Stop();
@@ -165,6 +168,9 @@ public:
 	bool	IsFactionListAlly(uint32 other_faction);
 	bool	IsGuard();
 	FACTION_VALUE CheckNPCFactionAlly(int32 other_faction);
+	// Faction-only pre-checks for NPC vs NPC aggro; false means CheckWillAggro can never succeed.
+	bool	CanFactionAggroNPC(NPC *other);
+	bool	CanFactionAggroAnyNPC() { return primary_faction < 0 || GetOwner() || !hostile_factions.empty(); }
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther, uint32 other_guild = 0);
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther, bool ignore_feign_death, uint32 other_guild = 0);
 	void	SetGuild(int32 guild = 0);
@@ -291,9 +297,10 @@ public:
 	void	SetNPCFactionID(int32 in) { 
 		npc_faction_id = in; 
 		database.GetFactionIDsForNPC(npc_faction_id, &faction_list, &primary_faction); 
+		BuildHostileFactions();
 	}
 	void	SetPreCharmNPCFactionID(int32 in) { precharm_npc_faction_id = in; }
-	void	RestoreNPCFactionID() { npc_faction_id = precharm_npc_faction_id; database.GetFactionIDsForNPC(npc_faction_id, &faction_list, &primary_faction); }
+	void	RestoreNPCFactionID() { npc_faction_id = precharm_npc_faction_id; database.GetFactionIDsForNPC(npc_faction_id, &faction_list, &primary_faction); BuildHostileFactions(); }
 
     glm::vec4 m_SpawnPoint;
 
@@ -414,7 +421,7 @@ public:
 	void AddSpellToNPCList(int16 iPriority, int16 iSpellID, uint16 iType, int16 iManaCost, int32 iRecastDelay, int16 iResistAdjust);
 	void AddSpellEffectToNPCList(uint16 iSpellEffectID, int32 base, int32 limit, int32 max);
 	void RemoveSpellFromNPCList(int16 spell_id);
-	Timer *GetRefaceTimer() const { return reface_timer; }
+	WheelTimer *GetRefaceTimer() const { return reface_timer; }
 
 	NPC_Emote_Struct* GetNPCEmote(uint32 emoteid, uint8 event_);
 	void DoNPCEmote(uint8 event_, uint32 emoteid, Mob* target = nullptr);
@@ -513,6 +520,10 @@ protected:
 	LootItems m_loot_items;
 
 	std::list<NpcFactionEntriesRepository::NpcFactionEntries> faction_list;
+	// sorted primary factions faction_list has a negative npc_value for, i.e. this NPC's
+	// row of the faction-pair aggro matrix. Rebuilt whenever faction_list is.
+	std::vector<int32> hostile_factions;
+	void	BuildHostileFactions();
 
 	int32	npc_faction_id;
 	int32	precharm_npc_faction_id;
@@ -529,13 +540,13 @@ protected:
 	Timer	push_timer;			// melee push vector and map collision LoS check
 
 	bool	combat_event;	//true if we are in combat, false otherwise
-	Timer	sendhpupdate_timer;
+	WheelTimer	sendhpupdate_timer;
 	Timer	enraged_timer;
-	Timer *reface_timer;
+	WheelTimer *reface_timer;
 
 	uint32	npc_spells_id;
 	uint8	casting_spell_AIindex;
-	std::unique_ptr<Timer> AIautocastspell_timer;
+	std::unique_ptr<WheelTimer> AIautocastspell_timer;
 	uint32*	pDontCastBefore_casting_spell;
 	std::vector<AISpells_Struct> AIspells;
 	bool HasAISpell;
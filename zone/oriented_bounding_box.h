@@ -12,6 +12,8 @@ public:
 	~OrientedBoundingBox() = default;
 
 	bool ContainsPoint(glm::vec3 p) const;
+	// axis aligned box around the oriented one, false if the transform is degenerate
+	bool GetBounds(glm::vec3 &min, glm::vec3 &max) const;
 private:
 	float min_x, max_x;
 	float min_y, max_y;
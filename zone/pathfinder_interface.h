@@ -80,5 +80,12 @@ public:
 	virtual glm::vec3 GetRandomLocation(const glm::vec3 &start, int flags = PathingNotDisabled) = 0;
 	virtual void DebugCommand(Client *c, const Seperator *sep) = 0;
 
+	//Queues a FindPath to run off the zone thread, returns 0 if this pathfinder can't
+	//and the caller should use FindPath instead.
+	virtual uint32 RequestPath(const glm::vec3 &start, const glm::vec3 &end, const PathfinderOptions &opts) { return 0; }
+	//Returns true once the request finished, handing over the route and retiring the id.
+	virtual bool GetPathResult(uint32 id, IPath &path, bool &partial, bool &stuck) { return false; }
+	virtual void CancelPath(uint32 id) { }
+
 	static IPathfinder *Load(const std::string &zone);
 };
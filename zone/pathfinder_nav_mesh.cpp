@@ -1,7 +1,16 @@
 #include "../common/global_define.h"
 #include "../common/eqemu_logsys.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <stdio.h>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "pathfinder_nav_mesh.h"
 #include <DetourCommon.h>
@@ -14,10 +23,129 @@
 
 extern Zone *zone;
 
+namespace
+{
+	//A corridor found between two polys under a given filter. Only the corridor is kept, the straight
+	//path and its smoothing depend on the exact endpoints and are redone on every lookup.
+	struct RouteKey
+	{
+		RouteKey(dtPolyRef s, dtPolyRef e, const PathfinderOptions &opts) : start_ref(s), end_ref(e), flags(opts.flags) {
+			memcpy(flag_cost, opts.flag_cost, sizeof(flag_cost));
+		}
+
+		bool operator==(const RouteKey &o) const {
+			return start_ref == o.start_ref && end_ref == o.end_ref && flags == o.flags && memcmp(flag_cost, o.flag_cost, sizeof(flag_cost)) == 0;
+		}
+
+		dtPolyRef start_ref;
+		dtPolyRef end_ref;
+		int flags;
+		float flag_cost[10];
+	};
+
+	struct RouteKeyHash
+	{
+		size_t operator()(const RouteKey &k) const {
+			size_t h = std::hash<uint64>()(static_cast<uint64>(k.start_ref));
+			h ^= std::hash<uint64>()(static_cast<uint64>(k.end_ref)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<int>()(k.flags) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	struct PathJob
+	{
+		uint32 id;
+		glm::vec3 start;
+		glm::vec3 end;
+		PathfinderOptions opts;
+	};
+
+	struct PathResult
+	{
+		IPathfinder::IPath route;
+		bool partial;
+		bool stuck;
+	};
+}
+
 struct PathfinderNavmesh::Implementation
 {
 	dtNavMesh *nav_mesh;
 	dtNavMeshQuery *query;
+
+	//lru of recent corridors, most recently used at the front
+	typedef std::list<std::pair<RouteKey, std::vector<dtPolyRef>>> CacheList;
+	std::mutex cache_lock;
+	std::atomic<int> cache_size{ 0 };
+	CacheList cache_order;
+	std::unordered_map<RouteKey, CacheList::iterator, RouteKeyHash> cache;
+
+	//requests waiting for a worker, requests not yet handed back and finished routes
+	std::mutex job_lock;
+	std::condition_variable job_cv;
+	std::deque<PathJob> jobs;
+	std::unordered_set<uint32> pending;
+	std::unordered_map<uint32, PathResult> results;
+	std::vector<std::thread> workers;
+	int worker_nodes = 0;
+	bool stopping = false;
+	uint32 next_id = 0;
+	size_t peak_queue = 0;
+
+	std::atomic<uint64> cache_hits{ 0 };
+	std::atomic<uint64> cache_misses{ 0 };
+	std::atomic<uint64> sync_requests{ 0 };
+	std::atomic<uint64> async_requests{ 0 };
+	std::atomic<uint64> direct_routes{ 0 };
+
+	bool FindCachedRoute(const RouteKey &key, dtPolyRef *path, int *npoly, int max_polys) {
+		if (cache_size <= 0) {
+			return false;
+		}
+
+		std::lock_guard<std::mutex> guard(cache_lock);
+		auto iter = cache.find(key);
+		if (iter == cache.end()) {
+			cache_misses++;
+			return false;
+		}
+
+		cache_order.splice(cache_order.begin(), cache_order, iter->second);
+		auto &polys = iter->second->second;
+		*npoly = std::min(static_cast<int>(polys.size()), max_polys);
+		std::copy(polys.begin(), polys.begin() + *npoly, path);
+		cache_hits++;
+		return true;
+	}
+
+	void AddCachedRoute(const RouteKey &key, const dtPolyRef *path, int npoly) {
+		int size = cache_size;
+		if (size <= 0 || npoly <= 0) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> guard(cache_lock);
+		auto iter = cache.find(key);
+		if (iter != cache.end()) {
+			iter->second->second.assign(path, path + npoly);
+			cache_order.splice(cache_order.begin(), cache_order, iter->second);
+			return;
+		}
+
+		cache_order.emplace_front(key, std::vector<dtPolyRef>(path, path + npoly));
+		cache.emplace(key, cache_order.begin());
+		while (cache_order.size() > static_cast<size_t>(size)) {
+			cache.erase(cache_order.back().first);
+			cache_order.pop_back();
+		}
+	}
+
+	void ClearCache() {
+		std::lock_guard<std::mutex> guard(cache_lock);
+		cache.clear();
+		cache_order.clear();
+	}
 };
 
 PathfinderNavmesh::PathfinderNavmesh(const std::string &path)
@@ -147,33 +275,41 @@ IPathfinder::IPath PathfinderNavmesh::FindPath(const glm::vec3 &start, const glm
 {
 	partial = false;
 	
-	if (!m_impl->nav_mesh) {
+	if (!m_impl->nav_mesh || CanMoveDirectly(start, end)) {
 		IPath Route;
 		Route.push_back(start);
 		Route.push_back(end);
 		return Route;
 	}
 	
+	if (!m_impl->query) {
+		m_impl->query = dtAllocNavMeshQuery();
+	}
+	
+	m_impl->query->init(m_impl->nav_mesh, RuleI(Pathing, MaxNavmeshNodes));
+	m_impl->cache_size = std::max(RuleI(Pathing, RouteCacheSize), 0);
+	m_impl->sync_requests++;
+	return FindNavMeshPath(m_impl->query, start, end, partial, stuck, opts);
+}
+
+bool PathfinderNavmesh::CanMoveDirectly(const glm::vec3 &start, const glm::vec3 &end) const
+{
 	if (Distance(start, end) < 200.0f && zone->zonemap->CheckLoS(start, end)) {
 		if (zone->HasWaterMap() && (zone->watermap->InLiquid(start) || zone->IsWaterZone(start.z)) && (zone->watermap->InLiquid(end) || zone->IsWaterZone(end.z))) {
-			IPath Route;
-			Route.push_back(start);
-			Route.push_back(end);
-			return Route;
+			return true;
 		}
 		if (zone->zonemap->NoHazardsAccurate(start, end, 6.0, 50, 5.0)) {
-			IPath Route;
-			Route.push_back(start);
-			Route.push_back(end);
-			return Route;
+			return true;
 		}
 	}
-	
-	if (!m_impl->query) {
-		m_impl->query = dtAllocNavMeshQuery();
-	}
-	
-	m_impl->query->init(m_impl->nav_mesh, RuleI(Pathing, MaxNavmeshNodes));
+
+	return false;
+}
+
+//Only touches the nav mesh, the cache and the query passed in, so the path workers can call this
+//with their own query while the zone thread keeps running.
+IPathfinder::IPath PathfinderNavmesh::FindNavMeshPath(dtNavMeshQuery *query, const glm::vec3 &start, const glm::vec3 &end, bool &partial, bool &stuck, const PathfinderOptions &opts)
+{
 	glm::vec3 current_location(start.x, start.z, start.y);
 	glm::vec3 dest_location(end.x, end.z, end.y);
 	
@@ -195,8 +331,8 @@ IPathfinder::IPath PathfinderNavmesh::FindPath(const glm::vec3 &start, const glm
 	dtPolyRef end_ref;
 	glm::vec3 ext(10.0f, 200.0f, 10.0f);
 	
-	m_impl->query->findNearestPoly(&current_location[0], &ext[0], &filter, &start_ref, 0);
-	m_impl->query->findNearestPoly(&dest_location[0], &ext[0], &filter, &end_ref, 0);
+	query->findNearestPoly(&current_location[0], &ext[0], &filter, &start_ref, 0);
+	query->findNearestPoly(&dest_location[0], &ext[0], &filter, &end_ref, 0);
 	
 	if (!start_ref || !end_ref) {
 		IPath Route;
@@ -207,12 +343,16 @@ IPathfinder::IPath PathfinderNavmesh::FindPath(const glm::vec3 &start, const glm
 	
 	int npoly = 0;
 	dtPolyRef path[max_polys] = { 0 };
-	auto status = m_impl->query->findPath(start_ref, end_ref, &current_location[0], &dest_location[0], &filter, path, &npoly, max_polys);
+	RouteKey key(start_ref, end_ref, opts);
+	if (!m_impl->FindCachedRoute(key, path, &npoly, max_polys)) {
+		query->findPath(start_ref, end_ref, &current_location[0], &dest_location[0], &filter, path, &npoly, max_polys);
+		m_impl->AddCachedRoute(key, path, npoly);
+	}
 	
 	if (npoly) {
 		glm::vec3 epos = dest_location;
 		if (path[npoly - 1] != end_ref) {
-			m_impl->query->closestPointOnPoly(path[npoly - 1], &dest_location[0], &epos[0], 0);
+			query->closestPointOnPoly(path[npoly - 1], &dest_location[0], &epos[0], 0);
 			partial = true;
 			
 			auto dist = DistanceSquared(epos, current_location);
@@ -226,9 +366,9 @@ IPathfinder::IPath PathfinderNavmesh::FindPath(const glm::vec3 &start, const glm
 		unsigned char straight_path_flags[max_polys];
 		dtPolyRef straight_path_polys[max_polys];
 	
-		auto status = m_impl->query->findStraightPath(&current_location[0], &epos[0], path, npoly,
+		auto status = query->findStraightPath(&current_location[0], &epos[0], path, npoly,
 			(float*)&straight_path[0], straight_path_flags,
-			straight_path_polys, &n_straight_polys, 2048, DT_STRAIGHTPATH_AREA_CROSSINGS | DT_STRAIGHTPATH_ALL_CROSSINGS);
+			straight_path_polys, &n_straight_polys, max_polys, DT_STRAIGHTPATH_AREA_CROSSINGS | DT_STRAIGHTPATH_ALL_CROSSINGS);
 	
 		if (dtStatusFailed(status)) {
 			IPath Route;
@@ -352,6 +492,140 @@ IPathfinder::IPath PathfinderNavmesh::FindPath(const glm::vec3 &start, const glm
 	return Route;
 }
 
+uint32 PathfinderNavmesh::RequestPath(const glm::vec3 &start, const glm::vec3 &end, const PathfinderOptions &opts)
+{
+	int count = RuleI(Pathing, AsyncWorkers);
+	int max_nodes = RuleI(Pathing, MaxNavmeshNodes);
+	if (!m_impl->nav_mesh || count <= 0) {
+		if (!m_impl->workers.empty()) {
+			StopWorkers();
+		}
+		return 0;
+	}
+
+	if (static_cast<int>(m_impl->workers.size()) != count || m_impl->worker_nodes != max_nodes) {
+		StopWorkers();
+		StartWorkers(count, max_nodes);
+	}
+
+	m_impl->cache_size = std::max(RuleI(Pathing, RouteCacheSize), 0);
+	m_impl->async_requests++;
+
+	//the direct route checks read zone state, they stay on this thread and finish right away
+	bool direct = CanMoveDirectly(start, end);
+
+	std::lock_guard<std::mutex> guard(m_impl->job_lock);
+	uint32 id = ++m_impl->next_id;
+	if (id == 0) {
+		id = ++m_impl->next_id;
+	}
+
+	if (direct) {
+		PathResult &res = m_impl->results[id];
+		res.route.push_back(start);
+		res.route.push_back(end);
+		res.partial = false;
+		res.stuck = false;
+		m_impl->direct_routes++;
+		return id;
+	}
+
+	m_impl->jobs.push_back({ id, start, end, opts });
+	m_impl->pending.insert(id);
+	m_impl->peak_queue = std::max(m_impl->peak_queue, m_impl->jobs.size());
+	m_impl->job_cv.notify_one();
+	return id;
+}
+
+bool PathfinderNavmesh::GetPathResult(uint32 id, IPath &path, bool &partial, bool &stuck)
+{
+	std::lock_guard<std::mutex> guard(m_impl->job_lock);
+	auto iter = m_impl->results.find(id);
+	if (iter == m_impl->results.end()) {
+		return false;
+	}
+
+	path = std::move(iter->second.route);
+	partial = iter->second.partial;
+	stuck = iter->second.stuck;
+	m_impl->results.erase(iter);
+	return true;
+}
+
+void PathfinderNavmesh::CancelPath(uint32 id)
+{
+	std::lock_guard<std::mutex> guard(m_impl->job_lock);
+	m_impl->results.erase(id);
+	if (m_impl->pending.erase(id) == 0) {
+		return;
+	}
+
+	auto iter = std::find_if(m_impl->jobs.begin(), m_impl->jobs.end(), [id](const PathJob &job) { return job.id == id; });
+	if (iter != m_impl->jobs.end()) {
+		m_impl->jobs.erase(iter);
+	}
+}
+
+void PathfinderNavmesh::StartWorkers(int count, int max_nodes)
+{
+	m_impl->stopping = false;
+	m_impl->worker_nodes = max_nodes;
+	for (int i = 0; i < count; ++i) {
+		m_impl->workers.emplace_back(&PathfinderNavmesh::WorkerMain, this, max_nodes);
+	}
+
+	LogPathing("Started [{}] navmesh path workers", count);
+}
+
+void PathfinderNavmesh::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_impl->job_lock);
+		m_impl->stopping = true;
+	}
+
+	m_impl->job_cv.notify_all();
+	for (auto &t : m_impl->workers) {
+		t.join();
+	}
+
+	m_impl->workers.clear();
+	m_impl->stopping = false;
+}
+
+void PathfinderNavmesh::WorkerMain(int max_nodes)
+{
+	dtNavMeshQuery *query = dtAllocNavMeshQuery();
+	query->init(m_impl->nav_mesh, max_nodes);
+
+	std::unique_lock<std::mutex> lock(m_impl->job_lock);
+	for (;;) {
+		m_impl->job_cv.wait(lock, [this]() { return m_impl->stopping || !m_impl->jobs.empty(); });
+
+		//queued requests are finished before stopping so nobody waits on a route that never comes
+		if (m_impl->jobs.empty()) {
+			break;
+		}
+
+		PathJob job = std::move(m_impl->jobs.front());
+		m_impl->jobs.pop_front();
+		lock.unlock();
+
+		PathResult res;
+		res.partial = false;
+		res.stuck = false;
+		res.route = FindNavMeshPath(query, job.start, job.end, res.partial, res.stuck, job.opts);
+
+		lock.lock();
+		if (m_impl->pending.erase(job.id)) {
+			m_impl->results[job.id] = std::move(res);
+		}
+	}
+
+	lock.unlock();
+	dtFreeNavMeshQuery(query);
+}
+
 glm::vec3 PathfinderNavmesh::GetRandomLocation(const glm::vec3 &start, int flags)
 {
 	if (start.x == 0.0f && start.y == 0.0f)
@@ -408,6 +682,25 @@ void PathfinderNavmesh::DebugCommand(Client *c, const Seperator *sep)
 	{
 		c->Message(Chat::Yellow, "This zone is using NavMesh.");
 		c->Message(Chat::White, "#path show: Plots a path from the user to their target.");
+		c->Message(Chat::White, "#path stats [reset]: Shows path worker and route cache statistics.");
+		return;
+	}
+
+	if (!strcasecmp(sep->arg[1], "stats"))
+	{
+		if (!strcasecmp(sep->arg[2], "reset")) {
+			m_impl->cache_hits = 0;
+			m_impl->cache_misses = 0;
+			m_impl->sync_requests = 0;
+			m_impl->async_requests = 0;
+			m_impl->direct_routes = 0;
+			std::lock_guard<std::mutex> guard(m_impl->job_lock);
+			m_impl->peak_queue = m_impl->jobs.size();
+			c->Message(Chat::White, "Path stats reset.");
+			return;
+		}
+
+		ShowStats(c);
 		return;
 	}
 
@@ -425,14 +718,56 @@ void PathfinderNavmesh::DebugCommand(Client *c, const Seperator *sep)
 	}
 }
 
+void PathfinderNavmesh::ShowStats(Client *c)
+{
+	size_t queued = 0;
+	size_t in_flight = 0;
+	size_t finished = 0;
+	size_t peak = 0;
+	size_t workers = m_impl->workers.size();
+	{
+		std::lock_guard<std::mutex> guard(m_impl->job_lock);
+		queued = m_impl->jobs.size();
+		in_flight = m_impl->pending.size() - queued;
+		finished = m_impl->results.size();
+		peak = m_impl->peak_queue;
+	}
+
+	size_t cached = 0;
+	{
+		std::lock_guard<std::mutex> guard(m_impl->cache_lock);
+		cached = m_impl->cache.size();
+	}
+
+	uint64 hits = m_impl->cache_hits;
+	uint64 misses = m_impl->cache_misses;
+	double hit_rate = hits + misses > 0 ? static_cast<double>(hits) * 100.0 / static_cast<double>(hits + misses) : 0.0;
+
+	c->Message(Chat::White, fmt::format("Path workers: {} | Queued: {} (peak {}) | Running: {} | Awaiting pickup: {}", workers, queued, peak, in_flight, finished).c_str());
+	c->Message(Chat::White, fmt::format("Requests: {} async, {} sync, {} direct", m_impl->async_requests.load(), m_impl->sync_requests.load(), m_impl->direct_routes.load()).c_str());
+	c->Message(Chat::White, fmt::format("Route cache: {} / {} | Hits: {} | Misses: {} | Hit rate: {:.1f}%", cached, m_impl->cache_size.load(), hits, misses, hit_rate).c_str());
+}
+
 void PathfinderNavmesh::Clear()
 {
+	{
+		std::lock_guard<std::mutex> guard(m_impl->job_lock);
+		m_impl->jobs.clear();
+		m_impl->pending.clear();
+		m_impl->results.clear();
+	}
+
+	StopWorkers();
+	m_impl->ClearCache();
+
 	if (m_impl->nav_mesh) {
 		dtFreeNavMesh(m_impl->nav_mesh);
+		m_impl->nav_mesh = nullptr;
 	}
 
 	if (m_impl->query) {
 		dtFreeNavMeshQuery(m_impl->query);
+		m_impl->query = nullptr;
 	}
 }
 
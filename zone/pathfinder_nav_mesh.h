@@ -4,6 +4,8 @@
 #include <string>
 #include <DetourNavMesh.h>
 
+class dtNavMeshQuery;
+
 class PathfinderNavmesh : public IPathfinder
 {
 public:
@@ -15,11 +17,20 @@ public:
 	virtual IPath FindPath(const glm::vec3 &start, const glm::vec3 &end, bool &partial, bool &stuck, const PathfinderOptions& opts);
 	virtual glm::vec3 GetRandomLocation(const glm::vec3 &start, int flags = PathingNotDisabled);
 	virtual void DebugCommand(Client* c, const Seperator* sep);
+	virtual uint32 RequestPath(const glm::vec3 &start, const glm::vec3 &end, const PathfinderOptions &opts);
+	virtual bool GetPathResult(uint32 id, IPath &path, bool &partial, bool &stuck);
+	virtual void CancelPath(uint32 id);
 
 private:
 	void Clear();
 	void Load(const std::string &path);
 	void ShowPath(Client *c, const glm::vec3 &start, const glm::vec3 &end);
+	void ShowStats(Client *c);
+	bool CanMoveDirectly(const glm::vec3 &start, const glm::vec3 &end) const;
+	IPath FindNavMeshPath(dtNavMeshQuery *query, const glm::vec3 &start, const glm::vec3 &end, bool &partial, bool &stuck, const PathfinderOptions &opts);
+	void StartWorkers(int count, int max_nodes);
+	void StopWorkers();
+	void WorkerMain(int max_nodes);
 	dtStatus GetPolyHeightNoConnections(dtPolyRef ref, const float *pos, float *height) const;
 	dtStatus GetPolyHeightOnPath(const dtPolyRef *path, const int path_len, const glm::vec3 &pos, float *h) const;
 
@@ -810,6 +810,8 @@ void NPC::SetPetState(SpellBuff_Struct *pet_buffs, uint32 *items) {
 		}
 	}
 
+	RebuildEffectIndex();
+
 	//restore their equipment...
 	for (i = 0; i < EQ::invslot::EQUIPMENT_COUNT; i++) {
 		if(items[i] == 0)
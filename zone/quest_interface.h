@@ -24,6 +24,7 @@
 #include <any>
 
 class Client;
+class Mob;
 class NPC;
 
 namespace EQ
@@ -220,6 +221,14 @@ public:
 	virtual void ReloadQuests() { }
 	virtual uint32 GetIdentifier() = 0;
 	virtual void RemoveEncounter(const std::string& name) { }
+	// called once per zone tick
+	virtual void Process() { }
+	// script heap in use, 0 if the interface doesn't track one
+	virtual uint64 GetHeapKB() { return 0; }
+	// events run and the script heap they grew by in total
+	virtual void GetEventAllocStats(uint64 &events, uint64 &bytes) { events = 0; bytes = 0; }
+	// the mob is being destroyed, drop anything the interface holds for it
+	virtual void RemoveEntity(Mob *mob) { }
 	
 	virtual void GetErrors(std::list<std::string>& quest_errors)
 	{
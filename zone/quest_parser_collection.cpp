@@ -924,6 +924,42 @@ void QuestParserCollection::GetErrors(std::list<std::string>& quest_errors)
 	}
 }
 
+void QuestParserCollection::Process()
+{
+	for (const auto& e : _load_precedence) {
+		e->Process();
+	}
+}
+
+uint64 QuestParserCollection::GetHeapKB()
+{
+	uint64 heap_kb = 0;
+	for (const auto& e : _load_precedence) {
+		heap_kb += e->GetHeapKB();
+	}
+
+	return heap_kb;
+}
+
+void QuestParserCollection::GetEventAllocStats(uint64 &events, uint64 &bytes)
+{
+	events = 0;
+	bytes  = 0;
+	for (const auto& e : _load_precedence) {
+		uint64 e_events, e_bytes;
+		e->GetEventAllocStats(e_events, e_bytes);
+		events += e_events;
+		bytes  += e_bytes;
+	}
+}
+
+void QuestParserCollection::RemoveEntity(Mob *mob)
+{
+	for (const auto& e : _load_precedence) {
+		e->RemoveEntity(mob);
+	}
+}
+
 int QuestParserCollection::DispatchEventNPC(
 	QuestEventID event_id,
 	NPC* npc,
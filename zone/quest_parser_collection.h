@@ -125,6 +125,10 @@ public:
 	);
 
 	void GetErrors(std::list<std::string> &quest_errors);
+	void Process();
+	uint64 GetHeapKB();
+	void GetEventAllocStats(uint64 &events, uint64 &bytes);
+	void RemoveEntity(Mob *mob);
 
 private:
 	bool HasQuestSubLocal(uint32 npc_id, QuestEventID event_id);
@@ -68,64 +68,214 @@ QuestManager quest_manager;
 QuestManager::QuestManager() {
 	HaveProximitySays = false;
 	item_timers = 0;
+	next_timer_id = 0;
+	next_timer_seq = 0;
+	timer_clock = 0;
+	timer_clock_last = Timer::GetCurrentTime();
 }
 
 QuestManager::~QuestManager() {
 }
 
 void QuestManager::Process() {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->Timer_.Enabled() && cur->Timer_.Check()) {
-			if (cur->mob) {
-				if (cur->mob->IsNPC()) {
-					if (parse->HasQuestSub(cur->mob->GetNPCTypeID(), EVENT_TIMER)) {
-						parse->EventNPC(EVENT_TIMER, cur->mob->CastToNPC(), nullptr, cur->name, 0);
-					}
-				}
-				else if (cur->mob->IsEncounter()) {
-					parse->EventEncounter(
-						EVENT_TIMER, 
-						cur->mob->CastToEncounter()->GetEncounterName(), 
-						cur->name, 
-						0, 
-						nullptr
-					);
-				}
-				else if (cur->mob->IsClient()) {
-					if (parse->PlayerHasQuestSub(EVENT_TIMER)) {
-						//this is inheriently unsafe if we ever make it so more than npc/client start timers
-						parse->EventPlayer(EVENT_TIMER, cur->mob->CastToClient(), cur->name, 0);
-					}
-				}
+	uint64 now = TimerClock();
 
-				//we MUST reset our iterator since the quest could have removed/added any
-				//number of timers... worst case we have to check a bunch of timers twice
-				cur = QTimerList.begin();
-				end = QTimerList.end();    //dunno if this is needed, cant hurt...
-			}
-			else {
-				cur = QTimerList.erase(cur);
-			}
+	//timers that are due again right away wait for the next pass
+	std::vector<TimerDeadline> deferred;
+	while (!QTimerQueue.empty() && QTimerQueue.top().deadline <= now) {
+		TimerDeadline next = QTimerQueue.top();
+		QTimerQueue.pop();
+
+		auto iter = QTimers.find(next.id);
+		if (iter == QTimers.end() || iter->second.version != next.version) {
+			continue;
+		}
+
+		QuestTimer &cur = iter->second;
+		if (!cur.Timer_.Check()) {
+			ScheduleQuestTimer(cur);
+			continue;
+		}
+
+		if (!cur.mob) {
+			QTimers.erase(iter);
+			continue;
+		}
+
+		//queue the next run before the event, the quest may stop, restart or add
+		//any number of timers and cur may not survive it
+		Mob *mob = cur.mob;
+		std::string name = cur.name;
+		TimerDeadline again = { now + cur.Timer_.GetRemainingTime(), next_timer_seq++, cur.id, cur.version };
+		if (again.deadline > now) {
+			QTimerQueue.push(again);
 		}
 		else {
-			++cur;
+			deferred.push_back(again);
+		}
+
+		if (mob->IsNPC()) {
+			if (parse->HasQuestSub(mob->GetNPCTypeID(), EVENT_TIMER)) {
+				parse->EventNPC(EVENT_TIMER, mob->CastToNPC(), nullptr, name, 0);
+			}
+		}
+		else if (mob->IsEncounter()) {
+			parse->EventEncounter(
+				EVENT_TIMER, 
+				mob->CastToEncounter()->GetEncounterName(), 
+				name, 
+				0, 
+				nullptr
+			);
 		}
+		else if (mob->IsClient()) {
+			if (parse->PlayerHasQuestSub(EVENT_TIMER)) {
+				//this is inheriently unsafe if we ever make it so more than npc/client start timers
+				parse->EventPlayer(EVENT_TIMER, mob->CastToClient(), name, 0);
+			}
+		}
+	}
+
+	for (auto &d : deferred) {
+		QTimerQueue.push(d);
+	}
+
+	while (!STimerQueue.empty() && STimerQueue.top().deadline <= now) {
+		SignalTimer signal = STimerQueue.top();
+		STimerQueue.pop();
+		entity_list.SignalMobsByNPCID(signal.npc_id, signal.signal_id, &signal.data[0]);
+	}
+}
+
+uint64 QuestManager::TimerClock() {
+	uint32 now = Timer::GetCurrentTime();
+	timer_clock += static_cast<uint32>(now - timer_clock_last);
+	timer_clock_last = now;
+	return timer_clock;
+}
+
+QuestManager::QuestTimer *QuestManager::FindQuestTimer(Mob *mob, const std::string &name) {
+	if (!mob) {
+		return nullptr;
+	}
+
+	auto owner = QTimerIndex.find(mob);
+	if (owner == QTimerIndex.end()) {
+		return nullptr;
+	}
+
+	auto id = owner->second.find(name);
+	if (id == owner->second.end()) {
+		return nullptr;
+	}
+
+	auto iter = QTimers.find(id->second);
+	return iter != QTimers.end() ? &iter->second : nullptr;
+}
+
+void QuestManager::AddQuestTimer(QuestTimer &&timer) {
+	uint64 id = ++next_timer_id;
+	auto &t = QTimers.emplace(id, std::move(timer)).first->second;
+	t.id = id;
+
+	//timers without an owner can't be looked up by name, they fire once and go away
+	if (t.mob) {
+		QTimerIndex[t.mob][t.name] = id;
+	}
+
+	ScheduleQuestTimer(t);
+}
+
+void QuestManager::ScheduleQuestTimer(QuestTimer &timer) {
+	timer.version++;
+	QTimerQueue.push({ TimerClock() + timer.Timer_.GetRemainingTime(), next_timer_seq++, timer.id, timer.version });
+	CompactQuestTimerQueue();
+}
+
+//a quest that re-arms a long timer on every hit leaves one stale entry per call until
+//the old deadline comes up, so rebuild the queue from the live entries once stale ones
+//are more than half of it. Each rebuild at least halves the queue, which keeps it cheap.
+void QuestManager::CompactQuestTimerQueue() {
+	if (QTimerQueue.size() <= 2 * QTimers.size()) {
+		return;
 	}
 
-	auto cur_iter = STimerList.begin();
-	while(cur_iter != STimerList.end()) {
-		if(!cur_iter->Timer_.Enabled()) {
-			cur_iter = STimerList.erase(cur_iter);
-		} else if(cur_iter->Timer_.Check()) {
-			entity_list.SignalMobsByNPCID(cur_iter->npc_id, cur_iter->signal_id, &cur_iter->data[0]);
-			cur_iter = STimerList.erase(cur_iter);
-		} else {
-			++cur_iter;
+	std::vector<TimerDeadline> live;
+	live.reserve(QTimers.size());
+	while (!QTimerQueue.empty()) {
+		const TimerDeadline &d = QTimerQueue.top();
+		auto iter = QTimers.find(d.id);
+		if (iter != QTimers.end() && iter->second.version == d.version) {
+			live.push_back(d);
 		}
+		QTimerQueue.pop();
+	}
+
+	QTimerQueue = TimerQueue(std::greater<TimerDeadline>(), std::move(live));
+}
+
+void QuestManager::RemoveQuestTimer(Mob *mob, const std::string &name) {
+	auto owner = QTimerIndex.find(mob);
+	if (owner == QTimerIndex.end()) {
+		return;
+	}
+
+	auto id = owner->second.find(name);
+	if (id == owner->second.end()) {
+		return;
+	}
+
+	QTimers.erase(id->second);
+	owner->second.erase(id);
+	if (owner->second.empty()) {
+		QTimerIndex.erase(owner);
 	}
+
+	CompactQuestTimerQueue();
+}
+
+void QuestManager::RemoveQuestTimers(Mob *mob) {
+	auto owner = QTimerIndex.find(mob);
+	if (owner == QTimerIndex.end()) {
+		return;
+	}
+
+	for (auto &e : owner->second) {
+		QTimers.erase(e.second);
+	}
+
+	QTimerIndex.erase(owner);
+	CompactQuestTimerQueue();
+}
+
+QuestManager::PausedTimer *QuestManager::FindPausedTimer(Mob *mob, const std::string &name) {
+	if (!mob) {
+		return nullptr;
+	}
+
+	auto owner = PTimers.find(mob);
+	if (owner == PTimers.end()) {
+		return nullptr;
+	}
+
+	auto iter = owner->second.find(name);
+	return iter != owner->second.end() ? &iter->second : nullptr;
+}
+
+void QuestManager::RemovePausedTimer(Mob *mob, const std::string &name) {
+	auto owner = PTimers.find(mob);
+	if (owner == PTimers.end()) {
+		return;
+	}
+
+	owner->second.erase(name);
+	if (owner->second.empty()) {
+		PTimers.erase(owner);
+	}
+}
+
+void QuestManager::RemovePausedTimers(Mob *mob) {
+	PTimers.erase(mob);
 }
 
 void QuestManager::StartQuest(Mob *_owner, Client *_initiator, EQ::ItemInstance* _questitem, std::string encounter) {
@@ -142,32 +292,18 @@ void QuestManager::EndQuest() {
 	running_quest run = quests_running_.top();
 	if(run.depop_npc && run.owner->IsNPC()) {
 		//clear out any timers for them...
-		std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-		end = QTimerList.end();
-		while (cur != end) {
-			if (cur->mob == run.owner)
-				cur = QTimerList.erase(cur);
-			else
-				++cur;
-		}
-		std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
-
-		pend = PTimerList.end();
-		while (pcur != pend) {
-			if (pcur->owner == run.owner)
-				pcur = PTimerList.erase(pcur);
-			else
-				++pcur;
-		}
+		RemoveQuestTimers(run.owner);
+		RemovePausedTimers(run.owner);
 		run.owner->Depop();
 	}
 	quests_running_.pop();
 }
 
 void QuestManager::ClearAllTimers() {
-	QTimerList.clear();
-	PTimerList.clear();
+	QTimers.clear();
+	QTimerIndex.clear();
+	QTimerQueue = TimerQueue();
+	PTimers.clear();
 }
 
 //quest perl functions
@@ -438,20 +574,15 @@ void QuestManager::settimer(const char *timer_name, int seconds) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(seconds * 1000, false);
-			return;
-		}
-		++cur;
+	QuestTimer *timer = FindQuestTimer(owner, timer_name);
+	if (timer) {
+		timer->Timer_.Enable();
+		timer->Timer_.Start(seconds * 1000, false);
+		ScheduleQuestTimer(*timer);
+		return;
 	}
 
-	QTimerList.emplace_back(QuestTimer(seconds * 1000, owner, timer_name));
+	AddQuestTimer(QuestTimer(seconds * 1000, owner, timer_name));
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds) {
@@ -462,20 +593,15 @@ void QuestManager::settimerMS(const char *timer_name, int milliseconds) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(milliseconds, true);
-			return;
-		}
-		++cur;
+	QuestTimer *timer = FindQuestTimer(owner, timer_name);
+	if (timer) {
+		timer->Timer_.Enable();
+		timer->Timer_.Start(milliseconds, true);
+		ScheduleQuestTimer(*timer);
+		return;
 	}
 
-	QTimerList.emplace_back(QuestTimer(milliseconds, owner, timer_name));
+	AddQuestTimer(QuestTimer(milliseconds, owner, timer_name));
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds, EQ::ItemInstance *inst) {
@@ -485,20 +611,15 @@ void QuestManager::settimerMS(const char *timer_name, int milliseconds, EQ::Item
 }
 
 void QuestManager::settimerMS(const char *timer_name, int milliseconds, Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob && cur->name == timer_name)
-		{
-			cur->Timer_.Enable();
-			cur->Timer_.Start(milliseconds, false);
-			return;
-		}
-		++cur;
+	QuestTimer *timer = FindQuestTimer(mob, timer_name);
+	if (timer) {
+		timer->Timer_.Enable();
+		timer->Timer_.Start(milliseconds, false);
+		ScheduleQuestTimer(*timer);
+		return;
 	}
 
-	QTimerList.emplace_back(QuestTimer(milliseconds, mob, timer_name));
+	AddQuestTimer(QuestTimer(milliseconds, mob, timer_name));
 }
 
 void QuestManager::stoptimer(const char *timer_name) {
@@ -509,26 +630,7 @@ void QuestManager::stoptimer(const char *timer_name) {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == owner && cur->name == timer_name) {
-			QTimerList.erase(cur);
-			return;
-		}
-		++cur;
-	}
-
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
-	pend = PTimerList.end();
-	while (pcur != pend) {
-		if (pcur->owner && pcur->owner == owner && pcur->name == timer_name) {
-			PTimerList.erase(pcur);
-			return;
-		}
-		++pcur;
-	}
+	stoptimer(timer_name, owner);
 }
 
 void QuestManager::stoptimer(const char *timer_name, EQ::ItemInstance *inst) {
@@ -538,26 +640,12 @@ void QuestManager::stoptimer(const char *timer_name, EQ::ItemInstance *inst) {
 }
 
 void QuestManager::stoptimer(const char *timer_name, Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob && cur->name == timer_name) {
-			QTimerList.erase(cur);
-			return;
-		}
-		++cur;
+	if (FindQuestTimer(mob, timer_name)) {
+		RemoveQuestTimer(mob, timer_name);
+		return;
 	}
 
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
-	pend = PTimerList.end();
-	while (pcur != pend) {
-		if (pcur->owner && pcur->owner == mob && pcur->name == timer_name) {
-			PTimerList.erase(pcur);
-			return;
-		}
-		++pcur;
-	}
+	RemovePausedTimer(mob, timer_name);
 }
 
 void QuestManager::stopalltimers() {
@@ -568,25 +656,7 @@ void QuestManager::stopalltimers() {
 		return;
 	}
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end, tmp;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if(cur->mob && cur->mob == owner)
-			cur = QTimerList.erase(cur);
-		else
-			++cur;
-	}
-
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend, ptmp;
-
-	pend = PTimerList.end();
-	while (pcur != pend) {
-		if (pcur->owner && pcur->owner == owner)
-			pcur = PTimerList.erase(pcur);
-		else
-			++pcur;
-	}
+	stopalltimers(owner);
 }
 
 void QuestManager::stopalltimers(EQ::ItemInstance *inst) {
@@ -596,58 +666,33 @@ void QuestManager::stopalltimers(EQ::ItemInstance *inst) {
 }
 
 void QuestManager::stopalltimers(Mob *mob) {
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end, tmp;
-
-	end = QTimerList.end();
-	while (cur != end) {
-		if (cur->mob && cur->mob == mob)
-			cur = QTimerList.erase(cur);
-		else
-			++cur;
+	if (!mob) {
+		return;
 	}
 
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend, ptmp;
-
-	pend = PTimerList.end();
-	while (pcur != pend) {
-		if (pcur->owner && pcur->owner == mob)
-			pcur = PTimerList.erase(pcur);
-		else
-			++pcur;
-	}
+	RemoveQuestTimers(mob);
+	RemovePausedTimers(mob);
 }
 
 void QuestManager::pausetimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
 	PausedTimer pt;
 	uint32 milliseconds = 0;
 	uint32 duration = 0;
 
-	pend = PTimerList.end();
-	while (pcur != pend) 
+	if (FindPausedTimer(owner, timer_name))
 	{
-		if (pcur->owner && pcur->owner == owner && pcur->name == timer_name) 
-		{
-			Log(Logs::General, Logs::Quests, "Timer %s is already paused for %s. Returning...", timer_name, owner->GetName());
-			return;
-		}
-		++pcur;
+		Log(Logs::General, Logs::Quests, "Timer %s is already paused for %s. Returning...", timer_name, owner->GetName());
+		return;
 	}
 
-	end = QTimerList.end();
-	while (cur != end) 
+	QuestTimer *timer = FindQuestTimer(owner, timer_name);
+	if (timer)
 	{
-		if (cur->mob && cur->mob == owner && cur->name == timer_name) 
-		{
-			milliseconds = cur->Timer_.GetRemainingTime();
-			duration = cur->Timer_.GetDuration();
-			QTimerList.erase(cur);
-			break;
-		}
-		++cur;
+		milliseconds = timer->Timer_.GetRemainingTime();
+		duration = timer->Timer_.GetDuration();
+		RemoveQuestTimer(owner, timer_name);
 	}
 
 	std::string timername = timer_name;
@@ -656,29 +701,21 @@ void QuestManager::pausetimer(const char *timer_name) {
 	pt.time = milliseconds;
 	pt.duration = duration;
 	Log(Logs::General, Logs::Quests, "Pausing timer %s for %s with %d ms remaining.", timer_name, owner->GetName(), milliseconds);
-	PTimerList.push_back(pt);
+	PTimers[owner][timername] = pt;
 }
 
 void QuestManager::resumetimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
-	PausedTimer pt;
 	uint32 milliseconds = 0;
 	uint32 duration = 0;
 
-	pend = PTimerList.end();
-	while (pcur != pend) 
+	PausedTimer *pt = FindPausedTimer(owner, timer_name);
+	if (pt)
 	{
-		if (pcur->owner && pcur->owner == owner && pcur->name == timer_name) 
-		{
-			milliseconds = pcur->time;
-			duration = pcur->duration;
-			PTimerList.erase(pcur);
-			break;
-		}
-		++pcur;
+		milliseconds = pt->time;
+		duration = pt->duration;
+		RemovePausedTimer(owner, timer_name);
 	}
 
 	if(milliseconds == 0)
@@ -687,19 +724,16 @@ void QuestManager::resumetimer(const char *timer_name) {
 		return;
 	}
 
-	end = QTimerList.end();
-	while (cur != end) 
+	QuestTimer *timer = FindQuestTimer(owner, timer_name);
+	if (timer)
 	{
-		if(cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			cur->Timer_.Start(milliseconds, false);
-			Log(Logs::General, Logs::Quests, "Resuming timer %s for %s with %d ms remaining.", timer_name, owner->GetName(), milliseconds);
-			return;
-		}
-		++cur;
+		timer->Timer_.Start(milliseconds, false);
+		ScheduleQuestTimer(*timer);
+		Log(Logs::General, Logs::Quests, "Resuming timer %s for %s with %d ms remaining.", timer_name, owner->GetName(), milliseconds);
+		return;
 	}
 
-	QTimerList.emplace_back(QuestTimer(duration, owner, timer_name, milliseconds));
+	AddQuestTimer(QuestTimer(duration, owner, timer_name, milliseconds));
 	LogQuests("Creating a new timer and resuming [{}] for [{}] with [{}] ms remaining", timer_name, owner->GetName(), milliseconds);
 	
 }
@@ -707,34 +741,16 @@ void QuestManager::resumetimer(const char *timer_name) {
 bool QuestManager::ispausedtimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<PausedTimer>::iterator pcur = PTimerList.begin(), pend;
-
-	pend = PTimerList.end();
-	while (pcur != pend) 
-	{
-		if (pcur->owner && pcur->owner == owner && pcur->name == timer_name) 
-		{
-			return true;
-		}
-		++pcur;
-	}
-
-	return false;
+	return FindPausedTimer(owner, timer_name) != nullptr;
 }
 
 int QuestManager::gettimer(const char *timer_name) {
 	QuestManagerCurrentQuestVars();
 
-	std::list<QuestTimer>::iterator cur = QTimerList.begin(), end;
-
-	end = QTimerList.end();
-	while (cur != end)
+	QuestTimer *timer = FindQuestTimer(owner, timer_name);
+	if (timer)
 	{
-		if (cur->mob && cur->mob == owner && cur->name == timer_name)
-		{
-			return cur->Timer_.GetRemainingTime();
-		}
-		++cur;
+		return timer->Timer_.GetRemainingTime();
 	}
 
 	return 0;
@@ -1299,7 +1315,7 @@ void QuestManager::itemlink(int item_id) {
 void QuestManager::signalwith(int npc_id, int signal_id, int wait_ms, const char* data)
 {
 	if (npc_id < 1000 || npc_id / 1000 == zone->GetZoneID() || npc_id / 1000 == database.GetClientZoneID(zone->GetZoneID()))
-		STimerList.emplace_back(SignalTimer(wait_ms < 0 ? 0 : wait_ms, npc_id, signal_id, data));
+		STimerQueue.push(SignalTimer(TimerClock() + (wait_ms < 0 ? 0 : wait_ms), next_timer_seq++, npc_id, signal_id, data));
 	else
 		CrossZoneSignalNPCByNPCTypeID(npc_id, signal_id, data);
 }
@@ -21,7 +21,11 @@
 #include "../common/timer.h"
 
 #include <list>
+#include <queue>
 #include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class Client;
 class Mob;
@@ -249,24 +253,61 @@ private:
 	class QuestTimer {
 	public:
 		inline QuestTimer(uint32 duration, Mob *_mob, std::string _name)
-			: mob(_mob), name(_name), Timer_(duration) { Timer_.Start(duration, false); }
+			: mob(_mob), name(_name), Timer_(duration), id(0), version(0) { Timer_.Start(duration, false); }
 		inline QuestTimer(uint32 duration, Mob *_mob, std::string _name, uint32 remaining)
-			: mob(_mob), name(_name), Timer_(duration) { Timer_.Start(remaining, false); Timer_.SetDuration(duration); }
+			: mob(_mob), name(_name), Timer_(duration), id(0), version(0) { Timer_.Start(remaining, false); Timer_.SetDuration(duration); }
 		Mob*   mob;
 		std::string name;
 		Timer Timer_;
+		uint64 id;
+		uint32 version; //bumped on every reschedule, older queue entries for the timer are stale
 	};
 	class SignalTimer {
 	public:
-		inline SignalTimer(int duration, int _npc_id, int _signal_id, const char* _data) : npc_id(_npc_id), signal_id(_signal_id), data(_data ? _data : ""), Timer_(duration) { Timer_.Start(duration, false); }
+		inline SignalTimer(uint64 _deadline, uint64 _seq, int _npc_id, int _signal_id, const char* _data) : deadline(_deadline), seq(_seq), npc_id(_npc_id), signal_id(_signal_id), data(_data ? _data : "") { }
+		bool operator>(const SignalTimer &o) const { return deadline > o.deadline || (deadline == o.deadline && seq > o.seq); }
+		uint64 deadline;
+		uint64 seq;
 		int npc_id;
 		int signal_id;
 		std::string data;
-		Timer Timer_;
 	};
-	std::list<QuestTimer>	QTimerList;
-	std::list<SignalTimer>	STimerList;
-	std::list<PausedTimer>	PTimerList;
+
+	//a deadline on the TimerClock, ties go to the entry queued first
+	struct TimerDeadline {
+		uint64 deadline;
+		uint64 seq;
+		uint64 id;
+		uint32 version;
+		bool operator>(const TimerDeadline &o) const { return deadline > o.deadline || (deadline == o.deadline && seq > o.seq); }
+	};
+	typedef std::priority_queue<TimerDeadline, std::vector<TimerDeadline>, std::greater<TimerDeadline>> TimerQueue;
+
+	//milliseconds on the Timer clock, widened so it never wraps
+	uint64 TimerClock();
+	QuestTimer *FindQuestTimer(Mob *mob, const std::string &name);
+	void AddQuestTimer(QuestTimer &&timer);
+	void ScheduleQuestTimer(QuestTimer &timer);
+	void CompactQuestTimerQueue();
+	void RemoveQuestTimer(Mob *mob, const std::string &name);
+	void RemoveQuestTimers(Mob *mob);
+	PausedTimer *FindPausedTimer(Mob *mob, const std::string &name);
+	void RemovePausedTimer(Mob *mob, const std::string &name);
+	void RemovePausedTimers(Mob *mob);
+
+	//quest timers by id, indexed by owner and name, and ordered by deadline. Stopped and
+	//restarted timers leave their old queue entry behind, Process skips it when it comes up
+	//and CompactQuestTimerQueue drops them early once they outnumber the live timers.
+	std::unordered_map<uint64, QuestTimer> QTimers;
+	std::unordered_map<Mob *, std::unordered_map<std::string, uint64>> QTimerIndex;
+	TimerQueue QTimerQueue;
+	//signal timers fire once and are never looked up, so the queue holds them directly
+	std::priority_queue<SignalTimer, std::vector<SignalTimer>, std::greater<SignalTimer>> STimerQueue;
+	std::unordered_map<Mob *, std::unordered_map<std::string, PausedTimer>> PTimers;
+	uint64 next_timer_id;
+	uint64 next_timer_seq;
+	uint64 timer_clock;
+	uint32 timer_clock_last;
 	size_t item_timers;
 
 };
@@ -0,0 +1,980 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "raycast_bvh.h"
+#include "position.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RAYCAST_BVH_SSE
+#endif
+
+namespace
+{
+
+const RmUint32 NoTriangle = 0xFFFFFFFF;
+const RmUint32 LeafSize = 4;
+// median splits keep the tree balanced, this is only a guard against bad input
+const int MaxDepth = 48;
+// every node visited pushes at most three more than it pops
+const int StackSize = MaxDepth * 3 + 4;
+// boxes are grown a little so float error in the slab test never culls a triangle
+// the exact triangle test would have hit
+const float BoxPad = 0.01f;
+// where unused child slots sit, no segment inside a zone can reach them
+const float EmptyBox = 1.0e30f;
+
+// The height field is a grid over x/y listing, per cell, the height range of every
+// triangle a vertical segment through the cell could hit, highest first. Vertical
+// segments, which is what the floor and ceiling searches cast, scan that list and
+// only run the triangle test on layers that can still beat the best hit so far.
+// Cells crossed by more triangles than this are marked dense and walk the tree.
+const RmUint32 ColumnMaxTriangles = 32;
+const RmUint32 ColumnMaxCells = 1 << 21;
+const float ColumnMinCellSize = 2.0f;
+// triangle footprints are grown by this much so float error in the triangle test
+// never hits a triangle listed only in the neighbouring cell
+const float ColumnPad = 0.05f;
+// same for layer heights. Near vertical triangles, where the hit distance is badly
+// conditioned, get an unbounded height range and are always tested.
+const float ColumnHeightPad = 0.25f;
+const float ColumnSteepNormalZ = 0.1f;
+// set on a cell's start offset when it is dense
+const RmUint32 DenseColumn = 0x80000000;
+
+struct ColumnLayer
+{
+	float zmin;
+	float zmax;
+	RmUint32 tri;	// position in the triangle array
+};
+
+struct Triangle
+{
+	glm::vec3 v0;
+	glm::vec3 e1;
+	glm::vec3 e2;
+	RmUint32 index;	// index into the source mesh, used for tie breaks and normals
+};
+
+// child >= 0 is another node, child < 0 is a leaf holding count triangles
+// starting at ~child.  Boxes are stored per axis so four children load as one register.
+struct Node
+{
+	float bmin[3][4];
+	float bmax[3][4];
+	int32_t child[4];
+	RmUint32 count[4];
+};
+
+// start of a hierarchy written out by writeRaycastBVH, followed by the vertex,
+// index, normal, triangle and node arrays and the height field cell starts and
+// triangle lists in that order
+struct BlobHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t triangle_size;	// struct sizes guard against files from a build with a different layout
+	uint32_t node_size;
+	uint32_t layer_size;
+	RmUint32 vcount;
+	RmUint32 tcount;
+	RmUint32 node_count;
+	RmReal bound_min[3];
+	RmReal bound_max[3];
+	RmUint32 column_dim[2];	// height field cells along x and y, both 0 if it was not built
+	RmReal column_origin[2];
+	RmReal column_cell_size;
+	RmUint32 column_refs;
+};
+
+const uint32_t BlobMagic = 0x34485642;	// "BVH4"
+const uint32_t BlobVersion = 2;
+
+struct BuildRef
+{
+	float bmin[3];
+	float bmax[3];
+	float centroid[3];
+	RmUint32 tri;
+};
+
+struct Ray
+{
+	glm::vec3 from;
+	glm::vec3 dir;
+	float inv_dir[3];
+	float distance;
+};
+
+// identical to rayIntersectsTriangle in raycast_mesh.cpp, with the edges precomputed
+inline bool IntersectTriangle(const Ray &ray, const Triangle &tri, float &t)
+{
+	glm::vec3 h = glm::cross(ray.dir, tri.e2);
+	float a = glm::dot(tri.e1, h);
+
+	if (a > -0.00001 && a < 0.00001)
+		return false;
+
+	float f = 1 / a;
+	glm::vec3 s = ray.from - tri.v0;
+	float u = f * glm::dot(s, h);
+
+	if (u < 0.0 || u > 1.0)
+		return false;
+
+	glm::vec3 q = glm::cross(s, tri.e1);
+	float v = f * glm::dot(ray.dir, q);
+	if (v < 0.0 || u + v > 1.0)
+		return false;
+
+	t = f * glm::dot(tri.e2, q);
+	return t > 0;
+}
+
+// same plane normal the binary tree reports, see computePlane in raycast_mesh.cpp
+void ComputeFaceNormal(const RmReal *A, const RmReal *B, const RmReal *C, RmReal *n)
+{
+	RmReal vx = (B[0] - C[0]);
+	RmReal vy = (B[1] - C[1]);
+	RmReal vz = (B[2] - C[2]);
+
+	RmReal wx = (A[0] - B[0]);
+	RmReal wy = (A[1] - B[1]);
+	RmReal wz = (A[2] - B[2]);
+
+	RmReal vw_x = vy * wz - vz * wy;
+	RmReal vw_y = vz * wx - vx * wz;
+	RmReal vw_z = vx * wy - vy * wx;
+
+	RmReal mag = glm::sqrt((vw_x * vw_x) + (vw_y * vw_y) + (vw_z * vw_z));
+	mag = mag < 0.000001f ? 0.0f : 1.0f / mag;
+
+	n[0] = vw_x * mag;
+	n[1] = vw_y * mag;
+	n[2] = vw_z * mag;
+}
+
+class BVHRaycastMesh : public RaycastMesh
+{
+public:
+	BVHRaycastMesh(RmUint32 vcount, const RmReal *vertices, RmUint32 tcount, const RmUint32 *indices, bool height_field)
+		: m_vertex_data(vertices, vertices + vcount * 3), m_index_data(indices, indices + tcount * 3)
+	{
+		m_vertices = m_vertex_data.data();
+		m_vcount = vcount;
+		m_indices = m_index_data.data();
+		m_tcount = tcount;
+
+		m_bound_min[0] = m_bound_min[1] = m_bound_min[2] = FLT_MAX;
+		m_bound_max[0] = m_bound_max[1] = m_bound_max[2] = -FLT_MAX;
+		for (RmUint32 i = 0; i < vcount; ++i) {
+			for (int axis = 0; axis < 3; ++axis) {
+				m_bound_min[axis] = std::min(m_bound_min[axis], vertices[i * 3 + axis]);
+				m_bound_max[axis] = std::max(m_bound_max[axis], vertices[i * 3 + axis]);
+			}
+		}
+
+		m_normal_data.resize(tcount * 3);
+		for (RmUint32 i = 0; i < tcount; ++i) {
+			ComputeFaceNormal(Vertex(i, 2), Vertex(i, 1), Vertex(i, 0), &m_normal_data[i * 3]);
+		}
+
+		Build();
+
+		m_normals = m_normal_data.data();
+		m_triangles = m_triangle_data.data();
+		m_nodes = m_node_data.data();
+		m_node_count = static_cast<RmUint32>(m_node_data.size());
+
+		if (height_field) {
+			BuildColumns();
+		}
+	}
+
+	// uses a block laid out by Write in place, see createRaycastBVHView
+	explicit BVHRaycastMesh(const BlobHeader &header)
+	{
+		const char *data = reinterpret_cast<const char *>(&header) + sizeof(BlobHeader);
+		m_vcount = header.vcount;
+		m_tcount = header.tcount;
+		m_node_count = header.node_count;
+		m_vertices = reinterpret_cast<const RmReal *>(data);
+		data += sizeof(RmReal) * 3 * m_vcount;
+		m_indices = reinterpret_cast<const RmUint32 *>(data);
+		data += sizeof(RmUint32) * 3 * m_tcount;
+		m_normals = reinterpret_cast<const RmReal *>(data);
+		data += sizeof(RmReal) * 3 * m_tcount;
+		m_triangles = reinterpret_cast<const Triangle *>(data);
+		data += sizeof(Triangle) * m_tcount;
+		m_nodes = reinterpret_cast<const Node *>(data);
+		data += sizeof(Node) * m_node_count;
+		std::copy(header.bound_min, header.bound_min + 3, m_bound_min);
+		std::copy(header.bound_max, header.bound_max + 3, m_bound_max);
+
+		if (header.column_dim[0] > 0 && header.column_dim[1] > 0) {
+			m_column_dim[0] = header.column_dim[0];
+			m_column_dim[1] = header.column_dim[1];
+			m_column_origin[0] = header.column_origin[0];
+			m_column_origin[1] = header.column_origin[1];
+			m_column_cell_size = header.column_cell_size;
+			m_column_inv_cell_size = 1.0f / m_column_cell_size;
+			m_column_refs = header.column_refs;
+			m_column_start = reinterpret_cast<const RmUint32 *>(data);
+			data += sizeof(RmUint32) * (ColumnCells() + 1);
+			m_column_layers = reinterpret_cast<const ColumnLayer *>(data);
+		}
+	}
+
+	static size_t BlobSize(RmUint32 vcount, RmUint32 tcount, RmUint32 node_count, uint64_t column_cells, RmUint32 column_refs)
+	{
+		return sizeof(BlobHeader) +
+			sizeof(RmReal) * 3 * vcount +
+			sizeof(RmUint32) * 3 * tcount +
+			sizeof(RmReal) * 3 * tcount +
+			sizeof(Triangle) * tcount +
+			sizeof(Node) * node_count +
+			(column_cells > 0 ? sizeof(RmUint32) * (column_cells + 1) : 0) +
+			sizeof(ColumnLayer) * column_refs;
+	}
+
+	size_t BlobSize() const
+	{
+		return BlobSize(m_vcount, m_tcount, m_node_count, ColumnCells(), m_column_refs);
+	}
+
+	bool GetHeightField(RaycastHeightFieldInfo &info) const
+	{
+		info = RaycastHeightFieldInfo();
+		if (!m_column_start)
+			return false;
+
+		info.cells_x = m_column_dim[0];
+		info.cells_y = m_column_dim[1];
+		info.cell_size = m_column_cell_size;
+		info.references = m_column_refs;
+		for (uint64_t i = 0; i < ColumnCells(); ++i) {
+			if (m_column_start[i] & DenseColumn)
+				info.dense_cells++;
+		}
+		return true;
+	}
+
+	void Write(void *dest) const
+	{
+		BlobHeader header;
+		header.magic = BlobMagic;
+		header.version = BlobVersion;
+		header.triangle_size = sizeof(Triangle);
+		header.node_size = sizeof(Node);
+		header.layer_size = sizeof(ColumnLayer);
+		header.vcount = m_vcount;
+		header.tcount = m_tcount;
+		header.node_count = m_node_count;
+		std::copy(m_bound_min, m_bound_min + 3, header.bound_min);
+		std::copy(m_bound_max, m_bound_max + 3, header.bound_max);
+		header.column_dim[0] = m_column_dim[0];
+		header.column_dim[1] = m_column_dim[1];
+		header.column_origin[0] = m_column_origin[0];
+		header.column_origin[1] = m_column_origin[1];
+		header.column_cell_size = m_column_cell_size;
+		header.column_refs = m_column_refs;
+
+		char *out = reinterpret_cast<char *>(dest);
+		out = Append(out, &header, sizeof(header));
+		out = Append(out, m_vertices, sizeof(RmReal) * 3 * m_vcount);
+		out = Append(out, m_indices, sizeof(RmUint32) * 3 * m_tcount);
+		out = Append(out, m_normals, sizeof(RmReal) * 3 * m_tcount);
+		out = Append(out, m_triangles, sizeof(Triangle) * m_tcount);
+		out = Append(out, m_nodes, sizeof(Node) * m_node_count);
+		if (m_column_start) {
+			out = Append(out, m_column_start, sizeof(RmUint32) * (ColumnCells() + 1));
+			Append(out, m_column_layers, sizeof(ColumnLayer) * m_column_refs);
+		}
+	}
+
+	// checks every index in the block, and the tree depth Trace's stack is sized
+	// for, so a damaged or stale file can never send a query outside of it
+	bool Validate() const
+	{
+		for (RmUint32 i = 0; i < m_tcount * 3; ++i) {
+			if (m_indices[i] >= m_vcount)
+				return false;
+		}
+		for (RmUint32 i = 0; i < m_tcount; ++i) {
+			if (m_triangles[i].index >= m_tcount)
+				return false;
+		}
+		if (m_tcount > 0 && m_node_count == 0)
+			return false;
+		// deepest path from the root to each node, BuildNode stops splitting before MaxDepth
+		std::vector<uint8_t> depth(m_node_count, 0);
+		for (RmUint32 n = 0; n < m_node_count; ++n) {
+			for (int i = 0; i < 4; ++i) {
+				int32_t child = m_nodes[n].child[i];
+				if (child >= 0) {
+					// children are always built after their parent, which also rules out cycles
+					if (static_cast<RmUint32>(child) <= n || static_cast<RmUint32>(child) >= m_node_count)
+						return false;
+					if (depth[n] + 1 >= MaxDepth)
+						return false;
+					depth[child] = std::max<uint8_t>(depth[child], depth[n] + 1);
+				}
+				else if (static_cast<uint64_t>(static_cast<RmUint32>(~child)) + m_nodes[n].count[i] > m_tcount) {
+					return false;
+				}
+			}
+		}
+		if (m_column_start) {
+			if (!(m_column_cell_size >= ColumnMinCellSize) || !std::isfinite(m_column_origin[0]) || !std::isfinite(m_column_origin[1]))
+				return false;
+			RmUint32 prev = 0;
+			for (uint64_t i = 0; i <= ColumnCells(); ++i) {
+				RmUint32 start = m_column_start[i] & ~DenseColumn;
+				if (start < prev || (i == 0 && start != 0))
+					return false;
+				prev = start;
+			}
+			if (m_column_start[ColumnCells()] != m_column_refs)
+				return false;
+			for (RmUint32 i = 0; i < m_column_refs; ++i) {
+				if (m_column_layers[i].tri >= m_tcount)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	virtual bool raycast(const RmReal *from, const RmReal *to, RmReal *hitLocation, RmReal *hitNormal, RmReal *hitDistance)
+	{
+		Ray ray;
+		if (!MakeRay(from, to, ray))
+			return false;
+
+		bool any = hitLocation == nullptr && hitNormal == nullptr && hitDistance == nullptr;
+		RmUint32 tri = NoTriangle;
+		float t = ray.distance;
+		int column = from[0] == to[0] && from[1] == to[1] ? TraceColumn(ray, any, tri, t) : -1;
+		if (column == 0 || (column < 0 && !Trace(ray, any, tri, t)))
+			return false;
+
+		Report(ray, tri, t, hitLocation, hitNormal, hitDistance);
+		return true;
+	}
+
+	virtual void raycastBatch(RmUint32 count, const RmReal *from, const RmReal *to, bool *hits)
+	{
+		for (RmUint32 i = 0; i < count; ++i) {
+			Ray ray;
+			RmUint32 tri = NoTriangle;
+			float t = 0.0f;
+			if (!MakeRay(&from[i * 3], &to[i * 3], ray)) {
+				hits[i] = false;
+				continue;
+			}
+
+			int column = from[i * 3] == to[i * 3] && from[i * 3 + 1] == to[i * 3 + 1] ? TraceColumn(ray, true, tri, t) : -1;
+			hits[i] = column < 0 ? Trace(ray, true, tri, t) : column == 1;
+		}
+	}
+
+	virtual bool bruteForceRaycast(const RmReal *from, const RmReal *to, RmReal *hitLocation, RmReal *hitNormal, RmReal *hitDistance)
+	{
+		Ray ray;
+		if (!MakeRay(from, to, ray))
+			return false;
+
+		RmUint32 nearest_tri = NoTriangle;
+		float nearest = ray.distance;
+		for (const Triangle *tri = m_triangles; tri != m_triangles + m_tcount; ++tri) {
+			float t;
+			if (!IntersectTriangle(ray, *tri, t))
+				continue;
+			if (t < nearest || (t == nearest && tri->index < nearest_tri)) {
+				nearest = t;
+				nearest_tri = tri->index;
+			}
+		}
+
+		if (nearest_tri == NoTriangle)
+			return false;
+
+		Report(ray, nearest_tri, nearest, hitLocation, hitNormal, hitDistance);
+		return true;
+	}
+
+	virtual const RmReal *getBoundMin(void) const { return m_bound_min; }
+	virtual const RmReal *getBoundMax(void) const { return m_bound_max; }
+	virtual RmUint32 getVertexCount(void) const { return m_vcount; }
+	virtual const RmReal *getVertices(void) const { return m_vertices; }
+	virtual RmUint32 getTriangleCount(void) const { return m_tcount; }
+	virtual const RmUint32 *getIndices(void) const { return m_indices; }
+
+	virtual void release(void)
+	{
+		delete this;
+	}
+
+private:
+	static char *Append(char *out, const void *src, size_t size)
+	{
+		if (size > 0)
+			memcpy(out, src, size);
+		return out + size;
+	}
+
+	const RmReal *Vertex(RmUint32 tri, int corner) const
+	{
+		return &m_vertices[m_indices[tri * 3 + corner] * 3];
+	}
+
+	bool MakeRay(const RmReal *from, const RmReal *to, Ray &ray) const
+	{
+		if (m_node_count == 0)
+			return false;
+
+		glm::vec3 dir(to[0] - from[0], to[1] - from[1], to[2] - from[2]);
+		float distance = glm::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+		if (distance < 0.0000000001f)
+			return false;
+
+		float recip = 1.0f / distance;
+		ray.from = glm::vec3(from[0], from[1], from[2]);
+		ray.dir = dir * recip;
+		ray.distance = distance;
+		for (int axis = 0; axis < 3; ++axis) {
+			// a zero component would give inf * 0 = nan in the slab test
+			float d = ray.dir[axis];
+			if (std::fabs(d) < 1.0e-12f)
+				d = d < 0.0f ? -1.0e-12f : 1.0e-12f;
+			ray.inv_dir[axis] = 1.0f / d;
+		}
+		return true;
+	}
+
+	void Report(const Ray &ray, RmUint32 tri, float t, RmReal *hitLocation, RmReal *hitNormal, RmReal *hitDistance) const
+	{
+		if (hitLocation) {
+			hitLocation[0] = ray.from[0] + ray.dir[0] * t;
+			hitLocation[1] = ray.from[1] + ray.dir[1] * t;
+			hitLocation[2] = ray.from[2] + ray.dir[2] * t;
+		}
+		if (hitNormal) {
+			hitNormal[0] = m_normals[tri * 3 + 0];
+			hitNormal[1] = m_normals[tri * 3 + 1];
+			hitNormal[2] = m_normals[tri * 3 + 2];
+		}
+		if (hitDistance)
+			*hitDistance = t;
+	}
+
+	// returns a bit per child whose box the segment [0, tmax] passes through
+	inline int TestChildren(const Node &node, const Ray &ray, float tmax) const
+	{
+#ifdef RAYCAST_BVH_SSE
+		__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmin[0]), _mm_set1_ps(ray.from[0])), _mm_set1_ps(ray.inv_dir[0]));
+		__m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmax[0]), _mm_set1_ps(ray.from[0])), _mm_set1_ps(ray.inv_dir[0]));
+		__m128 tnear = _mm_max_ps(_mm_min_ps(t1, t2), _mm_setzero_ps());
+		__m128 tfar = _mm_min_ps(_mm_max_ps(t1, t2), _mm_set1_ps(tmax));
+
+		t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmin[1]), _mm_set1_ps(ray.from[1])), _mm_set1_ps(ray.inv_dir[1]));
+		t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmax[1]), _mm_set1_ps(ray.from[1])), _mm_set1_ps(ray.inv_dir[1]));
+		tnear = _mm_max_ps(tnear, _mm_min_ps(t1, t2));
+		tfar = _mm_min_ps(tfar, _mm_max_ps(t1, t2));
+
+		t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmin[2]), _mm_set1_ps(ray.from[2])), _mm_set1_ps(ray.inv_dir[2]));
+		t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.bmax[2]), _mm_set1_ps(ray.from[2])), _mm_set1_ps(ray.inv_dir[2]));
+		tnear = _mm_max_ps(tnear, _mm_min_ps(t1, t2));
+		tfar = _mm_min_ps(tfar, _mm_max_ps(t1, t2));
+
+		return _mm_movemask_ps(_mm_cmple_ps(tnear, tfar));
+#else
+		int mask = 0;
+		for (int i = 0; i < 4; ++i) {
+			float tnear = 0.0f;
+			float tfar = tmax;
+			for (int axis = 0; axis < 3; ++axis) {
+				float t1 = (node.bmin[axis][i] - ray.from[axis]) * ray.inv_dir[axis];
+				float t2 = (node.bmax[axis][i] - ray.from[axis]) * ray.inv_dir[axis];
+				tnear = std::max(tnear, std::min(t1, t2));
+				tfar = std::min(tfar, std::max(t1, t2));
+			}
+			if (tnear <= tfar)
+				mask |= 1 << i;
+		}
+		return mask;
+#endif
+	}
+
+	// nearest hit within t (which starts as the segment length), or any hit at all when any is set
+	bool Trace(const Ray &ray, bool any, RmUint32 &nearest_tri, float &nearest) const
+	{
+		int32_t stack[StackSize];
+		int sp = 0;
+		stack[sp++] = 0;
+
+		nearest = ray.distance;
+		nearest_tri = NoTriangle;
+
+		while (sp > 0) {
+			const Node &node = m_nodes[stack[--sp]];
+			int mask = TestChildren(node, ray, nearest);
+			for (int i = 0; i < 4; ++i) {
+				if (!(mask & (1 << i)))
+					continue;
+
+				int32_t child = node.child[i];
+				if (child >= 0) {
+					stack[sp++] = child;
+					continue;
+				}
+
+				const Triangle *tri = &m_triangles[~child];
+				const Triangle *end = tri + node.count[i];
+				for (; tri != end; ++tri) {
+					float t;
+					if (!IntersectTriangle(ray, *tri, t))
+						continue;
+					if (t < nearest || (t == nearest && tri->index < nearest_tri)) {
+						nearest = t;
+						nearest_tri = tri->index;
+						if (any)
+							return true;
+					}
+				}
+			}
+		}
+
+		return nearest_tri != NoTriangle;
+	}
+
+	uint64_t ColumnCells() const
+	{
+		return static_cast<uint64_t>(m_column_dim[0]) * m_column_dim[1];
+	}
+
+	// cell along one axis, -1 below the grid and the cell count past it. Build and
+	// lookup share this so a point inside a padded footprint always lands in a cell
+	// the footprint was added to.
+	inline int64_t ColumnCoord(float v, int axis) const
+	{
+		float c = (v - m_column_origin[axis]) * m_column_inv_cell_size;
+		if (!(c >= 0.0f))
+			return -1;
+		if (c >= static_cast<float>(m_column_dim[axis]))
+			return m_column_dim[axis];
+		return static_cast<int64_t>(c);
+	}
+
+	// Trace for a vertical segment through the height field. Returns -1 when the
+	// cell is dense or off the grid and the tree has to answer instead.
+	int TraceColumn(const Ray &ray, bool any, RmUint32 &nearest_tri, float &nearest) const
+	{
+		if (!m_column_start)
+			return -1;
+
+		int64_t cx = ColumnCoord(ray.from[0], 0);
+		int64_t cy = ColumnCoord(ray.from[1], 1);
+		if (cx < 0 || cy < 0 || cx >= m_column_dim[0] || cy >= m_column_dim[1])
+			return -1;
+
+		uint64_t cell = static_cast<uint64_t>(cy) * m_column_dim[0] + static_cast<uint64_t>(cx);
+		RmUint32 start = m_column_start[cell];
+		if (start & DenseColumn)
+			return -1;
+
+		nearest = ray.distance;
+		nearest_tri = NoTriangle;
+
+		float z = ray.from[2];
+		bool down = ray.dir[2] < 0.0f;
+		RmUint32 end = m_column_start[cell + 1] & ~DenseColumn;
+		for (RmUint32 i = start; i < end; ++i) {
+			const ColumnLayer &layer = m_column_layers[i];
+			if (down) {
+				// layers are ordered by top, once one tops out below the best hit so do the rest
+				if (nearest_tri != NoTriangle && z - layer.zmax > nearest)
+					break;
+				if (layer.zmin > z)
+					continue;
+			}
+			else if (layer.zmax < z) {
+				continue;
+			}
+
+			const Triangle &tri = m_triangles[layer.tri];
+			float t;
+			if (!IntersectTriangle(ray, tri, t))
+				continue;
+			if (t < nearest || (t == nearest && tri.index < nearest_tri)) {
+				nearest = t;
+				nearest_tri = tri.index;
+				if (any)
+					return 1;
+			}
+		}
+
+		return nearest_tri != NoTriangle ? 1 : 0;
+	}
+
+	void BuildColumns()
+	{
+		RmUint32 tcount = getTriangleCount();
+		if (tcount == 0)
+			return;
+
+		float min_x = m_bound_min[0] - ColumnPad;
+		float min_y = m_bound_min[1] - ColumnPad;
+		float width = m_bound_max[0] + ColumnPad - min_x;
+		float height = m_bound_max[1] + ColumnPad - min_y;
+
+		// about one triangle per cell if they were spread evenly, made coarser until the grid fits
+		float cell_size = std::max(ColumnMinCellSize, std::sqrt(width * height / tcount));
+		uint64_t dim_x = 0;
+		uint64_t dim_y = 0;
+		for (;;) {
+			dim_x = static_cast<uint64_t>(width / cell_size) + 1;
+			dim_y = static_cast<uint64_t>(height / cell_size) + 1;
+			if (dim_x * dim_y <= ColumnMaxCells)
+				break;
+			cell_size *= 1.5f;
+		}
+
+		m_column_dim[0] = static_cast<RmUint32>(dim_x);
+		m_column_dim[1] = static_cast<RmUint32>(dim_y);
+		m_column_origin[0] = min_x;
+		m_column_origin[1] = min_y;
+		m_column_cell_size = cell_size;
+		m_column_inv_cell_size = 1.0f / cell_size;
+
+		// cell range each triangle footprint covers, clamped to the grid
+		std::vector<RmUint32> ranges(tcount * 4);
+		std::vector<RmUint32> counts(dim_x * dim_y, 0);
+		for (RmUint32 i = 0; i < tcount; ++i) {
+			const Triangle &tri = m_triangle_data[i];
+			RmUint32 *range = &ranges[i * 4];
+			for (int axis = 0; axis < 2; ++axis) {
+				float a = tri.v0[axis];
+				float b = a + tri.e1[axis];
+				float c = a + tri.e2[axis];
+				int64_t lo = ColumnCoord(std::min(a, std::min(b, c)) - ColumnPad, axis);
+				int64_t hi = ColumnCoord(std::max(a, std::max(b, c)) + ColumnPad, axis);
+				range[axis * 2] = static_cast<RmUint32>(std::max<int64_t>(lo, 0));
+				range[axis * 2 + 1] = static_cast<RmUint32>(std::min<int64_t>(hi, m_column_dim[axis] - 1));
+			}
+			for (RmUint32 y = range[2]; y <= range[3]; ++y) {
+				for (RmUint32 x = range[0]; x <= range[1]; ++x) {
+					counts[y * dim_x + x]++;
+				}
+			}
+		}
+
+		// dense cells keep no list, the rest are packed back to back
+		uint64_t cells = dim_x * dim_y;
+		m_column_start_data.resize(cells + 1);
+		RmUint32 total = 0;
+		for (uint64_t c = 0; c < cells; ++c) {
+			bool dense = counts[c] > ColumnMaxTriangles;
+			m_column_start_data[c] = total | (dense ? DenseColumn : 0);
+			RmUint32 count = counts[c];
+			counts[c] = total;
+			if (!dense)
+				total += count;
+		}
+		m_column_start_data[cells] = total;
+
+		m_column_layer_data.resize(total);
+		for (RmUint32 i = 0; i < tcount; ++i) {
+			const Triangle &tri = m_triangle_data[i];
+			ColumnLayer layer;
+			layer.tri = i;
+
+			glm::vec3 n = glm::cross(tri.e1, tri.e2);
+			float len = glm::length(n);
+			if (!(std::fabs(n.z) >= ColumnSteepNormalZ * len) || len == 0.0f) {
+				layer.zmin = -FLT_MAX;
+				layer.zmax = FLT_MAX;
+			}
+			else {
+				float a = tri.v0.z;
+				float b = a + tri.e1.z;
+				float c = a + tri.e2.z;
+				layer.zmin = std::min(a, std::min(b, c));
+				layer.zmax = std::max(a, std::max(b, c));
+				layer.zmin -= ColumnHeightPad + std::fabs(layer.zmin) * 0.0001f;
+				layer.zmax += ColumnHeightPad + std::fabs(layer.zmax) * 0.0001f;
+			}
+
+			const RmUint32 *range = &ranges[i * 4];
+			for (RmUint32 y = range[2]; y <= range[3]; ++y) {
+				for (RmUint32 x = range[0]; x <= range[1]; ++x) {
+					uint64_t c = static_cast<uint64_t>(y) * dim_x + x;
+					if (!(m_column_start_data[c] & DenseColumn))
+						m_column_layer_data[counts[c]++] = layer;
+				}
+			}
+		}
+
+		for (uint64_t c = 0; c < cells; ++c) {
+			if (m_column_start_data[c] & DenseColumn)
+				continue;
+			auto first = m_column_layer_data.begin() + m_column_start_data[c];
+			auto last = m_column_layer_data.begin() + (m_column_start_data[c + 1] & ~DenseColumn);
+			std::sort(first, last, [](const ColumnLayer &a, const ColumnLayer &b) {
+				return a.zmax > b.zmax || (a.zmax == b.zmax && a.tri < b.tri);
+			});
+		}
+
+		m_column_start = m_column_start_data.data();
+		m_column_layers = m_column_layer_data.data();
+		m_column_refs = total;
+	}
+
+	void Build()
+	{
+		RmUint32 tcount = getTriangleCount();
+		if (tcount == 0)
+			return;
+
+		std::vector<BuildRef> refs(tcount);
+		for (RmUint32 i = 0; i < tcount; ++i) {
+			BuildRef &ref = refs[i];
+			ref.tri = i;
+			for (int axis = 0; axis < 3; ++axis) {
+				float a = Vertex(i, 0)[axis];
+				float b = Vertex(i, 1)[axis];
+				float c = Vertex(i, 2)[axis];
+				ref.bmin[axis] = std::min(a, std::min(b, c));
+				ref.bmax[axis] = std::max(a, std::max(b, c));
+				ref.centroid[axis] = (ref.bmin[axis] + ref.bmax[axis]) * 0.5f;
+			}
+		}
+
+		m_node_data.reserve(tcount / 3 + 1);
+		BuildNode(refs, 0, tcount, 0);
+
+		// leaves reference runs of refs, which are now in leaf order
+		m_triangle_data.resize(tcount);
+		for (RmUint32 i = 0; i < tcount; ++i) {
+			RmUint32 tri = refs[i].tri;
+			const RmReal *v0 = Vertex(tri, 0);
+			const RmReal *v1 = Vertex(tri, 1);
+			const RmReal *v2 = Vertex(tri, 2);
+			Triangle &dest = m_triangle_data[i];
+			dest.v0 = glm::vec3(v0[0], v0[1], v0[2]);
+			dest.e1 = glm::vec3(v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2]);
+			dest.e2 = glm::vec3(v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2]);
+			dest.index = tri;
+		}
+	}
+
+	// splits [begin, end) into up to four groups, halving the largest group at
+	// its centroid median each time, and recurses into groups too big for a leaf
+	int32_t BuildNode(std::vector<BuildRef> &refs, RmUint32 begin, RmUint32 end, int depth)
+	{
+		int32_t index = static_cast<int32_t>(m_node_data.size());
+		m_node_data.emplace_back();
+
+		RmUint32 ranges[4][2] = { { begin, end } };
+		int range_count = 1;
+		while (range_count < 4) {
+			int largest = -1;
+			for (int i = 0; i < range_count; ++i) {
+				RmUint32 size = ranges[i][1] - ranges[i][0];
+				if (size > LeafSize && (largest < 0 || size > ranges[largest][1] - ranges[largest][0]))
+					largest = i;
+			}
+			if (largest < 0)
+				break;
+
+			RmUint32 first = ranges[largest][0];
+			RmUint32 last = ranges[largest][1];
+			int axis = SplitAxis(refs, first, last);
+			RmUint32 mid = first + (last - first) / 2;
+			std::nth_element(refs.begin() + first, refs.begin() + mid, refs.begin() + last,
+				[axis](const BuildRef &a, const BuildRef &b) { return a.centroid[axis] < b.centroid[axis]; });
+
+			ranges[largest][1] = mid;
+			ranges[range_count][0] = mid;
+			ranges[range_count][1] = last;
+			++range_count;
+		}
+
+		for (int i = 0; i < 4; ++i) {
+			float bmin[3] = { EmptyBox, EmptyBox, EmptyBox };
+			float bmax[3] = { EmptyBox, EmptyBox, EmptyBox };
+			int32_t child = ~0;
+			RmUint32 count = 0;
+
+			if (i < range_count) {
+				RmUint32 first = ranges[i][0];
+				RmUint32 last = ranges[i][1];
+				for (int axis = 0; axis < 3; ++axis) {
+					bmin[axis] = FLT_MAX;
+					bmax[axis] = -FLT_MAX;
+				}
+				for (RmUint32 r = first; r < last; ++r) {
+					for (int axis = 0; axis < 3; ++axis) {
+						bmin[axis] = std::min(bmin[axis], refs[r].bmin[axis]);
+						bmax[axis] = std::max(bmax[axis], refs[r].bmax[axis]);
+					}
+				}
+				for (int axis = 0; axis < 3; ++axis) {
+					bmin[axis] -= BoxPad;
+					bmax[axis] += BoxPad;
+				}
+
+				if (last - first <= LeafSize || depth + 1 >= MaxDepth) {
+					child = ~static_cast<int32_t>(first);
+					count = last - first;
+				}
+				else {
+					child = BuildNode(refs, first, last, depth + 1);
+				}
+			}
+
+			// m_node_data may have grown while building the child
+			Node &node = m_node_data[index];
+			for (int axis = 0; axis < 3; ++axis) {
+				node.bmin[axis][i] = bmin[axis];
+				node.bmax[axis][i] = bmax[axis];
+			}
+			node.child[i] = child;
+			node.count[i] = count;
+		}
+
+		return index;
+	}
+
+	static int SplitAxis(const std::vector<BuildRef> &refs, RmUint32 first, RmUint32 last)
+	{
+		float cmin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float cmax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (RmUint32 r = first; r < last; ++r) {
+			for (int axis = 0; axis < 3; ++axis) {
+				cmin[axis] = std::min(cmin[axis], refs[r].centroid[axis]);
+				cmax[axis] = std::max(cmax[axis], refs[r].centroid[axis]);
+			}
+		}
+
+		int axis = 0;
+		for (int i = 1; i < 3; ++i) {
+			if (cmax[i] - cmin[i] > cmax[axis] - cmin[axis])
+				axis = i;
+		}
+		return axis;
+	}
+
+	// what queries read, either the vectors below or a block mapped from disk
+	const RmReal *m_vertices;
+	const RmUint32 *m_indices;
+	const RmReal *m_normals;
+	const Triangle *m_triangles;
+	const Node *m_nodes;
+	RmUint32 m_vcount;
+	RmUint32 m_tcount;
+	RmUint32 m_node_count;
+	RmReal m_bound_min[3];
+	RmReal m_bound_max[3];
+	const RmUint32 *m_column_start = nullptr;
+	const ColumnLayer *m_column_layers = nullptr;
+	RmUint32 m_column_dim[2] = { 0, 0 };
+	RmReal m_column_origin[2] = { 0.0f, 0.0f };
+	RmReal m_column_cell_size = 0.0f;
+	RmReal m_column_inv_cell_size = 0.0f;
+	RmUint32 m_column_refs = 0;
+
+	// storage for a hierarchy built in this process, empty for a view
+	std::vector<RmReal> m_vertex_data;
+	std::vector<RmUint32> m_index_data;
+	std::vector<RmReal> m_normal_data;
+	std::vector<Triangle> m_triangle_data;
+	std::vector<Node> m_node_data;
+	std::vector<RmUint32> m_column_start_data;
+	std::vector<ColumnLayer> m_column_layer_data;
+};
+
+}
+
+RaycastMesh *createRaycastBVH(RmUint32 vcount, const RmReal *vertices, RmUint32 tcount, const RmUint32 *indices, bool height_field)
+{
+	return new BVHRaycastMesh(vcount, vertices, tcount, indices, height_field);
+}
+
+RmUint32 getRaycastBVHSize(const RaycastMesh *mesh)
+{
+	auto bvh = dynamic_cast<const BVHRaycastMesh *>(mesh);
+	if (!bvh || bvh->BlobSize() > 0xFFFFFFFFu)
+		return 0;
+
+	return static_cast<RmUint32>(bvh->BlobSize());
+}
+
+bool writeRaycastBVH(const RaycastMesh *mesh, void *dest, RmUint32 size)
+{
+	auto bvh = dynamic_cast<const BVHRaycastMesh *>(mesh);
+	if (!bvh || !dest || size != bvh->BlobSize())
+		return false;
+
+	bvh->Write(dest);
+	return true;
+}
+
+RaycastMesh *createRaycastBVHView(const void *data, RmUint32 size)
+{
+	if (!data || size < sizeof(BlobHeader))
+		return nullptr;
+
+	auto header = reinterpret_cast<const BlobHeader *>(data);
+	if (header->magic != BlobMagic || header->version != BlobVersion ||
+		header->triangle_size != sizeof(Triangle) || header->node_size != sizeof(Node) || header->layer_size != sizeof(ColumnLayer))
+		return nullptr;
+
+	uint64_t column_cells = static_cast<uint64_t>(header->column_dim[0]) * header->column_dim[1];
+	if (column_cells > ColumnMaxCells || (column_cells == 0 && header->column_refs != 0))
+		return nullptr;
+
+	if (BVHRaycastMesh::BlobSize(header->vcount, header->tcount, header->node_count, column_cells, header->column_refs) != size)
+		return nullptr;
+
+	auto mesh = new BVHRaycastMesh(*header);
+	if (!mesh->Validate()) {
+		mesh->release();
+		return nullptr;
+	}
+
+	return mesh;
+}
+
+bool getRaycastBVHHeightField(const RaycastMesh *mesh, RaycastHeightFieldInfo &info)
+{
+	auto bvh = dynamic_cast<const BVHRaycastMesh *>(mesh);
+	if (!bvh) {
+		info = RaycastHeightFieldInfo();
+		return false;
+	}
+
+	return bvh->GetHeightField(info);
+}
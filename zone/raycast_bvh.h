@@ -0,0 +1,67 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef RAYCAST_BVH_H
+#define RAYCAST_BVH_H
+
+#include "raycast_mesh.h"
+
+// Four wide bounding volume hierarchy over the zone triangle mesh.
+//
+// Drop in replacement for the binary tree from createRaycastMesh: same
+// triangle test and the same nearest hit tie break, so results match
+// bruteForceRaycast exactly.  Each node keeps its four child boxes side by
+// side so they are slab tested together with SSE, every triangle lives in
+// exactly one leaf and traversal keeps no per mesh scratch state, which makes
+// concurrent queries on one mesh safe.
+//
+// With height_field set it also rasters, per x/y cell, the triangles a vertical
+// segment through that cell can hit.  Vertical raycasts (FindBestZ and the other
+// floor and ceiling searches) then test that short list directly and only walk
+// the tree in cells too crowded to list, with the same results either way.
+RaycastMesh *createRaycastBVH(RmUint32 vcount,		// The number of vertices in the source triangle mesh
+							const RmReal *vertices,	// x1,y1,z1,x2,y2,z2... vertex positions
+							RmUint32 tcount,		// The number of triangles in the source triangle mesh
+							const RmUint32 *indices,	// i1,i2,i3,i4,i5,i6... triangle indices
+							bool height_field = false
+							);
+
+struct RaycastHeightFieldInfo
+{
+	RmUint32 cells_x = 0;
+	RmUint32 cells_y = 0;
+	RmReal cell_size = 0.0f;
+	RmUint32 dense_cells = 0;	// cells that fall back to the tree
+	RmUint32 references = 0;	// triangle entries over all listed cells
+};
+
+// Fills info and returns true if mesh came from createRaycastBVH with a height field.
+bool getRaycastBVHHeightField(const RaycastMesh *mesh, RaycastHeightFieldInfo &info);
+
+// A finished hierarchy can be written to a flat block and later used in place,
+// so zone processes can share one copy through a memory mapped file.
+
+// Bytes writeRaycastBVH needs for mesh, 0 if mesh did not come from createRaycastBVH.
+RmUint32 getRaycastBVHSize(const RaycastMesh *mesh);
+// Writes mesh into dest, size must be getRaycastBVHSize(mesh).
+bool writeRaycastBVH(const RaycastMesh *mesh, void *dest, RmUint32 size);
+// Wraps a block written by writeRaycastBVH without copying it, the block must stay
+// mapped until the mesh is released. Returns nullptr if the block is damaged or was
+// written by an incompatible build.
+RaycastMesh *createRaycastBVHView(const void *data, RmUint32 size);
+
+#endif
@@ -811,6 +811,23 @@ public:
 		delete this;
 	}
 
+	virtual RmUint32 getVertexCount(void) const
+	{
+		return mVcount;
+	}
+	virtual const RmReal * getVertices(void) const
+	{
+		return mVertices;
+	}
+	virtual RmUint32 getTriangleCount(void) const
+	{
+		return mTcount;
+	}
+	virtual const RmUint32 * getIndices(void) const
+	{
+		return mIndices;
+	}
+
 	virtual const RmReal * getBoundMin(void) const // return the minimum bounding box
 	{
 		return mRoot->mBounds.mMin;
@@ -930,6 +947,13 @@ public:
 
 using namespace RAYCAST_MESH;
 
+void RaycastMesh::raycastBatch(RmUint32 count,const RmReal *from,const RmReal *to,bool *hits)
+{
+	for (RmUint32 i=0; i<count; i++)
+	{
+		hits[i] = raycast(&from[i*3],&to[i*3],nullptr,nullptr,nullptr);
+	}
+}
 
 RaycastMesh * createRaycastMesh(RmUint32 vcount,		// The number of vertices in the source triangle mesh
 								const RmReal *vertices,		// The array of vertex positions in the format x1,y1,z1..x2,y2,z2.. etc.
@@ -41,6 +41,16 @@ public:
 
 	virtual const RmReal * getBoundMin(void) const = 0; // return the minimum bounding box
 	virtual const RmReal * getBoundMax(void) const = 0; // return the maximum bounding box.
+
+	// Tests count segments at once, from and to each hold count x,y,z triples.
+	// hits[i] is set when anything blocks segment i, no hit details are computed.
+	virtual void raycastBatch(RmUint32 count,const RmReal *from,const RmReal *to,bool *hits);
+
+	// The source triangle mesh this was built from.
+	virtual RmUint32 getVertexCount(void) const = 0;
+	virtual const RmReal * getVertices(void) const = 0;
+	virtual RmUint32 getTriangleCount(void) const = 0;
+	virtual const RmUint32 * getIndices(void) const = 0;
 	virtual void release(void) = 0;
 protected:
 	virtual ~RaycastMesh(void) { };
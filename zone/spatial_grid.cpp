@@ -0,0 +1,144 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "spatial_grid.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SPATIAL_GRID_SSE
+#endif
+
+SpatialGrid::SpatialGrid(float cell_size)
+	: m_cell_size(cell_size > 1.0f ? cell_size : 1.0f)
+{
+	m_inv_cell_size = 1.0f / m_cell_size;
+}
+
+void SpatialGrid::Insert(uint16 id, Entity *ent, float x, float y, uint8 flags)
+{
+	Remove(id);
+
+	Append(m_slot_of[id], CellKey(CellCoord(x), CellCoord(y)), id, ent, x, y, flags);
+}
+
+void SpatialGrid::Update(uint16 id, float x, float y, uint8 flags)
+{
+	auto it = m_slot_of.find(id);
+	if (it == m_slot_of.end())
+		return;
+
+	Slot &slot = it->second;
+	int64 key = CellKey(CellCoord(x), CellCoord(y));
+	if (key == slot.key) {
+		slot.cell->x[slot.index] = x;
+		slot.cell->y[slot.index] = y;
+		slot.cell->flags[slot.index] = flags;
+		return;
+	}
+
+	Entity *ent = slot.cell->ent[slot.index];
+	Detach(slot);
+	Append(slot, key, id, ent, x, y, flags);
+}
+
+void SpatialGrid::Remove(uint16 id)
+{
+	auto it = m_slot_of.find(id);
+	if (it == m_slot_of.end())
+		return;
+
+	Detach(it->second);
+	m_slot_of.erase(it);
+}
+
+void SpatialGrid::Clear()
+{
+	m_cells.clear();
+	m_slot_of.clear();
+}
+
+void SpatialGrid::Append(Slot &slot, int64 key, uint16 id, Entity *ent, float x, float y, uint8 flags)
+{
+	Cell &cell = m_cells[key];
+	slot.key = key;
+	slot.cell = &cell;
+	slot.index = static_cast<uint32>(cell.ent.size());
+
+	cell.x.push_back(x);
+	cell.y.push_back(y);
+	cell.flags.push_back(flags);
+	cell.id.push_back(id);
+	cell.ent.push_back(ent);
+}
+
+void SpatialGrid::Detach(const Slot &slot)
+{
+	Cell &cell = *slot.cell;
+	uint32 last = static_cast<uint32>(cell.ent.size() - 1);
+
+	// swap the last entry into the hole and point its slot at the new index
+	if (slot.index != last) {
+		cell.x[slot.index] = cell.x[last];
+		cell.y[slot.index] = cell.y[last];
+		cell.flags[slot.index] = cell.flags[last];
+		cell.id[slot.index] = cell.id[last];
+		cell.ent[slot.index] = cell.ent[last];
+		m_slot_of[cell.id[slot.index]].index = slot.index;
+	}
+
+	cell.x.pop_back();
+	cell.y.pop_back();
+	cell.flags.pop_back();
+	cell.id.pop_back();
+	cell.ent.pop_back();
+}
+
+size_t SpatialGrid::WithinRadius(const float *xs, const float *ys, size_t n, float x, float y, float r2, uint32 *out)
+{
+	size_t found = 0;
+	size_t i = 0;
+
+#ifdef SPATIAL_GRID_SSE
+	__m128 px = _mm_set1_ps(x);
+	__m128 py = _mm_set1_ps(y);
+	__m128 pr2 = _mm_set1_ps(r2);
+
+	for (; i + 4 <= n; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+		__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		int mask = _mm_movemask_ps(_mm_cmple_ps(d2, pr2));
+		if (!mask)
+			continue;
+
+		for (uint32 lane = 0; lane < 4; ++lane) {
+			if (mask & (1 << lane))
+				out[found++] = static_cast<uint32>(i + lane);
+		}
+	}
+#endif
+
+	for (; i < n; ++i) {
+		float dx = xs[i] - x;
+		float dy = ys[i] - y;
+		if (dx * dx + dy * dy <= r2)
+			out[found++] = static_cast<uint32>(i);
+	}
+
+	return found;
+}
@@ -0,0 +1,183 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/types.h"
+
+class Entity;
+
+// Uniform grid over the XY plane, used by EntityList to narrow range queries
+// down to the entities in nearby cells.  Cells only pick candidates; callers
+// still do their own exact distance test against the live position.
+//
+// Each cell also mirrors the position and a few flags of its entities in
+// parallel arrays, so radius queries can reject most of a cell with a batched
+// distance test instead of touching every entity they consider.
+class SpatialGrid
+{
+public:
+	enum : uint8 {
+		FlagClient = 0x01,
+		FlagNPC    = 0x02,
+		FlagPet    = 0x04
+	};
+
+	explicit SpatialGrid(float cell_size = 100.0f);
+
+	void Insert(uint16 id, Entity *ent, float x, float y, uint8 flags);
+	// Refreshes the mirrored XY position and flags of an existing entry,
+	// moving it to the cell containing x/y if needed. Unknown ids are ignored.
+	void Update(uint16 id, float x, float y, uint8 flags);
+	void Remove(uint16 id);
+	void Clear();
+
+	inline size_t Size() const { return m_slot_of.size(); }
+	inline float GetCellSize() const { return m_cell_size; }
+
+	// fn(Entity*) is called for every entry in a cell overlapping the box.
+	// fn must not add, move or remove grid entries.
+	template<typename Fn>
+	void ForEachInBox(float min_x, float min_y, float max_x, float max_y, Fn fn) const
+	{
+		ForEachCell(min_x, min_y, max_x, max_y, [&fn](const Cell &cell) {
+			for (auto ent : cell.ent)
+				fn(ent);
+		});
+	}
+
+	template<typename Fn>
+	inline void ForEachInRadius(float x, float y, float radius, Fn fn) const
+	{
+		ForEachInBox(x - radius, y - radius, x + radius, y + radius, fn);
+	}
+
+	// fn(Entity*) is called for entries whose mirrored XY position is within
+	// radius of x/y, widened by how far one can move between refreshes, and
+	// that have none of skip_flags set. Flags can be a tick old as well, so
+	// skip_flags is only for skipping work that is safe to miss.
+	// Safe to call from several threads at once while the grid isn't changing.
+	template<typename Fn>
+	void ForEachWithin(float x, float y, float radius, uint8 skip_flags, Fn fn) const
+	{
+		float reach = radius > 0.0f ? radius : 0.0f;
+		float r2 = (reach + QueryPad) * (reach + QueryPad);
+		uint32 hits[KernelBatch];
+
+		ForEachCell(x - reach, y - reach, x + reach, y + reach, [&](const Cell &cell) {
+			size_t n = cell.ent.size();
+			for (size_t base = 0; base < n; base += KernelBatch) {
+				size_t count = n - base < KernelBatch ? n - base : KernelBatch;
+				size_t found = WithinRadius(&cell.x[base], &cell.y[base], count, x, y, r2, hits);
+				for (size_t i = 0; i < found; ++i) {
+					size_t index = base + hits[i];
+					if (cell.flags[index] & skip_flags)
+						continue;
+					fn(cell.ent[index]);
+				}
+			}
+		});
+	}
+
+private:
+	// entities are re-binned at least once per tick, this covers the distance
+	// one can cover between re-bins so a cell boundary never hides them
+	static constexpr float QueryPad = 10.0f;
+	static constexpr float MaxCoord = 1000000.0f;
+	static constexpr size_t KernelBatch = 64;
+
+	// entries are stored column wise, index i of every array is one entity
+	struct Cell {
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<uint8> flags;
+		std::vector<uint16> id;
+		std::vector<Entity *> ent;
+	};
+
+	struct Slot {
+		int64 key;
+		Cell *cell;
+		uint32 index;
+	};
+
+	// writes the indices of the first n points within sqrt(r2) of x/y to out
+	// and returns how many there were
+	static size_t WithinRadius(const float *xs, const float *ys, size_t n, float x, float y, float r2, uint32 *out);
+
+	template<typename CellFn>
+	void ForEachCell(float min_x, float min_y, float max_x, float max_y, CellFn fn) const
+	{
+		int32 cx0 = CellCoord(min_x - QueryPad);
+		int32 cy0 = CellCoord(min_y - QueryPad);
+		int32 cx1 = CellCoord(max_x + QueryPad);
+		int32 cy1 = CellCoord(max_y + QueryPad);
+
+		// huge boxes touch more cells than we have populated, walk what exists instead
+		uint64 span = static_cast<uint64>(cx1 - cx0 + 1) * static_cast<uint64>(cy1 - cy0 + 1);
+		if (span > m_cells.size()) {
+			for (auto &cell : m_cells) {
+				int32 cx = KeyX(cell.first);
+				int32 cy = KeyY(cell.first);
+				if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1)
+					continue;
+				if (!cell.second.ent.empty())
+					fn(cell.second);
+			}
+			return;
+		}
+
+		for (int32 cx = cx0; cx <= cx1; ++cx) {
+			for (int32 cy = cy0; cy <= cy1; ++cy) {
+				auto it = m_cells.find(CellKey(cx, cy));
+				if (it == m_cells.end() || it->second.ent.empty())
+					continue;
+				fn(it->second);
+			}
+		}
+	}
+
+	void Append(Slot &slot, int64 key, uint16 id, Entity *ent, float x, float y, uint8 flags);
+	void Detach(const Slot &slot);
+
+	inline int32 CellCoord(float v) const
+	{
+		if (!(v > -MaxCoord))
+			v = -MaxCoord;
+		else if (v > MaxCoord)
+			v = MaxCoord;
+		float c = v * m_inv_cell_size;
+		int32 i = static_cast<int32>(c);
+		return (c < i) ? i - 1 : i;
+	}
+	static inline int64 CellKey(int32 cx, int32 cy) { return (static_cast<int64>(cx) << 32) | static_cast<uint32>(cy); }
+	static inline int32 KeyX(int64 key) { return static_cast<int32>(key >> 32); }
+	static inline int32 KeyY(int64 key) { return static_cast<int32>(key & 0xFFFFFFFF); }
+
+	float m_cell_size;
+	float m_inv_cell_size;
+	// cells are never erased, so Slot::cell stays valid until Clear()
+	std::unordered_map<int64, Cell> m_cells;
+	std::unordered_map<uint16, Slot> m_slot_of;
+};
+
+#endif
@@ -3700,6 +3700,7 @@ void Mob::BuffFadeBySlot(int slot, bool iRecalcBonuses, bool message, bool updat
 	uint16 spellid = buffs[slot].spellid;
 
 	buffs[slot].spellid = SPELL_UNKNOWN;
+	RebuildEffectIndex();
 
 	if (was_mezzed && !IsMezzed())
 	{
@@ -4760,6 +4761,9 @@ bool Mob::TryDeathSave() {
 
 bool Mob::AffectedBySpellExcludingSlot(int slot, int effect)
 {
+	if (!CouldHaveEffect(effect))
+		return false;
+
 	for (int i = 0; i <= EFFECT_COUNT; i++)
 	{
 		if (i == slot)
@@ -162,13 +162,6 @@ void Mob::SpellProcess()
 			}
 		}
 	}
-
-	// instill doubt
-	if (instillDoubtStageTimer.Check())
-	{
-		instillDoubtStageTimer.Disable();
-		InstillDoubt(nullptr, 1); // the target ID is saved in instillDoubtTargetID field
-	}
 }
 
 void NPC::SpellProcess()
@@ -3670,7 +3663,7 @@ void Mob::BuffFadeByEffect(int effectid, int skipslot)
 {
 	int i;
 
-	int buff_count = GetMaxTotalSlots();
+	int buff_count = CouldHaveEffect(effectid) ? GetMaxTotalSlots() : 0;
 	for(i = 0; i < buff_count; i++)
 	{
 		if(buffs[i].spellid == SPELL_UNKNOWN)
@@ -4788,6 +4781,9 @@ bool Client::SpellBucketCheck(uint16 spell_id, uint32 char_id) {
 }
 
 int16 Mob::GetBuffSlotFromType(uint16 type) {
+	if (!CouldHaveEffect(type))
+		return -1;
+
 	uint32 buff_count = GetMaxTotalSlots();
 	for (int i = 0; i < buff_count; i++) {
 		if (buffs[i].spellid != SPELL_UNKNOWN) {
@@ -4808,6 +4804,9 @@ uint16 Mob::GetSpellIDFromSlot(uint8 slot)
 }
 
 bool Mob::FindType(uint16 type, bool bOffensive, uint16 threshold) {
+	if (!CouldHaveEffect(type))
+		return false;
+
 	int buff_count = GetMaxTotalSlots();
 	for (int i = 0; i < buff_count; i++) {
 		if (buffs[i].spellid != SPELL_UNKNOWN) {
@@ -4837,6 +4836,31 @@ bool Mob::FindType(uint16 type, bool bOffensive, uint16 threshold) {
 	return false;
 }
 
+void Mob::IndexBuffEffects(uint16 spell_id)
+{
+	if (!IsValidSpell(spell_id))
+		return;
+
+	for (int j = 0; j < EFFECT_COUNT; j++) {
+		int effect = spells[spell_id].effectid[j];
+		if (effect >= 0 && effect < EffectIndexSize)
+			active_effects.set(effect);
+	}
+}
+
+void Mob::RebuildEffectIndex()
+{
+	active_effects.reset();
+	if (!buffs)
+		return;
+
+	int buff_count = GetMaxTotalSlots();
+	for (int i = 0; i < buff_count; i++) {
+		if (buffs[i].spellid != SPELL_UNKNOWN)
+			IndexBuffEffects(buffs[i].spellid);
+	}
+}
+
 bool Mob::IsCombatProc(uint16 spell_id) {
 
 	if (RuleB(Spells, FocusCombatProcs))
@@ -5027,6 +5051,7 @@ void Client::InitializeBuffSlots()
 		buffs[x].spellid = SPELL_UNKNOWN;
 	}
 	current_buff_count = 0;
+	active_effects.reset();
 }
 
 void Client::UninitializeBuffSlots()
@@ -5044,6 +5069,7 @@ void NPC::InitializeBuffSlots()
 		buffs[x].spellid = SPELL_UNKNOWN;
 	}
 	current_buff_count = 0;
+	active_effects.reset();
 }
 
 void NPC::UninitializeBuffSlots()
@@ -0,0 +1,128 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include <cstring>
+
+#include "tick_profiler.h"
+
+TickProfiler::TickProfiler(uint32 budget_ms)
+	: m_budget_ms(budget_ms)
+{
+	Reset();
+}
+
+void TickProfiler::StartTick()
+{
+	m_tick_start = clock::now();
+	m_lap = m_tick_start;
+	memset(m_current, 0, sizeof(m_current));
+	m_in_tick = true;
+}
+
+void TickProfiler::Lap(TickPhase phase)
+{
+	if (!m_in_tick)
+		return;
+
+	clock::time_point now = clock::now();
+	uint64 us = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lap).count();
+	m_lap = now;
+
+	int p = static_cast<int>(phase);
+	m_current[p] += us;
+	Record(m_phases[p], us);
+}
+
+void TickProfiler::EndTick()
+{
+	if (!m_in_tick)
+		return;
+
+	m_in_tick = false;
+	m_last_tick_us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - m_tick_start).count();
+	Record(m_tick, m_last_tick_us);
+
+	if (m_last_tick_us <= static_cast<uint64>(m_budget_ms) * 1000)
+		return;
+
+	m_overruns++;
+	m_tick.overrun_us += m_last_tick_us;
+
+	int worst = 0;
+	for (int p = 0; p < PhaseCount; ++p) {
+		m_phases[p].overrun_us += m_current[p];
+		if (m_current[p] > m_current[worst])
+			worst = p;
+	}
+	m_phases[worst].worst_in_overrun++;
+}
+
+void TickProfiler::Reset()
+{
+	m_in_tick = false;
+	m_overruns = 0;
+	m_last_tick_us = 0;
+	m_reset = clock::now();
+	memset(m_current, 0, sizeof(m_current));
+	memset(&m_tick, 0, sizeof(m_tick));
+	memset(m_phases, 0, sizeof(m_phases));
+}
+
+uint64 TickProfiler::GetElapsedMs() const
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - m_reset).count();
+}
+
+const char *TickProfiler::GetPhaseName(TickPhase phase)
+{
+	switch (phase) {
+	case TickPhase::Network:        return "network";
+	case TickPhase::TimerWheel:     return "timer_wheel";
+	case TickPhase::Groups:         return "groups";
+	case TickPhase::Doors:          return "doors";
+	case TickPhase::Objects:        return "objects";
+	case TickPhase::Corpses:        return "corpses";
+	case TickPhase::CorpseDepop:    return "corpse_depop";
+	case TickPhase::Traps:          return "traps";
+	case TickPhase::Raids:          return "raids";
+	case TickPhase::Entities:       return "entities";
+	case TickPhase::AIDecide:       return "ai_decide";
+	case TickPhase::Mobs:           return "mobs";
+	case TickPhase::Beacons:        return "beacons";
+	case TickPhase::Encounters:     return "encounters";
+	case TickPhase::EventScheduler: return "event_scheduler";
+	case TickPhase::Zone:           return "zone";
+	case TickPhase::QuestTimers:    return "quest_timers";
+	case TickPhase::QuestGC:        return "quest_gc";
+	case TickPhase::Interserver:    return "interserver";
+	default:                        return "unknown";
+	}
+}
+
+void TickProfiler::Record(Stats &s, uint64 us)
+{
+	s.count++;
+	s.total_us += us;
+	if (us > s.max_us)
+		s.max_us = us;
+
+	int bucket = 0;
+	for (uint64 v = us; v > 1 && bucket < Buckets - 1; v >>= 1)
+		bucket++;
+	s.histogram[bucket]++;
+}
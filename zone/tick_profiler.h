@@ -0,0 +1,112 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2003 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include <chrono>
+
+#include "../common/types.h"
+
+// Phases of the zone main loop, in the order they run.
+enum class TickPhase : uint8 {
+	Network = 0,
+	TimerWheel,
+	Groups,
+	Doors,
+	Objects,
+	Corpses,
+	CorpseDepop,
+	Traps,
+	Raids,
+	Entities,
+	AIDecide,
+	Mobs,
+	Beacons,
+	Encounters,
+	EventScheduler,
+	Zone,
+	QuestTimers,
+	QuestGC,
+	Interserver,
+	Count
+};
+
+// Always on timing of the zone main loop.  The loop calls StartTick(), then
+// Lap(phase) after each step, which charges the time since the previous lap
+// to that phase, and EndTick() at the bottom.  That is one clock read per
+// phase, cheap enough to leave running in production.
+//
+// Every phase and the whole tick keep a log2 histogram of microseconds, so
+// bucket i counts samples in [2^i, 2^(i+1)) us with anything under 1us in 0.
+// A tick overruns when its work takes longer than the loop interval. Overrun
+// ticks also record which phase took the biggest share of them.
+class TickProfiler
+{
+public:
+	static constexpr int Buckets = 22;
+
+	struct Stats {
+		uint64 count;
+		uint64 total_us;
+		uint64 max_us;
+		uint64 histogram[Buckets];
+		// overrun ticks where this phase was the slowest one
+		uint64 worst_in_overrun;
+		// time spent in this phase during overrun ticks
+		uint64 overrun_us;
+	};
+
+	explicit TickProfiler(uint32 budget_ms);
+
+	void StartTick();
+	void Lap(TickPhase phase);
+	void EndTick();
+	void Reset();
+
+	inline uint32 GetBudget() const { return m_budget_ms; }
+	inline uint64 GetOverruns() const { return m_overruns; }
+	inline uint64 GetLastTickUs() const { return m_last_tick_us; }
+	inline const Stats &GetTickStats() const { return m_tick; }
+	inline const Stats &GetPhaseStats(TickPhase phase) const { return m_phases[static_cast<int>(phase)]; }
+	// how long the profile has been collecting since the last reset
+	uint64 GetElapsedMs() const;
+
+	static const char *GetPhaseName(TickPhase phase);
+	// upper edge of a histogram bucket, in us
+	static inline uint64 GetBucketLimit(int bucket) { return 1ull << (bucket + 1); }
+
+private:
+	typedef std::chrono::steady_clock clock;
+
+	static constexpr int PhaseCount = static_cast<int>(TickPhase::Count);
+
+	static void Record(Stats &s, uint64 us);
+
+	uint32 m_budget_ms;
+	bool m_in_tick;
+	clock::time_point m_tick_start;
+	clock::time_point m_lap;
+	clock::time_point m_reset;
+	uint64 m_current[PhaseCount];
+	uint64 m_overruns;
+	uint64 m_last_tick_us;
+	Stats m_tick;
+	Stats m_phases[PhaseCount];
+};
+
+#endif
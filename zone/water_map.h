@@ -24,11 +24,30 @@ enum WaterRegionType {
 class WaterMap
 {
 public:
+	// Remembers what a moving entity was last resolved to so the next lookup can
+	// usually be answered from that region alone. Owned by the caller, one per mover.
+	struct RegionCache {
+		const WaterMap *map = nullptr;	// the map the rest was resolved against
+		glm::vec3 location;
+		int32 region = -1;				// map specific region index, -1 for none
+		WaterRegionType type = RegionTypeNormal;
+	};
+
 	WaterMap() { }
 	virtual ~WaterMap() { }
 
 	static WaterMap* LoadWaterMapfile(std::string zone_name);
 	virtual WaterRegionType ReturnRegionType(const glm::vec3& location) const = 0;
+	virtual WaterRegionType ReturnRegionType(const glm::vec3& location, RegionCache& cache) const {
+		if (cache.map == this && cache.location == location) {
+			return cache.type;
+		}
+		cache.map = this;
+		cache.location = location;
+		cache.region = -1;
+		cache.type = ReturnRegionType(location);
+		return cache.type;
+	}
 	virtual bool InWater(const glm::vec3& location) const = 0;
 	virtual bool InVWater(const glm::vec3& location) const = 0;
 	virtual bool InLava(const glm::vec3& location) const = 0;
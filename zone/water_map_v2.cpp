@@ -1,5 +1,9 @@
 #include "water_map_v2.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 WaterMapV2::WaterMapV2() {
 }
 
@@ -7,14 +11,42 @@ WaterMapV2::~WaterMapV2() {
 }
 
 WaterRegionType WaterMapV2::ReturnRegionType(const glm::vec3& location) const {
-	size_t sz = regions.size();
-	for(size_t i = 0; i < sz; ++i) {
-		auto const &region = regions[i];
-		if (region.second.ContainsPoint(glm::vec3(location.y, location.x, location.z))) {
-			return region.first;
+	int32 region = FindRegion(glm::vec3(location.y, location.x, location.z));
+	return region >= 0 ? regions[region].first : RegionTypeNormal;
+}
+
+WaterRegionType WaterMapV2::ReturnRegionType(const glm::vec3& location, RegionCache& cache) const {
+	if (cache.map == this) {
+		if (cache.location == location) {
+			return cache.type;
+		}
+
+		// still inside the last region and no earlier overlapping region took over.
+		// when more regions could take over than share our cell, scanning the cell is cheaper.
+		glm::vec3 p(location.y, location.x, location.z);
+		if (cache.region >= 0 && cache.region < static_cast<int32>(regions.size()) &&
+			bounds[cache.region].shadowed_by.size() < Candidates(p).size() &&
+			RegionContains(cache.region, p)) {
+			bool shadowed = false;
+			for (auto other : bounds[cache.region].shadowed_by) {
+				if (RegionContains(other, p)) {
+					shadowed = true;
+					break;
+				}
+			}
+
+			if (!shadowed) {
+				cache.location = location;
+				return cache.type;
+			}
 		}
 	}
-	return RegionTypeNormal;
+
+	cache.map = this;
+	cache.location = location;
+	cache.region = FindRegion(glm::vec3(location.y, location.x, location.z));
+	cache.type = cache.region >= 0 ? regions[cache.region].first : RegionTypeNormal;
+	return cache.type;
 }
 
 bool WaterMapV2::InWater(const glm::vec3& location) const {
@@ -30,7 +62,8 @@ bool WaterMapV2::InLava(const glm::vec3& location) const {
 }
 
 bool WaterMapV2::InLiquid(const glm::vec3& location) const {
-	return InWater(location) || InLava(location);
+	WaterRegionType type = ReturnRegionType(location);
+	return type == RegionTypeWater || type == RegionTypeLava;
 }
 
 bool WaterMapV2::InPVP(const glm::vec3& location) const {
@@ -114,5 +147,115 @@ bool WaterMapV2::Load(FILE *fp) {
 			OrientedBoundingBox(glm::vec3(x, y, z), glm::vec3(x_rot, y_rot, z_rot), glm::vec3(x_scale, y_scale, z_scale), glm::vec3(x_extent, y_extent, z_extent))));
 	}
 
+	BuildIndex();
 	return true;
 }
+
+void WaterMapV2::BuildIndex() {
+	bounds.clear();
+	cells.clear();
+	unbounded.clear();
+	grid_width = 0;
+	grid_height = 0;
+
+	glm::vec3 all_min(0.0f);
+	glm::vec3 all_max(0.0f);
+	bool any_bounded = false;
+
+	bounds.resize(regions.size());
+	for (uint32 i = 0; i < regions.size(); ++i) {
+		auto &b = bounds[i];
+		if (!regions[i].second.GetBounds(b.min, b.max)) {
+			b.min = glm::vec3(-FLT_MAX);
+			b.max = glm::vec3(FLT_MAX);
+			unbounded.push_back(i);
+			continue;
+		}
+
+		// the containment test runs through the inverse transform, leave room for its rounding
+		glm::vec3 pad = glm::max(glm::abs(b.min), glm::abs(b.max)) * 0.0001f + 0.01f;
+		b.min -= pad;
+		b.max += pad;
+
+		all_min = any_bounded ? glm::min(all_min, b.min) : b.min;
+		all_max = any_bounded ? glm::max(all_max, b.max) : b.max;
+		any_bounded = true;
+	}
+
+	for (uint32 i = 0; i < regions.size(); ++i) {
+		for (uint32 j = 0; j < i; ++j) {
+			if (bounds[j].min.x <= bounds[i].max.x && bounds[j].max.x >= bounds[i].min.x &&
+				bounds[j].min.y <= bounds[i].max.y && bounds[j].max.y >= bounds[i].min.y &&
+				bounds[j].min.z <= bounds[i].max.z && bounds[j].max.z >= bounds[i].min.z) {
+				bounds[i].shadowed_by.push_back(j);
+			}
+		}
+	}
+
+	if (!any_bounded) {
+		return;
+	}
+
+	// roughly a couple of regions per cell for evenly spread maps, capped so
+	// zone sized regions do not get copied into too many cells
+	int32 dim = static_cast<int32>(std::ceil(std::sqrt(static_cast<float>(regions.size())))) * 2;
+	dim = std::max(1, std::min(dim, 64));
+	grid_width = dim;
+	grid_height = dim;
+	grid_min = glm::vec2(all_min.x, all_min.y);
+	glm::vec2 extent = glm::max(glm::vec2(all_max.x, all_max.y) - grid_min, glm::vec2(1.0f));
+	grid_inv_cell = glm::vec2(grid_width, grid_height) / extent;
+
+	cells.resize(grid_width * grid_height);
+	for (uint32 i = 0; i < regions.size(); ++i) {
+		auto &b = bounds[i];
+		int32 x0, x1, y0, y1;
+		if (std::find(unbounded.begin(), unbounded.end(), i) != unbounded.end()) {
+			x0 = y0 = 0;
+			x1 = grid_width - 1;
+			y1 = grid_height - 1;
+		} else {
+			x0 = std::max(0, std::min(grid_width - 1, static_cast<int32>((b.min.x - grid_min.x) * grid_inv_cell.x)));
+			x1 = std::max(0, std::min(grid_width - 1, static_cast<int32>((b.max.x - grid_min.x) * grid_inv_cell.x)));
+			y0 = std::max(0, std::min(grid_height - 1, static_cast<int32>((b.min.y - grid_min.y) * grid_inv_cell.y)));
+			y1 = std::max(0, std::min(grid_height - 1, static_cast<int32>((b.max.y - grid_min.y) * grid_inv_cell.y)));
+		}
+
+		for (int32 y = y0; y <= y1; ++y) {
+			for (int32 x = x0; x <= x1; ++x) {
+				cells[y * grid_width + x].push_back(i);
+			}
+		}
+	}
+}
+
+const std::vector<uint32>& WaterMapV2::Candidates(const glm::vec3& p) const {
+	if (grid_width > 0) {
+		float fx = (p.x - grid_min.x) * grid_inv_cell.x;
+		float fy = (p.y - grid_min.y) * grid_inv_cell.y;
+		if (fx >= 0.0f && fy >= 0.0f && fx < grid_width && fy < grid_height) {
+			return cells[static_cast<int32>(fy) * grid_width + static_cast<int32>(fx)];
+		}
+	}
+
+	return unbounded;
+}
+
+int32 WaterMapV2::FindRegion(const glm::vec3& p) const {
+	for (auto region : Candidates(p)) {
+		if (RegionContains(region, p)) {
+			return static_cast<int32>(region);
+		}
+	}
+
+	return -1;
+}
+
+bool WaterMapV2::RegionContains(uint32 region, const glm::vec3& p) const {
+	auto &b = bounds[region];
+	if (p.x < b.min.x || p.x > b.max.x || p.y < b.min.y || p.y > b.max.y || p.z < b.min.z || p.z > b.max.z) {
+		return false;
+	}
+
+	return regions[region].second.ContainsPoint(p);
+}
@@ -13,6 +13,7 @@ public:
 	~WaterMapV2();
 
 	virtual WaterRegionType ReturnRegionType(const glm::vec3& location) const;
+	virtual WaterRegionType ReturnRegionType(const glm::vec3& location, RegionCache& cache) const;
 	virtual bool InWater(const glm::vec3& location) const;
 	virtual bool InVWater(const glm::vec3& location) const;
 	virtual bool InLava(const glm::vec3& location) const;
@@ -24,6 +25,31 @@ protected:
 
 	std::vector<std::pair<WaterRegionType, OrientedBoundingBox>> regions;
 	friend class WaterMap;
+
+private:
+	// regions overlap and the first one in file order wins, so everything below
+	// keeps region indexes in ascending order.
+	struct RegionBounds {
+		glm::vec3 min;
+		glm::vec3 max;
+		// earlier regions whose bounds overlap this one and so can take priority over it
+		std::vector<uint32> shadowed_by;
+	};
+
+	void BuildIndex();
+	const std::vector<uint32>& Candidates(const glm::vec3& p) const;
+	int32 FindRegion(const glm::vec3& p) const;
+	bool RegionContains(uint32 region, const glm::vec3& p) const;
+
+	std::vector<RegionBounds> bounds;
+	// uniform grid over x/y of the region bounds, each cell lists the regions touching it
+	std::vector<std::vector<uint32>> cells;
+	// regions whose bounds could not be computed, they are tested everywhere
+	std::vector<uint32> unbounded;
+	glm::vec2 grid_min;
+	glm::vec2 grid_inv_cell;
+	int32 grid_width = 0;
+	int32 grid_height = 0;
 };
 
 #endif
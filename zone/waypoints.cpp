@@ -1047,7 +1047,7 @@ void Mob::FixZ(bool force) {
 
 	NPCFlyMode = (CastToNPC()->GetFlyMode() == 1 || CastToNPC()->GetFlyMode() == 2);
 	bool underwater_mob = IsNPC() && (CastToNPC()->IsUnderwaterOnly() || zone->IsWaterZone(m_Position.z)
-		|| (zone->HasWaterMap() && (zone->watermap->InLiquid(glm::vec3(m_Position.x, m_Position.y, m_Position.z)))));
+		|| (zone->HasWaterMap() && InLiquidRegion()));
 	if (!underwater_mob && !NPCFlyMode && !IsBoat() && zone->HasMap()) {
 		glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 		float newz = zone->zonemap->FindBestZ(dest, nullptr, 20.0f, GetZOffset());
@@ -1132,7 +1132,7 @@ void Mob::FixZInWater() {
 	bool NPCFlyMode = false;
 	bool underwater_mob = IsNPC() && CastToNPC()->IsUnderwaterOnly();
 	if (!IsBoat() && zone->HasMap()) {
-		if (underwater_mob || zone->HasWaterMap() && (zone->watermap->InLiquid(glm::vec3(m_Position.x, m_Position.y, m_Position.z)) || zone->IsWaterZone(m_Position.z))) {
+		if (underwater_mob || zone->HasWaterMap() && (InLiquidRegion() || zone->IsWaterZone(m_Position.z))) {
 			// in water
 			glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 			float ceiling = zone->zonemap->FindCeiling(dest, nullptr);
@@ -1905,6 +1905,7 @@ void WorldServer::HandleMessage(uint16 opcode, const EQ::Net::Packet& p)
 			if (zone && zone->IsLoaded()) {
 				zone->SendReloadMessage("Alternate Advancement Data");
 				zone->LoadAlternateAdvancement();
+				zone->InvalidateBonusCaches();
 			}
 			break;
 		}
@@ -1924,6 +1925,7 @@ void WorldServer::HandleMessage(uint16 opcode, const EQ::Net::Packet& p)
 		case ServerOP_ReloadContentFlags: {
 			zone->SendReloadMessage("Content Flags");
 			content_service.SetExpansionContext()->ReloadContentFlags();
+			zone->InvalidateBonusCaches();
 			break;
 		}
 		case ServerOP_ReloadDoors: {
@@ -2014,6 +2016,7 @@ void WorldServer::HandleMessage(uint16 opcode, const EQ::Net::Packet& p)
 			database.LoadZoneNames();
 			database.LoadZoneFileNames();
 			RuleManager::Instance()->LoadRules(&database, RuleManager::Instance()->GetActiveRuleset());
+			zone->InvalidateBonusCaches();
 			break;
 		}
 		case ServerOP_ReloadSkillCaps: {
@@ -2094,7 +2097,7 @@ void WorldServer::HandleMessage(uint16 opcode, const EQ::Net::Packet& p)
 			}
 
 			LogInfo("Loading spells");
-			if(!database.LoadSpells(hotfix_name, &SPDAT_RECORDS, &spells)) {
+			if(!database.LoadSpells(hotfix_name, &SPDAT_RECORDS, &spells, &spell_classes)) {
 				LogError("Loading spells FAILED!");
 			}
 			break;
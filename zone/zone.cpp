@@ -927,6 +927,7 @@ Zone::Zone(uint32 in_zoneid, const char* in_short_name, uint32 in_guildid)
 	is_zone_time_localized = false;
 
 	process_mobs_while_empty = false;
+	bonus_cache_epoch = 0;
 
 	loglevelvar = 0;
 	merchantvar = 0;
@@ -2646,6 +2647,19 @@ bool Zone::IsBoatZone()
 	return false;
 }
 
+// true while an empty zone has gone idle and EntityList::MobProcess() is not
+// running Process() for this mob. One way grids keep going so they finish.
+bool Zone::MobProcessSuspended(Mob *mob)
+{
+	if (!RuleB(Zone, IdleWhenEmpty) || ZoneWillNotIdle() || IsBoatZone())
+		return false;
+
+	if (process_mobs_while_empty || !idle || numclients > 0)
+		return false;
+
+	return mob->GetWanderType() != GridOneWayRepop && mob->GetWanderType() != GridOneWayDepop;
+}
+
 bool Zone::IsBindArea(float x_coord, float y_coord, float z_coord)
 {
 	// Coords pulled from a client decompile.
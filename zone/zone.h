@@ -40,6 +40,7 @@
 #include "spawn2.h"
 #include "spawngroup.h"
 #include "pathfinder_interface.h"
+#include "los_cache.h"
 #include "position.h"
 #include "global_loot_manager.h"
 #include "queryserv.h"
@@ -253,6 +254,7 @@ public:
 	Map*	zonemap;
 	WaterMap* watermap;
 	IPathfinder *pathing;
+	LosCache los_cache;
 	NewZone_Struct	newzone_data;
 
 	SpawnConditionManager spawn_conditions;
@@ -280,6 +282,11 @@ public:
 	bool	IsWaterZone(float z);
 	bool	ZoneWillNotIdle() { return newzone_data.never_idle; };
 	bool	IsIdling() { return (idle || (numclients <= 0 && ZoneWillNotIdle())); };
+	bool	MobProcessSuspended(Mob *mob);
+	// clients rebuild their cached item and AA bonuses when this changes, bump it
+	// whenever rules, content flags or AA data are reloaded
+	uint32	GetBonusCacheEpoch() const { return bonus_cache_epoch; }
+	void	InvalidateBonusCaches() { ++bonus_cache_epoch; }
 	inline	bool BuffTimersSuspended() const { return newzone_data.SuspendBuffs != 0; };
 
 	std::vector<GridRepository::Grid> grids;
@@ -437,6 +444,7 @@ public:
 
 private:
 	uint32	zoneid;
+	uint32	bonus_cache_epoch;
 	uint32	guildid;
 	char*	short_name;
 	char	file_name[16];
@@ -0,0 +1,27 @@
+#include "zone_cli.h"
+/**
+ * @param argc
+ * @param argv
+ */
+void ZoneCLI::CommandHandler(int argc, char **argv)
+{
+	if (argc == 1) { return; }
+
+	argh::parser cmd;
+	cmd.parse(argc, argv, argh::parser::PREFER_PARAM_FOR_UNREG_OPTION);
+	EQEmuCommand::DisplayDebug(cmd);
+
+	/**
+	 * Declare command mapping
+	 */
+	auto function_map = EQEmuCommand::function_map;
+
+	/**
+	 * Register commands
+	 */
+	function_map["quests:warm-cache"] = &ZoneCLI::QuestsWarmCache;
+
+	EQEmuCommand::HandleMenu(function_map, cmd, argc, argv);
+}
+
+#include "cli/quests_warm_cache.cpp"
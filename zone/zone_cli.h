@@ -0,0 +1,15 @@
+#include "iostream"
+#include "../common/global_define.h"
+#include "../common/cli/eqemu_command_handler.h"
+
+#ifndef EQEMU_ZONE_CLI_H
+#define EQEMU_ZONE_CLI_H
+
+class ZoneCLI {
+public:
+	static void CommandHandler(int argc, char **argv);
+	static void QuestsWarmCache(int argc, char **argv, argh::parser &cmd, std::string &description);
+};
+
+
+#endif //EQEMU_ZONE_CLI_H
@@ -9,6 +9,7 @@ void ZoneEventScheduler::Process(Zone *zone, WorldContentService *content_servic
 
 	// once a minute polling
 	if (m_last_polled_minute != now->tm_min) {
+		bool state_changed = false;
 		int month = (now->tm_mon + 1);
 		int year  = (now->tm_year + 1900);
 
@@ -37,6 +38,7 @@ void ZoneEventScheduler::Process(Zone *zone, WorldContentService *content_servic
 				if (e.event_type == ServerEvents::EVENT_TYPE_RULE_CHANGE) {
 					LogScheduler("Deactivating event [{}] resetting rules to normal", e.description);
 					RuleManager::Instance()->LoadRules(m_database, RuleManager::Instance()->GetActiveRuleset());
+					state_changed = true;
 
 					// force active events clear and reapply all active events because we reset the entire state
 					// ideally if we could revert only the state of which was originally set we would only remove one active event
@@ -48,6 +50,7 @@ void ZoneEventScheduler::Process(Zone *zone, WorldContentService *content_servic
 					if (!flag_name.empty()) {
 						LogScheduler("Deactivating event [{}] resetting content flags", e.description);
 						content_service->ReloadContentFlags();
+						state_changed = true;
 					}
 
 					// force active events clear and reapply all active events because we reset the entire state
@@ -88,6 +91,7 @@ void ZoneEventScheduler::Process(Zone *zone, WorldContentService *content_servic
 							rule_value
 						);
 						RuleManager::Instance()->SetRule(rule_key.c_str(), rule_value.c_str(), nullptr, false);
+						state_changed = true;
 					}
 					m_active_events.push_back(e);
 				}
@@ -109,12 +113,18 @@ void ZoneEventScheduler::Process(Zone *zone, WorldContentService *content_servic
 						flags.push_back(f);
 
 						content_service->SetContentFlags(flags);
+						state_changed = true;
 						m_active_events.push_back(e);
 					}
 				}
 			}
 		}
 
+		// rules and content flags feed client item and AA bonuses
+		if (state_changed && zone) {
+			zone->InvalidateBonusCaches();
+		}
+
 		m_last_polled_minute = now->tm_min;
 	}
 }
@@ -2284,6 +2284,8 @@ void ZoneDatabase::LoadBuffs(Client *client) {
 			}
 		}
 	}
+
+	client->RebuildEffectIndex();
 }
 
 void ZoneDatabase::SavePetInfo(Client *client)